@@ -0,0 +1,11 @@
+"""Python Liquid benchmark suite.
+
+Run every benchmark from the root of the source tree with ``python -O -m
+benchmarks``, or ``make bench``. Use ``-k`` to select benchmarks by name, ``--save``
+to write results to a JSON file and ``--compare`` to report regressions against
+results saved from an earlier commit. See ``python -m benchmarks --help``.
+
+Benchmarks are registered with :func:`benchmarks.runner.benchmark`. A benchmark is a
+setup function that returns a callable taking no arguments. Only calls to the
+returned callable are timed.
+"""
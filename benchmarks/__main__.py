@@ -0,0 +1,100 @@
+"""Command line interface for the benchmark suite."""
+import argparse
+import sys
+
+from typing import List
+from typing import Optional
+
+from benchmarks.runner import Result
+from benchmarks.runner import benchmarks
+from benchmarks.runner import compare
+from benchmarks.runner import dump
+from benchmarks.runner import load
+from benchmarks.runner import run
+
+
+def _format_memory(peak: Optional[int]) -> str:
+    if peak is None:
+        return "-"
+    return f"{peak / 1024:.1f} KiB"
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    """Run benchmarks and return an exit status. The exit status is ``1`` if any
+    benchmark regressed compared to the baseline given with ``--compare``."""
+    parser = argparse.ArgumentParser(
+        prog="python -m benchmarks", description="Run Python Liquid benchmarks."
+    )
+    parser.add_argument(
+        "-k",
+        dest="patterns",
+        action="append",
+        default=[],
+        metavar="PATTERN",
+        help="only run benchmarks with names matching a wildcard pattern",
+    )
+    parser.add_argument(
+        "-l", "--list", action="store_true", help="list benchmarks and exit"
+    )
+    parser.add_argument(
+        "-r", "--repeat", type=int, default=5, help="rounds per benchmark"
+    )
+    parser.add_argument(
+        "--no-memory", action="store_true", help="don't measure peak memory usage"
+    )
+    parser.add_argument("--save", metavar="PATH", help="write results to a JSON file")
+    parser.add_argument(
+        "--compare", metavar="PATH", help="compare results to a saved JSON file"
+    )
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help="proportion by which a benchmark can be slower than its baseline "
+        "before it is reported as a regression (default: 0.1)",
+    )
+    args = parser.parse_args(argv)
+
+    selected = benchmarks(args.patterns)
+
+    if args.list:
+        for bench in selected:
+            print(f"{bench.name:<32} {bench.description}")
+        return 0
+
+    results: List[Result] = []
+    print(f"{'benchmark':<32} {'best':>12} {'median':>12} {'calls':>7} {'peak':>12}")
+
+    for bench in selected:
+        try:
+            result = run(bench, repeat=args.repeat, memory=not args.no_memory)
+        except Exception as err:  # pylint: disable=broad-except
+            print(f"{bench.name:<32} skipped: {err}")
+            continue
+
+        results.append(result)
+        print(
+            f"{result.name:<32} {result.best * 1000:>9.3f} ms "
+            f"{result.median * 1000:>9.3f} ms {result.number:>7} "
+            f"{_format_memory(result.peak_memory):>12}"
+        )
+
+    if args.save:
+        dump(results, args.save)
+
+    if args.compare:
+        regressions = compare(results, load(args.compare), args.threshold)
+        for regression in regressions:
+            print(
+                f"regression: {regression.name} {regression.baseline * 1000:.3f} ms "
+                f"-> {regression.current * 1000:.3f} ms ({regression.ratio:.2f}x)",
+                file=sys.stderr,
+            )
+        if regressions:
+            return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,169 @@
+"""Synthetic micro workloads that stress one part of the engine at a time."""
+import asyncio
+
+from typing import Callable
+
+from liquid import Environment
+from liquid.compiler import CompiledBoundTemplate
+from liquid.loaders import DictLoader
+
+from benchmarks.runner import benchmark
+
+try:
+    import markupsafe  # pylint: disable=unused-import
+except ImportError:  # pragma: no cover
+    markupsafe = None
+
+LOOP_SIZE = 10_000
+INCLUDE_DEPTH = 10
+
+LOOP_TEMPLATE = (
+    "{% for item in items %}"
+    "{{ forloop.index }}: {{ item.name }} ({{ item.price }})"
+    "{% if forloop.last %}.{% endif %}"
+    "{% endfor %}"
+)
+
+NESTED_LOOP_TEMPLATE = (
+    "{% for row in rows %}"
+    "{% for col in row %}{% if col > 50 %}{{ col }}{% else %}-{% endif %}{% endfor %}"
+    "{% endfor %}"
+)
+
+FILTER_TEMPLATE = (
+    "{% for item in items %}"
+    "{{ item.name | upcase | downcase | capitalize | append: '!' | prepend: '> ' }}"
+    "{{ item.price | times: 1.2 | round: 2 | plus: item.tax | minus: 1 }}"
+    "{{ item.tags | join: ', ' | truncate: 20 | escape }}"
+    "{% endfor %}"
+)
+
+ESCAPE_TEMPLATE = (
+    "{% for item in items %}"
+    "<li>{{ item.name }}{{ item.description }}{{ item.tags | join: ' & ' }}</li>"
+    "{% endfor %}"
+)
+
+
+def _items(n: int = LOOP_SIZE) -> list:
+    return [
+        {
+            "name": f"product <{i}>",
+            "price": i * 1.5,
+            "tax": i % 7,
+            "description": f"\"quoted\" & 'escaped' {i}",
+            "tags": ["a", "b", f"c{i}"],
+        }
+        for i in range(n)
+    ]
+
+
+def _include_chain(tag: str, depth: int = INCLUDE_DEPTH) -> DictLoader:
+    templates = {
+        f"level{i}": f"{i}{{% {tag} 'level{i + 1}' %}}" for i in range(depth)
+    }
+    templates[f"level{depth}"] = "{{ 'bottom' | upcase }}"
+    return DictLoader(templates)
+
+
+@benchmark("synthetic.large_loop")
+def bench_large_loop() -> Callable[[], object]:
+    """Render a for loop over 10,000 items, using forloop helper variables."""
+    template = Environment().from_string(LOOP_TEMPLATE)
+    items = _items()
+    return lambda: template.render(items=items)
+
+
+@benchmark("synthetic.large_loop_compiled")
+def bench_large_loop_compiled() -> Callable[[], object]:
+    """Render a for loop over 10,000 items with a compiled template."""
+    env = Environment()
+    env.template_class = CompiledBoundTemplate
+    template = env.from_string(LOOP_TEMPLATE)
+    items = _items()
+    return lambda: template.render(items=items)
+
+
+@benchmark("synthetic.large_loop_async")
+def bench_large_loop_async() -> Callable[[], object]:
+    """Render a for loop over 10,000 items with ``render_async``."""
+    template = Environment().from_string(LOOP_TEMPLATE)
+    items = _items()
+    return lambda: asyncio.run(template.render_async(items=items))
+
+
+@benchmark("synthetic.lazy_loop")
+def bench_lazy_loop() -> Callable[[], object]:
+    """Render a for loop over a generator of 10,000 items."""
+    template = Environment().from_string(
+        "{% for i in items limit: 9000 offset: 500 %}{{ i }}{% endfor %}"
+    )
+    return lambda: template.render(items=(i for i in range(LOOP_SIZE)))
+
+
+@benchmark("synthetic.nested_loops")
+def bench_nested_loops() -> Callable[[], object]:
+    """Render 100 nested loops of 100 items, with a condition in the inner loop."""
+    template = Environment().from_string(NESTED_LOOP_TEMPLATE)
+    rows = [list(range(100)) for _ in range(100)]
+    return lambda: template.render(rows=rows)
+
+
+@benchmark("synthetic.include_chain")
+def bench_include_chain() -> Callable[[], object]:
+    """Render a chain of 10 nested ``include`` tags."""
+    env = Environment(loader=_include_chain("include"))
+    template = env.get_template("level0")
+    return template.render
+
+
+@benchmark("synthetic.render_chain")
+def bench_render_chain() -> Callable[[], object]:
+    """Render a chain of 10 nested ``render`` tags."""
+    env = Environment(loader=_include_chain("render"))
+    template = env.get_template("level0")
+    return template.render
+
+
+@benchmark("synthetic.filters")
+def bench_filters() -> Callable[[], object]:
+    """Render 1,000 output statements with long filter chains."""
+    template = Environment().from_string(FILTER_TEMPLATE)
+    items = _items(1000)
+    return lambda: template.render(items=items)
+
+
+@benchmark("synthetic.autoescape")
+def bench_autoescape() -> Callable[[], object]:
+    """Render 10,000 items with HTML auto escaping enabled."""
+    if markupsafe is None:
+        raise RuntimeError("autoescape benchmarks require markupsafe")
+
+    template = Environment(autoescape=True).from_string(ESCAPE_TEMPLATE)
+    items = _items()
+    return lambda: template.render(items=items)
+
+
+@benchmark("synthetic.no_autoescape")
+def bench_no_autoescape() -> Callable[[], object]:
+    """Render the autoescape workload with HTML auto escaping disabled."""
+    template = Environment().from_string(ESCAPE_TEMPLATE)
+    items = _items()
+    return lambda: template.render(items=items)
+
+
+@benchmark("synthetic.cached_lookup")
+def bench_cached_lookup() -> Callable[[], object]:
+    """Get 100 cached templates from an environment's template cache."""
+    names = [f"template{i}" for i in range(100)]
+    env = Environment(
+        loader=DictLoader({name: "{{ x }}" for name in names}), auto_reload=True
+    )
+    for name in names:
+        env.get_template(name)
+
+    def _lookup() -> None:
+        for name in names:
+            env.get_template(name)
+
+    return _lookup
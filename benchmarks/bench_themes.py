@@ -0,0 +1,71 @@
+"""Lex, parse and render the Shopify-like theme fixtures in ``tests/fixtures``.
+
+These are the same workloads as ``performance.py``. Each call covers every template
+and theme pair in the fixtures.
+"""
+import asyncio
+
+from typing import Callable
+
+from liquid.lex import get_lexer
+from liquid.template import AwareBoundTemplate
+
+from performance import ThemedTemplate
+from performance import load_templates
+from performance import lex
+from performance import parse
+from performance import render
+from performance import setup_parse
+from performance import setup_render
+
+from benchmarks.runner import benchmark
+
+SEARCH_PATH = "tests/fixtures/"
+
+
+@benchmark("themes.lex")
+def bench_lex() -> Callable[[], object]:
+    """Tokenize all theme fixtures, not including expressions."""
+    templates = load_templates(SEARCH_PATH)
+    tokenizer = get_lexer()
+    return lambda: lex(templates, tokenizer)
+
+
+@benchmark("themes.parse")
+def bench_parse() -> Callable[[], object]:
+    """Lex and parse all theme fixtures."""
+    env, templates = setup_parse(SEARCH_PATH)
+    return lambda: parse(env, templates)
+
+
+@benchmark("themes.render")
+def bench_render() -> Callable[[], object]:
+    """Render all parsed theme fixtures."""
+    templates = setup_render(SEARCH_PATH)
+    return lambda: render(templates)
+
+
+@benchmark("themes.render_async")
+def bench_render_async() -> Callable[[], object]:
+    """Render all parsed theme fixtures with ``render_async``."""
+    templates = setup_render(SEARCH_PATH)
+
+    async def _render(template: ThemedTemplate) -> None:
+        content = await template.template.render_async()
+        assert isinstance(template.template, AwareBoundTemplate)
+        await template.theme.render_async(
+            template=template.template.drop, content_for_layout=content
+        )
+
+    async def _render_all() -> None:
+        for template in templates:
+            await _render(template)
+
+    return lambda: asyncio.run(_render_all())
+
+
+@benchmark("themes.parse_and_render")
+def bench_parse_and_render() -> Callable[[], object]:
+    """Lex, parse and render all theme fixtures."""
+    env, templates = setup_parse(SEARCH_PATH)
+    return lambda: render(parse(env, templates))
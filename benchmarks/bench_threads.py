@@ -0,0 +1,63 @@
+"""Render the theme fixtures from a pool of threads sharing one environment.
+
+Each call renders every template and theme pair in the fixtures the same number of
+times, split evenly between 1, 2, 4 or 8 threads, so times can be compared across
+thread counts. On builds of Python with the GIL, times stay about the same or get a
+little worse as threads are added. On free-threaded builds, times should fall as
+threads are added, up to the number of available cores.
+"""
+from concurrent.futures import ThreadPoolExecutor
+
+from typing import Callable
+from typing import List
+
+from performance import ThemedTemplate
+from performance import setup_render
+
+from benchmarks.runner import benchmark
+
+SEARCH_PATH = "tests/fixtures/"
+
+# Rendering each template this many times per call gives every thread some work.
+ROUNDS = 8
+
+
+def _render_all(templates: List[ThemedTemplate]) -> None:
+    for template in templates:
+        template.render()
+
+
+def _setup(threads: int) -> Callable[[], object]:
+    templates = setup_render(SEARCH_PATH) * ROUNDS
+    chunks = [templates[i::threads] for i in range(threads)]
+    executor = ThreadPoolExecutor(max_workers=threads)
+
+    def _run() -> None:
+        for future in [executor.submit(_render_all, chunk) for chunk in chunks]:
+            future.result()
+
+    return _run
+
+
+@benchmark("threads.render_1")
+def bench_render_1() -> Callable[[], object]:
+    """Render all parsed theme fixtures 8 times, with one thread."""
+    return _setup(1)
+
+
+@benchmark("threads.render_2")
+def bench_render_2() -> Callable[[], object]:
+    """Render all parsed theme fixtures 8 times, split between 2 threads."""
+    return _setup(2)
+
+
+@benchmark("threads.render_4")
+def bench_render_4() -> Callable[[], object]:
+    """Render all parsed theme fixtures 8 times, split between 4 threads."""
+    return _setup(4)
+
+
+@benchmark("threads.render_8")
+def bench_render_8() -> Callable[[], object]:
+    """Render all parsed theme fixtures 8 times, split between 8 threads."""
+    return _setup(8)
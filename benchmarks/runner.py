@@ -0,0 +1,194 @@
+"""Register, run and compare benchmarks."""
+
+import json
+import platform
+import statistics
+import subprocess
+import sys
+import time
+import timeit
+import tracemalloc
+
+from fnmatch import fnmatch
+
+from typing import Any
+from typing import Callable
+from typing import Dict
+from typing import Iterable
+from typing import List
+from typing import NamedTuple
+from typing import Optional
+
+import liquid
+
+Setup = Callable[[], Callable[[], object]]
+
+
+class Benchmark(NamedTuple):
+    """A named benchmark.
+
+    :param name: A dotted name, like ``"themes.render"``.
+    :param setup: A function returning the callable to time.
+    :param description: What the benchmark measures.
+    """
+
+    name: str
+    setup: Setup
+    description: str
+
+
+class Result(NamedTuple):
+    """The outcome of running one benchmark.
+
+    :param name: The benchmark's name.
+    :param number: The number of calls per round.
+    :param times: Seconds per call, for each round.
+    :param peak_memory: Peak memory allocated during a single call, in bytes, as
+        reported by ``tracemalloc``. ``None`` if memory was not measured.
+    """
+
+    name: str
+    number: int
+    times: List[float]
+    peak_memory: Optional[int]
+
+    @property
+    def best(self) -> float:
+        """The fastest round, in seconds per call."""
+        return min(self.times)
+
+    @property
+    def median(self) -> float:
+        """The median round, in seconds per call."""
+        return statistics.median(self.times)
+
+
+class Regression(NamedTuple):
+    """A benchmark that is slower than its baseline."""
+
+    name: str
+    baseline: float
+    current: float
+
+    @property
+    def ratio(self) -> float:
+        """Current time as a proportion of baseline time."""
+        return self.current / self.baseline
+
+
+_registry: Dict[str, Benchmark] = {}
+
+
+def benchmark(name: str) -> Callable[[Setup], Setup]:
+    """Register the decorated setup function as a benchmark called ``name``. The
+    setup function's docstring is used as the benchmark's description."""
+
+    def decorator(setup: Setup) -> Setup:
+        if name in _registry:
+            raise ValueError(f"duplicate benchmark name '{name}'")
+        _registry[name] = Benchmark(name, setup, (setup.__doc__ or "").strip())
+        return setup
+
+    return decorator
+
+
+def benchmarks(patterns: Iterable[str] = ()) -> List[Benchmark]:
+    """Return registered benchmarks, sorted by name, optionally filtered by shell
+    style wildcard patterns."""
+    # Importing suite modules registers their benchmarks.
+    # pylint: disable=import-outside-toplevel unused-import
+    import benchmarks.bench_themes
+    import benchmarks.bench_synthetic
+    import benchmarks.bench_threads
+
+    _patterns = list(patterns)
+    return [
+        bench
+        for name, bench in sorted(_registry.items())
+        if not _patterns or any(fnmatch(name, pattern) for pattern in _patterns)
+    ]
+
+
+def run(bench: Benchmark, repeat: int = 5, memory: bool = True) -> Result:
+    """Run a benchmark, choosing the number of calls per round so that each round
+    takes at least 0.2 seconds."""
+    func = bench.setup()
+    timer = timeit.Timer(func)
+    number, _ = timer.autorange()
+    times = [elapsed / number for elapsed in timer.repeat(repeat, number)]
+
+    peak_memory = None
+    if memory:
+        tracemalloc.start()
+        try:
+            func()
+            _, peak_memory = tracemalloc.get_traced_memory()
+        finally:
+            tracemalloc.stop()
+
+    return Result(bench.name, number, times, peak_memory)
+
+
+def compare(
+    results: Iterable[Result],
+    baseline: Dict[str, Any],
+    threshold: float = 0.1,
+) -> List[Regression]:
+    """Return results whose best time is more than ``threshold`` slower than the
+    best time of the same benchmark in ``baseline``, as loaded by :func:`load`."""
+    baseline_results = {res["name"]: res for res in baseline["results"]}
+    regressions = []
+
+    for result in results:
+        base = baseline_results.get(result.name)
+        if base is None:
+            continue
+
+        base_best = min(base["times"])
+        if result.best > base_best * (1 + threshold):
+            regressions.append(Regression(result.name, base_best, result.best))
+
+    return regressions
+
+
+def metadata() -> Dict[str, Any]:
+    """Describe the environment benchmarks are running in."""
+    try:
+        commit: Optional[str] = subprocess.run(
+            ["git", "rev-parse", "HEAD"],
+            capture_output=True,
+            check=True,
+            text=True,
+        ).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        commit = None
+
+    return {
+        "liquid_version": liquid.__version__,
+        "commit": commit,
+        "python": sys.version,
+        "implementation": platform.python_implementation(),
+        "machine": platform.machine(),
+        "optimize": sys.flags.optimize,
+        # False on free-threaded builds of Python, with the GIL disabled.
+        "gil": getattr(sys, "_is_gil_enabled", lambda: True)(),
+        "timestamp": time.time(),
+    }
+
+
+def dump(results: Iterable[Result], path: str) -> None:
+    """Write results and environment metadata to a JSON file at ``path``."""
+    data = {
+        "metadata": metadata(),
+        "results": [result._asdict() for result in results],
+    }
+
+    with open(path, "w") as fd:
+        json.dump(data, fd, indent=2)
+
+
+def load(path: str) -> Dict[str, Any]:
+    """Load results written by :func:`dump`."""
+    with open(path, "r") as fd:
+        data: Dict[str, Any] = json.load(fd)
+    return data
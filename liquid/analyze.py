@@ -0,0 +1,460 @@
+"""Static analysis of parse trees.
+
+Analysis reports the variables, filters and partial templates a template references,
+without rendering it. See :meth:`liquid.template.BoundTemplate.analyze`.
+"""
+from __future__ import annotations
+
+from typing import Any
+from typing import Dict
+from typing import Iterable
+from typing import List
+from typing import Optional
+from typing import Set
+from typing import Tuple
+from typing import Union
+from typing import TYPE_CHECKING
+
+from liquid.ast import BlockNode
+from liquid.ast import ConditionalBlockNode
+from liquid.ast import Node
+
+from liquid.builtin.statement import LayoutContentNode
+
+from liquid.builtin.tags.assign_tag import AssignNode
+from liquid.builtin.tags.capture_tag import CaptureNode
+from liquid.builtin.tags.case_tag import CaseNode
+from liquid.builtin.tags.cycle_tag import CycleNode
+from liquid.builtin.tags.decrement_tag import DecrementNode
+from liquid.builtin.tags.for_tag import ForNode
+from liquid.builtin.tags.if_tag import IfNode
+from liquid.builtin.tags.ifchanged_tag import IfChangedNode
+from liquid.builtin.tags.include_tag import IncludeNode
+from liquid.builtin.tags.increment_tag import IncrementNode
+from liquid.builtin.tags.liquid_tag import LiquidNode
+from liquid.builtin.tags.render_tag import RenderNode
+from liquid.builtin.tags.tablerow_tag import TablerowNode
+from liquid.builtin.tags.unless_tag import UnlessNode
+
+from liquid.exceptions import Error
+from liquid.exceptions import NoSuchFilterFunc
+
+from liquid.expression import Expression
+from liquid.expression import Filter
+from liquid.expression import FilteredExpression
+from liquid.expression import Identifier
+from liquid.expression import IdentifierPathElement
+from liquid.expression import StringLiteral
+
+if TYPE_CHECKING:  # pragma: no cover
+    from liquid import Environment
+    from liquid.ast import ParseTree
+    from liquid.template import BoundTemplate
+
+# A template name and line number.
+Location = Tuple[str, int]
+
+# A mapping of names to the locations they were referenced.
+Refs = Dict[str, List[Location]]
+
+
+class TemplateAnalysis:
+    """The result of analyzing a template's parse tree with
+    :meth:`liquid.template.BoundTemplate.analyze`.
+
+    Each attribute maps names to a list of ``(template_name, line_number)`` tuples,
+    one for each place the name is referenced.
+
+    :ivar variables: Every variable path referenced by the template, like
+        ``product.title``, including those that are assigned locally.
+    :ivar local_variables: Names of variables bound by the ``assign`` and ``capture``
+        tags, keyed by where they are assigned.
+    :ivar global_variables: Top-level names of variables that must be resolved from
+        render context data or environment or template globals. A variable is
+        considered global if it might be read before it has been assigned. Variables
+        assigned in partial templates are still reported as global.
+    :ivar unknown_variables: Paths of variables where, at parse time, we can't tell
+        which top-level name will be read.
+    :ivar filters: Names of filters used by the template.
+    :ivar templates: Names of templates included or rendered by the template.
+    :ivar unknown_templates: ``include`` and ``render`` tags with a template name that
+        can't be known until render time, keyed by the template name expression. If
+        this is not empty, the other attributes might be incomplete.
+    """
+
+    __slots__ = (
+        "variables",
+        "local_variables",
+        "global_variables",
+        "unknown_variables",
+        "filters",
+        "templates",
+        "unknown_templates",
+    )
+
+    def __init__(self) -> None:
+        self.variables: Refs = {}
+        self.local_variables: Refs = {}
+        self.global_variables: Refs = {}
+        self.unknown_variables: Refs = {}
+        self.filters: Refs = {}
+        self.templates: Refs = {}
+        self.unknown_templates: Refs = {}
+
+    def __repr__(self) -> str:  # pragma: no cover
+        return (
+            f"TemplateAnalysis(variables={self.variables}, "
+            f"global_variables={self.global_variables}, filters={self.filters}, "
+            f"templates={self.templates})"
+        )
+
+
+def _add(refs: Refs, name: str, location: Location) -> None:
+    refs.setdefault(name, []).append(location)
+
+
+def _merge(refs: Refs, other: Refs, exclude: Iterable[str] = ()) -> None:
+    for name, locations in other.items():
+        if name not in exclude:
+            refs.setdefault(name, []).extend(locations)
+
+
+# Nodes for tags that keep state between renders with the same context. Layout
+# content renders a template that is not known until render time.
+STATEFUL_NODES = (
+    CycleNode,
+    IncrementNode,
+    DecrementNode,
+    IfChangedNode,
+    LayoutContentNode,
+)
+
+
+def is_pure(tree: ParseTree, env: Environment) -> bool:
+    """Return ``True`` if the given parse tree does not use stateful tags, like
+    ``cycle`` and ``increment``, or filters that are not marked as pure.
+
+    Rendering a pure template twice with the same render context data writes the same
+    output both times. Partial templates are not followed.
+    """
+    return all(_is_pure(stmt, env) for stmt in tree.statements)
+
+
+def _is_pure(obj: object, env: Environment) -> bool:
+    if isinstance(obj, STATEFUL_NODES):
+        return False
+
+    if isinstance(obj, Filter):
+        try:
+            bound = env.get_filter(obj.name)
+        except NoSuchFilterFunc:
+            return False
+        if not getattr(bound.filter, "pure", False) or bound.with_context:
+            return False
+
+    for val in _slots(obj):
+        if isinstance(val, (Node, Expression, Filter)):
+            if not _is_pure(val, env):
+                return False
+        elif isinstance(val, (list, tuple)):
+            if not all(_is_pure(item, env) for item in val):
+                return False
+        elif isinstance(val, dict):
+            if not all(_is_pure(item, env) for item in val.values()):
+                return False
+    return True
+
+
+def chained_lookups(node: Node) -> List[Tuple[str, Tuple[Union[str, int], ...]]]:
+    """Return the distinct chained variables found in the given node and its
+    children, whose path is known at parse time, in the order they first appear.
+
+    Each chained variable is a name and a tuple of keys. ``product.title`` is
+    ``("product", ("title",))``. Variables without a key, and variables with a
+    variable key, like ``product[key]``, are not included.
+    """
+    found: Dict[Tuple[str, Tuple[Union[str, int], ...]], None] = {}
+    _chained_lookups(node, found)
+    return list(found)
+
+
+def _chained_lookups(
+    obj: object, found: Dict[Tuple[str, Tuple[Union[str, int], ...]], None]
+) -> None:
+    if isinstance(obj, Identifier) and obj.resolver is not None and len(obj.path) > 1:
+        name = obj.path[0].value
+        assert isinstance(name, str)
+        found[(name, tuple(elem.value for elem in obj.path[1:]))] = None  # type: ignore
+        return
+
+    for val in _slots(obj):
+        if isinstance(val, (Node, Expression, Filter)):
+            _chained_lookups(val, found)
+        elif isinstance(val, (list, tuple)):
+            for item in val:
+                _chained_lookups(item, found)
+        elif isinstance(val, dict):
+            for item in val.values():
+                _chained_lookups(item, found)
+
+
+def _slots(obj: object) -> Iterable[Any]:
+    """Yield attribute values for all slots of the given object."""
+    for cls in type(obj).__mro__:
+        for slot in getattr(cls, "__slots__", ()):
+            if slot != "tok" and hasattr(obj, slot):
+                yield getattr(obj, slot)
+
+
+class Analyzer:
+    """Parse tree walker that populates a :class:`TemplateAnalysis`.
+
+    Nodes and expressions that we don't know about, like those from custom tags, are
+    searched for expressions and blocks in their ``__slots__``.
+
+    :param template: The template to analyze.
+    :param follow_partials: If ``True``, load and analyze templates referenced by
+        ``include`` and ``render`` tags.
+    :param raise_for_failures: If ``True``, errors loading or analyzing partial
+        templates are raised. Otherwise they are reported in ``templates`` only.
+    :param _partials: Analysis of partial templates shared with nested analyzers.
+    """
+
+    def __init__(
+        self,
+        template: BoundTemplate,
+        follow_partials: bool = True,
+        raise_for_failures: bool = True,
+        _partials: Optional[Dict[str, Optional[TemplateAnalysis]]] = None,
+    ):
+        self.template = template
+        self.name = template.name
+        self.follow_partials = follow_partials
+        self.raise_for_failures = raise_for_failures
+        self.analysis = TemplateAnalysis()
+
+        # Names that are bound at the current point in the tree, either by assignment
+        # or as a loop variable. Branches get a copy, so only assignments that are
+        # sure to have happened are in scope when a block ends.
+        self.bound: Set[str] = set()
+
+        # Partial templates, by name. `None` indicates the partial is being analyzed
+        # or could not be loaded.
+        self.partials = _partials if _partials is not None else {}
+
+        self.linenum = 0
+
+    def analyze(self) -> TemplateAnalysis:
+        """Analyze the template and return the results."""
+        self.partials[self.name] = None
+        self.visit_statements(self.template.tree.statements)
+        self.partials[self.name] = self.analysis
+        return self.analysis
+
+    def location(self) -> Location:
+        """Return the location of the node currently being visited."""
+        return (self.name, self.linenum)
+
+    def visit_statements(self, statements: Iterable[Node]) -> None:
+        for stmt in statements:
+            self.visit_node(stmt)
+
+    def visit_branch(self, block: Optional[Node], names: Iterable[str] = ()) -> None:
+        """Visit a block that might not be rendered, or might be rendered many times,
+        with some additional names in scope."""
+        if block is None:
+            return
+
+        outer = self.bound
+        self.bound = outer.union(names)
+        try:
+            self.visit_node(block)
+        finally:
+            self.bound = outer
+
+    # pylint: disable=too-many-branches too-many-statements
+    def visit_node(self, node: Node) -> None:
+        """Visit a parse tree node and any of its children."""
+        tok = node.token()
+        if tok.linenum >= 0:
+            self.linenum = tok.linenum
+
+        cls = node.__class__
+
+        if cls is BlockNode:
+            self.visit_statements(node.statements)  # type: ignore
+        elif cls is AssignNode:
+            assert isinstance(node, AssignNode)
+            self.visit_expression(node.expression.expression)
+            self.bind(node.expression.name)
+        elif cls is CaptureNode:
+            assert isinstance(node, CaptureNode)
+            self.visit_node(node.block)
+            self.bind(node.name)
+        elif cls is LiquidNode:
+            assert isinstance(node, LiquidNode)
+            self.visit_node(node.block)
+        elif cls is IfNode:
+            assert isinstance(node, IfNode)
+            self.visit_expression(node.condition)
+            self.visit_branch(node.consequence)
+            for alt in node.conditional_alternatives:
+                self.visit_expression(alt.condition)
+                self.visit_branch(alt.block)
+            self.visit_branch(node.alternative)
+        elif cls is UnlessNode:
+            assert isinstance(node, UnlessNode)
+            self.visit_expression(node.condition)
+            self.visit_branch(node.consequence)
+        elif cls is CaseNode:
+            assert isinstance(node, CaseNode)
+            for when in node.whens:
+                self.visit_expression(when.condition)
+                self.visit_branch(when.block)
+            self.visit_branch(node.default)
+        elif cls is ConditionalBlockNode:
+            assert isinstance(node, ConditionalBlockNode)
+            self.visit_expression(node.condition)
+            self.visit_branch(node.block)
+        elif cls is ForNode:
+            assert isinstance(node, ForNode)
+            self.visit_expression(node.expression)
+            self.visit_branch(node.block, (node.expression.name, "forloop"))
+            self.visit_branch(node.default)
+        elif cls is TablerowNode:
+            assert isinstance(node, TablerowNode)
+            self.visit_expression(node.expression)
+            self.visit_branch(node.block, (node.expression.name, "tablerowloop"))
+        elif cls in (IncludeNode, RenderNode):
+            self.visit_partial(node)  # type: ignore
+        elif cls in (IncrementNode, DecrementNode):
+            # Counters live in their own namespace.
+            pass
+        else:
+            self.visit_unknown(node)
+
+    def visit_unknown(self, obj: object) -> None:
+        """Search an unknown node or expression for expressions and blocks."""
+        for val in _slots(obj):
+            self.visit_value(val)
+
+    def visit_value(self, val: object) -> None:
+        if isinstance(val, Expression):
+            self.visit_expression(val)
+        elif isinstance(val, Filter):
+            self.visit_filter(val)
+        elif isinstance(val, Node):
+            # We don't know when or how often a custom tag renders its blocks.
+            self.visit_branch(val)
+        elif isinstance(val, (list, tuple)):
+            for item in val:
+                self.visit_value(item)
+        elif isinstance(val, dict):
+            for item in val.values():
+                self.visit_value(item)
+
+    def visit_expression(self, expr: Expression) -> None:
+        """Visit an expression and any of its child expressions."""
+        if isinstance(expr, Identifier):
+            self.visit_identifier(expr)
+        elif isinstance(expr, FilteredExpression):
+            self.visit_expression(expr.expression)
+            for fltr in expr.filters:
+                self.visit_filter(fltr)
+        else:
+            self.visit_unknown(expr)
+
+    def visit_identifier(self, expr: Identifier) -> None:
+        location = self.location()
+        _add(self.analysis.variables, str(expr), location)
+
+        root = expr.path[0] if expr.path else None
+        if isinstance(root, IdentifierPathElement):
+            if root.value not in self.bound:
+                _add(self.analysis.global_variables, str(root.value), location)
+        else:
+            _add(self.analysis.unknown_variables, str(expr), location)
+
+        # Variables used as keys, like `products[handle]`.
+        for elem in expr.path:
+            if isinstance(elem, Identifier):
+                self.visit_identifier(elem)
+
+    def visit_filter(self, fltr: Filter) -> None:
+        _add(self.analysis.filters, fltr.name, self.location())
+        for arg in fltr.args:
+            self.visit_expression(arg)
+        for arg in fltr.kwargs.values():
+            self.visit_expression(arg)
+
+    def visit_partial(self, node: Node) -> None:
+        """Visit an ``include`` or ``render`` node, and maybe the partial template it
+        references."""
+        assert isinstance(node, (IncludeNode, RenderNode))
+        location = self.location()
+
+        self.visit_expression(node.name)
+        if node.var is not None:
+            self.visit_expression(node.var)
+        for arg in node.args.values():
+            self.visit_expression(arg)
+
+        if node.name.__class__ is not StringLiteral:
+            _add(self.analysis.unknown_templates, str(node.name), location)
+            return
+
+        name = node.name.value  # type: ignore
+        _add(self.analysis.templates, name, location)
+
+        if not self.follow_partials:
+            return
+
+        partial = self.analyze_partial(name)
+        if partial is None:
+            return
+
+        # Names bound by the tag itself are not global.
+        names = set(node.args)
+        if node.var is not None:
+            names.add(node.alias or name.split(".")[0])
+            if isinstance(node, RenderNode) and node.loop:
+                names.add("forloop")
+
+        if isinstance(node, IncludeNode):
+            # Included templates share our scope.
+            names.update(self.bound)
+
+        analysis = self.analysis
+        _merge(analysis.variables, partial.variables)
+        _merge(analysis.local_variables, partial.local_variables)
+        _merge(analysis.global_variables, partial.global_variables, exclude=names)
+        _merge(analysis.unknown_variables, partial.unknown_variables)
+        _merge(analysis.filters, partial.filters)
+        _merge(analysis.templates, partial.templates)
+        _merge(analysis.unknown_templates, partial.unknown_templates)
+
+    def analyze_partial(self, name: str) -> Optional[TemplateAnalysis]:
+        """Return the analysis of the named partial template, or ``None`` if it is
+        being analyzed already or could not be loaded."""
+        if name in self.partials:
+            return self.partials[name]
+
+        try:
+            template = self.template.env.get_template(name)
+        except Error:
+            if self.raise_for_failures:
+                raise
+            self.partials[name] = None
+            return None
+
+        return Analyzer(
+            template,
+            follow_partials=True,
+            raise_for_failures=self.raise_for_failures,
+            _partials=self.partials,
+        ).analyze()
+
+    def bind(self, name: str) -> None:
+        """Bind a local variable at the current location."""
+        _add(self.analysis.local_variables, name, self.location())
+        self.bound.add(name)
@@ -0,0 +1,263 @@
+"""Render one template with many sets of render context data, using a pool of worker
+processes.
+
+Rendering is CPU bound, so threads don't help. :func:`render_many` sends a template's
+environment and parse tree to each worker process once, when the worker starts, then
+sends render context data to workers in chunks. With the ``fork`` start method,
+workers inherit the template from the parent process instead.
+
+Render context data, rendered output and any exceptions raised while rendering must be
+picklable.
+"""
+from __future__ import annotations
+
+import itertools
+import os
+import warnings
+
+from collections import deque
+from concurrent.futures import FIRST_COMPLETED
+from concurrent.futures import Executor
+from concurrent.futures import Future
+from concurrent.futures import ProcessPoolExecutor
+from concurrent.futures import wait
+
+from typing import Any
+from typing import Deque
+from typing import Dict
+from typing import Iterable
+from typing import Iterator
+from typing import List
+from typing import Mapping
+from typing import NamedTuple
+from typing import Optional
+from typing import Tuple
+from typing import Type
+from typing import Union
+from typing import TYPE_CHECKING
+
+if TYPE_CHECKING:  # pragma: no cover
+    from multiprocessing.context import BaseContext
+    from liquid import Environment
+    from liquid.ast import ParseTree
+    from liquid.template import BoundTemplate
+
+# The number of chunks of render context data waiting or being rendered, per worker.
+CHUNKS_PER_WORKER = 2
+
+
+class RenderResult(NamedTuple):
+    """The outcome of rendering one set of render context data in a worker process.
+
+    :param output: The rendered template, or ``None`` if rendering failed.
+    :param error: The exception raised while rendering, if any.
+    :param warnings: Messages and categories of warnings issued while rendering.
+    """
+
+    output: Optional[str]
+    error: Optional[BaseException]
+    warnings: List[Tuple[str, Type[Warning]]]
+
+
+class _TemplateState(NamedTuple):
+    """Everything needed to rebuild a template in a worker process."""
+
+    env: Environment
+    tree: ParseTree
+    name: str
+    path: Any
+    globals: Dict[str, Any]
+    template_class: Type[BoundTemplate]
+
+
+# The template rendered by this worker process.
+_worker_template: Optional[BoundTemplate] = None
+
+
+def _init_worker(state: _TemplateState) -> None:
+    # pylint: disable=global-statement
+    global _worker_template
+    _worker_template = state.template_class(
+        state.env,
+        state.tree,
+        name=state.name,
+        path=state.path,
+        globals=state.globals,
+    )
+
+
+def _render_one(template: BoundTemplate, data: Mapping[str, object]) -> RenderResult:
+    with warnings.catch_warnings(record=True) as caught:
+        warnings.simplefilter("always")
+        try:
+            output = template.render(data)
+        except Exception as err:  # pylint: disable=broad-except
+            return RenderResult(None, err, _warnings(caught))
+    return RenderResult(output, None, _warnings(caught))
+
+
+def _warnings(
+    caught: List[warnings.WarningMessage],
+) -> List[Tuple[str, Type[Warning]]]:
+    return [(str(warning.message), warning.category) for warning in caught]
+
+
+def _render_chunk(chunk: List[Mapping[str, object]]) -> List[RenderResult]:
+    assert _worker_template is not None
+    return [_render_one(_worker_template, data) for data in chunk]
+
+
+def _report(
+    result: RenderResult, return_exceptions: bool
+) -> Union[str, BaseException]:
+    """Issue warnings from a worker process in this process, and raise or return any
+    exception."""
+    for message, category in result.warnings:
+        warnings.warn(message, category=category)
+
+    if result.error is not None:
+        if return_exceptions:
+            return result.error
+        raise result.error
+
+    assert result.output is not None
+    return result.output
+
+
+def _chunks(
+    items: Iterable[Mapping[str, object]], chunksize: int
+) -> Iterator[Tuple[int, List[Mapping[str, object]]]]:
+    """Yield the index of the first item in each chunk, and the chunk."""
+    it = iter(items)
+    start = 0
+    while True:
+        chunk = list(itertools.islice(it, chunksize))
+        if not chunk:
+            return
+        yield start, chunk
+        start += len(chunk)
+
+
+def render_many(
+    template: BoundTemplate,
+    items: Iterable[Mapping[str, object]],
+    workers: Optional[int] = None,
+    *,
+    ordered: bool = True,
+    chunksize: int = 64,
+    return_exceptions: bool = False,
+    mp_context: Optional[BaseContext] = None,
+) -> Iterator[Any]:
+    """Render the given template once for each mapping of render context data in
+    ``items``, spread over a pool of worker processes.
+
+    ``items`` is consumed lazily, so it can be a generator of any length. Results
+    are yielded as soon as they are available.
+
+    Errors are handled in worker processes according to the template's environment
+    :class:`liquid.Mode`. Warnings issued by workers are issued again in this process.
+    Exceptions are raised from the iterator when the failed item's result is due,
+    stopping the batch, unless ``return_exceptions`` is ``True``.
+
+    :param template: The template to render.
+    :param items: Render context data for each render, like the keyword arguments
+        to :meth:`liquid.template.BoundTemplate.render`.
+    :param workers: The number of worker processes. Defaults to ``None``, meaning the
+        number of CPUs. If ``workers`` is ``1``, items are rendered in this process.
+    :param ordered: If ``True``, yield rendered templates in the same order as
+        ``items``. Otherwise yield ``(index, output)`` tuples in the order they
+        finish. Defaults to ``True``.
+    :param chunksize: The number of items sent to a worker at a time. Defaults to
+        ``64``.
+    :param return_exceptions: If ``True``, yield exceptions in place of output for
+        items that could not be rendered. Defaults to ``False``.
+    :param mp_context: An optional :mod:`multiprocessing` context for starting worker
+        processes.
+    :returns: An iterator of rendered templates, or ``(index, output)`` tuples if
+        ``ordered`` is ``False``.
+    """
+    if chunksize < 1:
+        raise ValueError("chunksize must be greater than 0")
+
+    workers = workers or os.cpu_count() or 1
+
+    if workers == 1:
+        for index, data in enumerate(items):
+            output = _report(_render_one(template, data), return_exceptions)
+            yield output if ordered else (index, output)
+        return
+
+    state = _TemplateState(
+        env=template.env,
+        tree=template.tree,
+        name=template.name,
+        path=template.path,
+        globals=template.globals,
+        template_class=template.__class__,
+    )
+
+    with ProcessPoolExecutor(
+        max_workers=workers,
+        mp_context=mp_context,
+        initializer=_init_worker,
+        initargs=(state,),
+    ) as executor:
+        chunks = _chunks(items, chunksize)
+        limit = workers * CHUNKS_PER_WORKER
+        if ordered:
+            yield from _ordered(executor, chunks, limit, return_exceptions)
+        else:
+            yield from _unordered(executor, chunks, limit, return_exceptions)
+
+
+def _ordered(
+    executor: Executor,
+    chunks: Iterator[Tuple[int, List[Mapping[str, object]]]],
+    limit: int,
+    return_exceptions: bool,
+) -> Iterator[Any]:
+    pending: Deque[Future[List[RenderResult]]] = deque()
+
+    for _, chunk in itertools.islice(chunks, limit):
+        pending.append(executor.submit(_render_chunk, chunk))
+
+    try:
+        while pending:
+            results = pending.popleft().result()
+            for _, chunk in itertools.islice(chunks, 1):
+                pending.append(executor.submit(_render_chunk, chunk))
+            for result in results:
+                yield _report(result, return_exceptions)
+    finally:
+        # Don't render chunks that haven't started if we're stopping early.
+        for future in pending:
+            future.cancel()
+
+
+def _unordered(
+    executor: Executor,
+    chunks: Iterator[Tuple[int, List[Mapping[str, object]]]],
+    limit: int,
+    return_exceptions: bool,
+) -> Iterator[Any]:
+    starts: Dict[Future[List[RenderResult]], int] = {}
+
+    def submit(start: int, chunk: List[Mapping[str, object]]) -> None:
+        starts[executor.submit(_render_chunk, chunk)] = start
+
+    for start, chunk in itertools.islice(chunks, limit):
+        submit(start, chunk)
+
+    try:
+        while starts:
+            done, _ = wait(starts, return_when=FIRST_COMPLETED)
+            for future in done:
+                start = starts.pop(future)
+                results = future.result()
+                for next_start, chunk in itertools.islice(chunks, 1):
+                    submit(next_start, chunk)
+                for offset, result in enumerate(results):
+                    yield start + offset, _report(result, return_exceptions)
+    finally:
+        for future in starts:
+            future.cancel()
@@ -22,6 +22,7 @@ from .tags import liquid_tag
 from .tags import include_tag
 from .tags import render_tag
 from .tags import ifchanged_tag
+from .tags import cache_tag
 
 from .filters._math import abs_
 from .filters._math import at_most
@@ -108,6 +109,7 @@ def register(env: Environment) -> None:
     env.add_tag(include_tag.IncludeTag)
     env.add_tag(render_tag.RenderTag)
     env.add_tag(ifchanged_tag.IfChangedTag)
+    env.add_tag(cache_tag.CacheTag)
 
     env.add_filter("abs", abs_)
     env.add_filter("at_most", at_most)
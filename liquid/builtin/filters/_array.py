@@ -19,6 +19,8 @@ except ImportError:
     from liquid.exceptions import Markup  # type: ignore
 
 from liquid.filter import with_environment
+from liquid.filter import pure
+from liquid.filter import memoize
 from liquid.filter import array_filter
 
 from liquid.exceptions import FilterArgumentError
@@ -26,6 +28,8 @@ from liquid.exceptions import FilterValueError
 
 from liquid import is_undefined
 
+from liquid.utils.html import escape_join
+
 if TYPE_CHECKING:
     from liquid import Environment
 
@@ -65,6 +69,7 @@ def _lower(obj: Any) -> str:
         return ""
 
 
+@pure
 @with_environment
 @array_filter
 def join(
@@ -74,12 +79,16 @@ def join(
     if not isinstance(separator, str):
         separator = str(separator)
 
-    if environment.autoescape and separator == " ":
-        separator = Markup(" ")
+    if environment.autoescape:
+        if separator == " ":
+            separator = Markup(" ")
+        if hasattr(separator, "__html__"):
+            return escape_join(iterable, separator)
 
     return separator.join(_str_if_not(item) for item in iterable)
 
 
+@pure
 @array_filter
 def first(array: Sequence[Any]) -> object:
     """Return the first item of an array"""
@@ -88,6 +97,7 @@ def first(array: Sequence[Any]) -> object:
     return None
 
 
+@pure
 @array_filter
 def last(array: Sequence[Any]) -> object:
     """Return the last item of an array"""
@@ -96,6 +106,7 @@ def last(array: Sequence[Any]) -> object:
     return None
 
 
+@pure
 @array_filter
 def concat(array: ArrayT, second_array: ArrayT) -> ArrayT:
     """Return two arrays joined together."""
@@ -109,6 +120,7 @@ def concat(array: ArrayT, second_array: ArrayT) -> ArrayT:
     return array + second_array
 
 
+@memoize
 @array_filter
 def map_(sequence: ArrayT, key: object) -> List[object]:
     """Creates an array of values by extracting the values of a named property
@@ -119,12 +131,14 @@ def map_(sequence: ArrayT, key: object) -> List[object]:
         raise FilterValueError("can't map sequence") from err
 
 
+@pure
 @array_filter
 def reverse(array: ArrayT) -> List[object]:
     """Reverses the order of the items in an array."""
     return list(reversed(array))
 
 
+@memoize
 @array_filter
 def sort(sequence: ArrayT, key: object = None) -> List[object]:
     """Sorts items in an array in case-sensitive order.
@@ -142,6 +156,7 @@ def sort(sequence: ArrayT, key: object = None) -> List[object]:
         raise FilterValueError("can't sort sequence") from err
 
 
+@memoize
 @array_filter
 def sort_natural(sequence: ArrayT, key: object = None) -> List[object]:
     """Sorts items in an array in case-insensitive order."""
@@ -152,6 +167,7 @@ def sort_natural(sequence: ArrayT, key: object = None) -> List[object]:
     return list(sorted(sequence, key=_lower))
 
 
+@memoize
 @array_filter
 def where(sequence: ArrayT, attr: object, value: object = None) -> List[object]:
     """Creates an array including only the objects with a given property value,
@@ -162,6 +178,7 @@ def where(sequence: ArrayT, attr: object, value: object = None) -> List[object]:
     return [itm for itm in sequence if _getitem(itm, attr) not in (False, None)]
 
 
+@pure
 @array_filter
 def uniq(iterable: ArrayT) -> List[object]:
     """Removes any duplicate elements in an array. Input array order is not
@@ -170,6 +187,7 @@ def uniq(iterable: ArrayT) -> List[object]:
     return list(unique.keys())
 
 
+@pure
 @array_filter
 def compact(iterable: ArrayT) -> List[object]:
     """Removes any nil values from an array."""
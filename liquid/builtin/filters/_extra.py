@@ -8,12 +8,14 @@ except ImportError:
     from liquid.exceptions import Markup  # type: ignore
 
 from liquid.filter import string_filter
+from liquid.filter import pure
 from liquid.filter import with_environment
 
 if TYPE_CHECKING:
     from liquid import Environment
 
 
+@pure
 @with_environment
 @string_filter
 def safe(val: str, *, environment: Environment) -> str:
@@ -9,6 +9,7 @@ from typing import Union
 from liquid.exceptions import FilterArgumentError
 
 from liquid.filter import math_filter
+from liquid.filter import pure
 from liquid.filter import num_arg
 from liquid.filter import int_arg
 
@@ -16,6 +17,7 @@ D = decimal.Decimal
 N = Union[float, int]
 
 
+@pure
 @math_filter
 def abs_(num: N) -> N:
     """Return that absolute value of a number.
@@ -25,6 +27,7 @@ def abs_(num: N) -> N:
     return abs(num)
 
 
+@pure
 @math_filter
 def at_most(num: N, other: N) -> N:
     """Return `val` or `args[0]`, whichever is smaller.
@@ -35,6 +38,7 @@ def at_most(num: N, other: N) -> N:
     return min(num, other)
 
 
+@pure
 @math_filter
 def at_least(num: N, other: N) -> N:
     """Return `val` or `args[0]`, whichever is greater.
@@ -45,6 +49,7 @@ def at_least(num: N, other: N) -> N:
     return max(num, other)
 
 
+@pure
 @math_filter
 def ceil(num: N) -> N:
     """Return the ceiling of x as an Integral.
@@ -54,6 +59,7 @@ def ceil(num: N) -> N:
     return math.ceil(num)
 
 
+@pure
 @math_filter
 def divided_by(num: N, other: object) -> N:
     """Divide `num` by `other`."""
@@ -67,6 +73,7 @@ def divided_by(num: N, other: object) -> N:
         raise FilterArgumentError(f"divided_by: can't divide by {other}") from err
 
 
+@pure
 @math_filter
 def floor(num: N) -> N:
     """Return the floor of x as an Integral.
@@ -76,6 +83,7 @@ def floor(num: N) -> N:
     return math.floor(num)
 
 
+@pure
 @math_filter
 def minus(num: N, other: N) -> N:
     """Subtract one number from another."""
@@ -86,6 +94,7 @@ def minus(num: N, other: N) -> N:
     return float(D(str(num)) - D(str(other)))
 
 
+@pure
 @math_filter
 def plus(num: N, other: N) -> N:
     """Add one number to another."""
@@ -96,6 +105,7 @@ def plus(num: N, other: N) -> N:
     return float(D(str(num)) + D(str(other)))
 
 
+@pure
 @math_filter
 def round_(num: N, ndigits: Optional[int] = None) -> N:
     """Round a number to a given precision in decimal digits."""
@@ -105,6 +115,7 @@ def round_(num: N, ndigits: Optional[int] = None) -> N:
     return round(num)
 
 
+@pure
 @math_filter
 def times(num: N, other: N) -> N:
     """Multiply a value by an integer or float."""
@@ -115,6 +126,7 @@ def times(num: N, other: N) -> N:
     return float(D(str(num)) * D(str(other)))
 
 
+@pure
 @math_filter
 def modulo(num: N, other: N) -> N:
     """Divide a value by a number and returns the remainder."""
@@ -18,6 +18,7 @@ except ImportError:
 from liquid import is_undefined
 
 from liquid.filter import liquid_filter
+from liquid.filter import pure
 from liquid.filter import with_environment
 
 from liquid.exceptions import FilterArgumentError
@@ -27,12 +28,14 @@ if TYPE_CHECKING:
     from liquid import Environment
 
 
+@pure
 @liquid_filter
 def size(obj: Any) -> int:
     """Return the length of an array or string."""
     return len(obj)
 
 
+@pure
 @liquid_filter
 def default(obj: Any, default_: object, *, allow_false: bool = False) -> Any:
     """Return a default value if the input is nil, false, or empty."""
@@ -27,6 +27,7 @@ from liquid.exceptions import FilterArgumentError
 from liquid.exceptions import FilterValueError
 
 from liquid.filter import with_environment
+from liquid.filter import pure
 from liquid.filter import string_filter
 
 from liquid.utils.html import strip_tags
@@ -37,6 +38,7 @@ if TYPE_CHECKING:
     from liquid import Environment
 
 
+@pure
 @string_filter
 def append(val: str, arg: object) -> str:
     """Concatenate two strings."""
@@ -45,6 +47,7 @@ def append(val: str, arg: object) -> str:
     return val + arg
 
 
+@pure
 @string_filter
 def capitalize(val: str) -> str:
     """Make sure the first character of a string is upper case and the rest
@@ -52,30 +55,38 @@ def capitalize(val: str) -> str:
     return val.capitalize()
 
 
+@pure
 @string_filter
 def downcase(val: str) -> str:
     """Make all characters in a string lower case."""
     return val.lower()
 
 
+@pure
 @with_environment
 @string_filter
 def escape(val: str, *, environment: Environment) -> str:
     """Convert the characters &, < and > in string s to HTML-safe sequences."""
     if environment.autoescape:
-        return markupsafe_escape(str(val))
+        # Markup is escaped again, as a plain string.
+        return markupsafe_escape(val if val.__class__ is str else str(val))
     return html.escape(val)
 
 
+@pure
 @with_environment
 @string_filter
 def escape_once(val: str, *, environment: Environment) -> str:
     """Convert the characters &, < and > in string s to HTML-safe sequences."""
+    if "&" not in val:
+        # Nothing has been escaped yet.
+        return str(val) if environment.autoescape else html.escape(val)
     if environment.autoescape:
         return Markup(val).unescape()
     return html.escape(html.unescape(val))
 
 
+@pure
 @string_filter
 def lstrip(val: str) -> str:
     """Remove leading whitespace."""
@@ -85,6 +96,7 @@ def lstrip(val: str) -> str:
 RE_LINETERM = re.compile(r"\r?\n")
 
 
+@pure
 @with_environment
 @string_filter
 def newline_to_br(val: str, *, environment: Environment) -> str:
@@ -97,24 +109,28 @@ def newline_to_br(val: str, *, environment: Environment) -> str:
     return RE_LINETERM.sub("<br />\n", val)
 
 
+@pure
 @string_filter
 def prepend(val: str, arg: str) -> str:
     """Concatenate string value to argument string."""
     return soft_str(arg) + val
 
 
+@pure
 @string_filter
 def remove(val: str, arg: str) -> str:
     """Remove all occurrences of argument string from value."""
     return val.replace(soft_str(arg), "")
 
 
+@pure
 @string_filter
 def remove_first(val: str, arg: str) -> str:
     """Remove the first occurrences of the argument string from value."""
     return val.replace(soft_str(arg), "", 1)
 
 
+@pure
 @string_filter
 def replace(val: str, seq: str, sub: str) -> str:
     """Replaces every occurrence of the first argument in a string with the second
@@ -125,6 +141,7 @@ def replace(val: str, seq: str, sub: str) -> str:
     return val.replace(soft_str(seq), soft_str(sub))
 
 
+@pure
 @string_filter
 def replace_first(val: str, seq: str, sub: str) -> str:
     """Replaces the first occurrence of the first argument in a string with the second
@@ -135,12 +152,14 @@ def replace_first(val: str, seq: str, sub: str) -> str:
     return val.replace(soft_str(seq), soft_str(sub), 1)
 
 
+@pure
 @string_filter
 def upcase(val: str) -> str:
     """Make all characters in a string upper case."""
     return val.upper()
 
 
+@pure
 @string_filter
 def slice_(val: str, start: Any, length: int = 1) -> str:
     """Return a substring, starting at `start`, containing up to `length` characters."""
@@ -173,6 +192,7 @@ def slice_(val: str, start: Any, length: int = 1) -> str:
     return val[start : start + length]
 
 
+@pure
 @string_filter
 def split(val: str, seq: str) -> List[str]:
     """Split a string into a list of string, using the argument as a delimiter."""
@@ -182,18 +202,21 @@ def split(val: str, seq: str) -> List[str]:
     return val.split(soft_str(seq))
 
 
+@pure
 @string_filter
 def strip(val: str) -> str:
     """Remove leading and trailing whitespace."""
     return val.strip()
 
 
+@pure
 @string_filter
 def rstrip(val: str) -> str:
     """Remove trailing whitespace."""
     return val.rstrip()
 
 
+@pure
 @with_environment
 @string_filter
 def strip_html(val: str, *, environment: Environment) -> str:
@@ -204,6 +227,7 @@ def strip_html(val: str, *, environment: Environment) -> str:
     return stripped
 
 
+@pure
 @with_environment
 @string_filter
 def strip_newlines(val: str, *, environment: Environment) -> str:
@@ -214,6 +238,7 @@ def strip_newlines(val: str, *, environment: Environment) -> str:
     return RE_LINETERM.sub("", val)
 
 
+@pure
 @string_filter
 def truncate(val: str, num: Any, end: str = "...") -> str:
     """Truncate a string if it is longer than the specified number of characters."""
@@ -231,6 +256,7 @@ def truncate(val: str, num: Any, end: str = "...") -> str:
     return truncate_chars(val, num, end)
 
 
+@pure
 @string_filter
 def truncatewords(val: str, num: Any, end: str = "...") -> str:
     """Shorten a string down to the given number of words."""
@@ -254,6 +280,7 @@ def truncatewords(val: str, num: Any, end: str = "...") -> str:
     return truncate_words(val, num, end)
 
 
+@pure
 @with_environment
 @string_filter
 def url_encode(val: str, *, environment: Environment) -> str:
@@ -263,6 +290,7 @@ def url_encode(val: str, *, environment: Environment) -> str:
     return urllib.parse.quote_plus(val)
 
 
+@pure
 @string_filter
 def url_decode(val: str) -> str:
     """Decode a string that has been URL encoded."""
@@ -270,12 +298,14 @@ def url_decode(val: str) -> str:
     return urllib.parse.unquote_plus(val)
 
 
+@pure
 @string_filter
 def base64_encode(val: str) -> str:
     """Encode a string to base64."""
     return base64.b64encode(val.encode()).decode()
 
 
+@pure
 @string_filter
 def base64_decode(val: str) -> str:
     """Decode a string from base64.
@@ -288,12 +318,14 @@ def base64_decode(val: str) -> str:
         raise FilterValueError("Invalid base64-encoded string.") from err
 
 
+@pure
 @string_filter
 def base64_url_safe_encode(val: str) -> str:
     """Encode a string to URL safe base64."""
     return base64.urlsafe_b64encode(val.encode()).decode()
 
 
+@pure
 @string_filter
 def base64_url_safe_decode(val: str) -> str:
     """Decode a URL safe string from base64.
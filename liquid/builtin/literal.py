@@ -5,6 +5,7 @@ from typing import TextIO
 
 from liquid.ast import Node
 from liquid.context import Context
+from liquid.output import BytesBuffer
 from liquid.stream import TokenStream
 from liquid.tag import Tag
 
@@ -15,10 +16,11 @@ from liquid.token import TOKEN_LITERAL
 class LiteralNode(Node):
     """Parse tree node for template literals."""
 
-    __slots__ = ("tok",)
+    __slots__ = ("tok", "_encoded")
 
     def __init__(self, tok: Token):
         self.tok = tok
+        self._encoded: Optional[bytes] = None
 
     def __str__(self) -> str:
         return self.tok.value
@@ -26,8 +28,19 @@ class LiteralNode(Node):
     def __repr__(self) -> str:  # pragma: no cover
         return f"LiteralNode(tok={self.tok})"
 
+    @property
+    def encoded(self) -> bytes:
+        """This literal's text encoded as UTF-8. It is encoded the first time it is
+        rendered to a :class:`liquid.output.BytesBuffer`, then reused."""
+        if self._encoded is None:
+            self._encoded = self.tok.value.encode("utf-8")
+        return self._encoded
+
     def render_to_output(self, context: Context, buffer: TextIO) -> Optional[bool]:
-        buffer.write(self.tok.value)
+        if buffer.__class__ is BytesBuffer:
+            buffer.write_literal(self.tok.value, self.encoded)  # type: ignore
+        else:
+            buffer.write(self.tok.value)
         return None
 
 
@@ -4,11 +4,9 @@ from typing import TextIO
 
 try:
     from markupsafe import escape
-    from markupsafe import Markup
     from markupsafe import soft_str
 except ImportError:
     from liquid.exceptions import escape  # type: ignore
-    from liquid.exceptions import Markup  # type: ignore
 
     # pylint: disable=invalid-name
     soft_str = str  # type: ignore
@@ -16,9 +14,9 @@ except ImportError:
 from liquid.ast import Node
 from liquid.context import Context
 from liquid.expression import Expression
-from liquid.lex import tokenize_filtered_expression
 
-from liquid.parse import parse_filtered_expression
+from liquid.layout import LayoutContent
+
 from liquid.parse import expect
 
 from liquid.stream import TokenStream
@@ -27,6 +25,49 @@ from liquid.tag import Tag
 from liquid.token import Token
 from liquid.token import TOKEN_STATEMENT
 
+from liquid.utils.html import escape_join
+
+# Values of these types are written without escaping, even if autoescape is enabled.
+SAFE_TYPES = (int, float)
+
+# The name of the variable that holds a layout's content. See `liquid.layout`.
+CONTENT_FOR_LAYOUT = "content_for_layout"
+
+
+def to_liquid_string(val: object, autoescape: bool) -> str:
+    """Return the output statement string representation of ``val``, escaping it if
+    ``autoescape`` is ``True``.
+
+    Strings that are already markup and numbers are never escaped. Items of a list are
+    escaped together, unless any of them is already markup.
+    """
+    if isinstance(val, str):
+        # shortcut for common case. Markup is already safe.
+        if autoescape and not hasattr(val, "__html__"):
+            return escape(val)
+        return val
+
+    if isinstance(val, bool):
+        return "true" if val else "false"
+
+    if val is None:
+        return ""
+
+    if val.__class__ in SAFE_TYPES:
+        # Numbers never contain characters that need escaping.
+        return str(val)
+
+    if isinstance(val, list):
+        if autoescape:
+            return escape_join(val)
+        return "".join(soft_str(itm) for itm in val)
+
+    val = str(val)
+
+    if autoescape:
+        return escape(val)
+    return val
+
 
 class StatementNode(Node):
     """Parse tree node representing an output statement."""
@@ -44,27 +85,7 @@ class StatementNode(Node):
         return f"StatementNode(tok={self.tok}, expression={self.expression!r})"
 
     def _to_liquid_string(self, val: object, autoescape: bool) -> str:
-        if isinstance(val, str):
-            # shortcut for common case.
-            pass
-        elif isinstance(val, bool):
-            val = str(val).lower()
-        elif val is None:
-            val = ""
-        elif isinstance(val, list):
-            if autoescape:
-                val = Markup("").join(soft_str(itm) for itm in val)
-            else:
-                val = "".join(soft_str(itm) for itm in val)
-        else:
-            val = str(val)
-
-        assert isinstance(val, str)
-
-        if autoescape:
-            val = escape(val)
-
-        return val
+        return to_liquid_string(val, autoescape)
 
     def render_to_output(self, context: Context, buffer: TextIO) -> Optional[bool]:
         val = self.expression.evaluate(context)
@@ -79,6 +100,45 @@ class StatementNode(Node):
         return None
 
 
+class LayoutContentNode(StatementNode):
+    """Parse tree node representing a ``{{ content_for_layout }}`` output statement.
+
+    If ``content_for_layout`` is a :class:`liquid.layout.LayoutContent`, its template
+    is rendered directly to the output buffer. Otherwise this behaves like any other
+    output statement.
+    """
+
+    __slots__ = ()
+
+    def __repr__(self) -> str:  # pragma: no cover
+        return f"LayoutContentNode(tok={self.tok}, expression={self.expression!r})"
+
+    def content(self, context: Context) -> Optional[LayoutContent]:
+        """Return the layout content to render in place of this statement, or
+        ``None`` if ``content_for_layout`` is some other value."""
+        val = context.resolve(CONTENT_FOR_LAYOUT)
+        # Don't touch undefined values, they might be strict.
+        if type(val) is LayoutContent:  # pylint: disable=unidiomatic-typecheck
+            return val
+        return None
+
+    def render_to_output(self, context: Context, buffer: TextIO) -> Optional[bool]:
+        content = self.content(context)
+        if content is None:
+            return super().render_to_output(context, buffer)
+        content.render_with_context(context, buffer)
+        return None
+
+    async def render_to_output_async(
+        self, context: Context, buffer: TextIO
+    ) -> Optional[bool]:
+        content = self.content(context)
+        if content is None:
+            return await super().render_to_output_async(context, buffer)
+        await content.render_with_context_async(context, buffer)
+        return None
+
+
 class Statement(Tag):
     """Pseudo "tag" to register output statements with the environment."""
 
@@ -88,6 +148,7 @@ class Statement(Tag):
         tok = stream.current
         expect(stream, TOKEN_STATEMENT)
 
-        expr_iter = tokenize_filtered_expression(tok.value)
-        node = StatementNode(tok, parse_filtered_expression(TokenStream(expr_iter)))
-        return node
+        expr = self.env.parse_filtered_expression_value(tok.value)
+        if tok.value == CONTENT_FOR_LAYOUT:
+            return LayoutContentNode(tok, expr)
+        return StatementNode(tok, expr)
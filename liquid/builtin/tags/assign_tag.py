@@ -14,10 +14,9 @@ from liquid.ast import Node
 from liquid.tag import Tag
 from liquid.context import Context
 from liquid.stream import TokenStream
-from liquid.lex import tokenize_filtered_expression
 from liquid.expression import AssignmentExpression
 from liquid.exceptions import LiquidSyntaxError
-from liquid.parse import expect, parse_filtered_expression
+from liquid.parse import expect
 
 RE_ASSIGNMENT = re.compile(r"^(\w[a-zA-Z0-9_\-]*)\s*=\s*(.+)$")
 
@@ -70,6 +69,5 @@ class AssignTag(Tag):
                 linenum=stream.current.linenum,
             )
 
-        expr_iter = tokenize_filtered_expression(expression)
-        expr = parse_filtered_expression(TokenStream(expr_iter))
+        expr = self.env.parse_filtered_expression_value(expression)
         return AssignNode(tok, AssignmentExpression(name, expr))
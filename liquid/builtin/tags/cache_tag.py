@@ -0,0 +1,176 @@
+"""Parse tree node and tag definition for the built-in "cache" tag."""
+
+import hashlib
+import sys
+
+from io import StringIO
+
+from typing import List
+from typing import Optional
+from typing import TextIO
+
+from liquid import ast
+from liquid.context import Context
+from liquid.exceptions import LiquidSyntaxError
+from liquid.exceptions import LiquidTypeError
+from liquid.expression import Expression
+from liquid.lex import tokenize_filtered_expression
+
+from liquid.parse import expect
+from liquid.parse import get_parser
+from liquid.parse import parse_expression
+
+from liquid.stream import TokenStream
+from liquid.tag import Tag
+
+from liquid.token import Token
+from liquid.token import TOKEN_TAG
+from liquid.token import TOKEN_EOF
+from liquid.token import TOKEN_EXPRESSION
+from liquid.token import TOKEN_COMMA
+from liquid.token import TOKEN_COLON
+from liquid.token import TOKEN_IDENTIFIER
+
+
+TAG_CACHE = sys.intern("cache")
+TAG_ENDCACHE = sys.intern("endcache")
+
+ENDCACHEBLOCK = (TAG_ENDCACHE, TOKEN_EOF)
+
+
+class CacheNode(ast.Node):
+    """Parse tree node for the built-in "cache" tag.
+
+    The rendered block is stored in the environment's fragment cache, keyed by the
+    values of the tag's key expressions and a digest of the block itself, so
+    changing the block in a template does not serve stale fragments.
+    """
+
+    __slots__ = ("tok", "keys", "ttl", "block", "digest")
+
+    def __init__(
+        self,
+        tok: Token,
+        keys: List[Expression],
+        block: ast.BlockNode,
+        ttl: Optional[Expression] = None,
+    ):
+        self.tok = tok
+        self.keys = keys
+        self.ttl = ttl
+        self.block = block
+        self.digest = hashlib.sha256(str(block).encode("utf-8")).hexdigest()
+
+    def __str__(self) -> str:
+        keys = ", ".join(str(key) for key in self.keys)
+        if self.ttl:
+            keys += f", ttl: {self.ttl}"
+        return f"cache({keys}) {{ {self.block} }}"
+
+    def __repr__(self) -> str:  # pragma: no cover
+        return f"CacheNode(tok={self.tok}, keys={self.keys}, block='{self.block}')"
+
+    def _ttl(self, ttl: object) -> float:
+        if not isinstance(ttl, (int, float)) or isinstance(ttl, bool):
+            raise LiquidTypeError(
+                f"expected a number of seconds for cache ttl, found '{ttl}'",
+                linenum=self.tok.linenum,
+            )
+        return ttl
+
+    def render_to_output(self, context: Context, buffer: TextIO) -> Optional[bool]:
+        cache = context.env.fragment_cache
+        key = cache.key(self.digest, [key.evaluate(context) for key in self.keys])
+        fragment = cache.get(key)
+
+        if fragment is None:
+            ttl = None
+            if self.ttl:
+                ttl = self._ttl(self.ttl.evaluate(context))
+            buf = StringIO()
+            self.block.render(context, buf)
+            fragment = buf.getvalue()
+            cache.set(key, fragment, ttl)
+
+        buffer.write(fragment)
+        return None
+
+    async def render_to_output_async(
+        self, context: Context, buffer: TextIO
+    ) -> Optional[bool]:
+        cache = context.env.fragment_cache
+        key = cache.key(
+            self.digest, [await key.evaluate_async(context) for key in self.keys]
+        )
+        fragment = await cache.get_async(key)
+
+        if fragment is None:
+            ttl = None
+            if self.ttl:
+                ttl = self._ttl(await self.ttl.evaluate_async(context))
+            buf = StringIO()
+            await self.block.render_async(context, buf)
+            fragment = buf.getvalue()
+            await cache.set_async(key, fragment, ttl)
+
+        buffer.write(fragment)
+        return None
+
+
+class CacheTag(Tag):
+    """The built-in "cache" tag.
+
+    .. code-block:: liquid
+
+        {% cache 'nav', menu.updated_at, ttl: 300 %}
+          ...
+        {% endcache %}
+    """
+
+    name = TAG_CACHE
+    end = TAG_ENDCACHE
+
+    def parse(self, stream: TokenStream) -> CacheNode:
+        parser = get_parser(self.env)
+
+        expect(stream, TOKEN_TAG, value=TAG_CACHE)
+        tok = stream.current
+        stream.next_token()
+
+        expect(stream, TOKEN_EXPRESSION)
+        expr_stream = TokenStream(tokenize_filtered_expression(stream.current.value))
+
+        keys: List[Expression] = []
+        ttl: Optional[Expression] = None
+
+        while expr_stream.current.type != TOKEN_EOF:
+            if (
+                expr_stream.current.type == TOKEN_IDENTIFIER
+                and expr_stream.current.value == "ttl"
+                and expr_stream.peek.type == TOKEN_COLON
+            ):
+                expr_stream.next_token()
+                expr_stream.next_token()  # Eat colon
+                ttl = parse_expression(expr_stream)
+            else:
+                keys.append(parse_expression(expr_stream))
+
+            expr_stream.next_token()
+
+            if expr_stream.current.type == TOKEN_COMMA:
+                expr_stream.next_token()  # Eat comma
+            elif expr_stream.current.type != TOKEN_EOF:
+                raise LiquidSyntaxError(
+                    f"expected a comma separated list of cache keys, "
+                    f"found {expr_stream.current.type}",
+                    linenum=tok.linenum,
+                )
+
+        if not keys:
+            raise LiquidSyntaxError("expected a cache key", linenum=tok.linenum)
+
+        stream.next_token()
+        block = parser.parse_block(stream, ENDCACHEBLOCK)
+        expect(stream, TOKEN_TAG, value=TAG_ENDCACHE)
+
+        return CacheNode(tok, keys, block=block, ttl=ttl)
@@ -3,8 +3,6 @@
 import re
 import sys
 
-from io import StringIO
-
 from typing import Optional
 from typing import TextIO
 
@@ -16,6 +14,7 @@ except ImportError:
 from liquid import ast
 from liquid.context import Context
 from liquid.exceptions import LiquidSyntaxError
+from liquid.output import SegmentBuffer
 
 from liquid.parse import expect
 from liquid.parse import get_parser
@@ -54,23 +53,23 @@ class CaptureNode(ast.Node):
     def __repr__(self) -> str:  # pragma: no cover
         return f"CaptureNode(tok={self.tok}, name={self.name}, block='{self.block}')"
 
-    def _assign(self, context: Context, buf: StringIO) -> None:
+    def _assign(self, context: Context, buf: SegmentBuffer) -> None:
         if context.autoescape:
             context.assign(self.name, Markup(buf.getvalue()))
         else:
             context.assign(self.name, buf.getvalue())
 
     def render_to_output(self, context: Context, buffer: TextIO) -> Optional[bool]:
-        buf = StringIO()
-        self.block.render(context, buf)
+        buf = SegmentBuffer()
+        self.block.render(context, buf)  # type: ignore
         self._assign(context, buf)
         return None
 
     async def render_to_output_async(
         self, context: Context, buffer: TextIO
     ) -> Optional[bool]:
-        buf = StringIO()
-        await self.block.render_async(context, buf)
+        buf = SegmentBuffer()
+        await self.block.render_async(context, buf)  # type: ignore
         self._assign(context, buf)
         return None
 
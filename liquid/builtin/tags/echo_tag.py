@@ -5,9 +5,7 @@ import sys
 
 from liquid.ast import Node
 from liquid.builtin.statement import StatementNode
-from liquid.lex import tokenize_filtered_expression
 
-from liquid.parse import parse_filtered_expression
 from liquid.parse import expect
 
 from liquid.stream import TokenStream
@@ -40,7 +38,5 @@ class EchoTag(Tag):
         stream.next_token()
 
         expect(stream, TOKEN_EXPRESSION)
-        expr_iter = tokenize_filtered_expression(stream.current.value)
-
-        expr = parse_filtered_expression(TokenStream(expr_iter))
+        expr = self.env.parse_filtered_expression_value(stream.current.value)
         return EchoNode(tok, expression=expr)
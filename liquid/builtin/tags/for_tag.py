@@ -2,27 +2,34 @@
 
 import sys
 
+from typing import Dict
 from typing import Optional
 from typing import Any
 from typing import List
 from typing import Mapping
 from typing import TextIO
+from typing import Tuple
 from typing import Iterator
 
 from liquid.ast import Node
 from liquid.ast import BlockNode
 
+from liquid.builtin.tags.include_tag import IncludeNode
+
 from liquid.context import Context
+
+from liquid.expression import Expression
+from liquid.expression import Filter
+from liquid.expression import Identifier
+from liquid.expression import IdentifierPathElement
 from liquid.expression import LoopExpression
 
 from liquid.exceptions import BreakLoop
 from liquid.exceptions import ContinueLoop
 
-from liquid.lex import tokenize_loop_expression
 
 from liquid.parse import get_parser
 from liquid.parse import expect
-from liquid.parse import parse_loop_expression
 
 from liquid.stream import TokenStream
 from liquid.tag import Tag
@@ -44,36 +51,20 @@ ENDFORELSEBLOCK = (TAG_ENDFOR,)
 
 
 class ForLoop(Mapping[str, object]):
-    """Loop helper variables."""
-
-    __slots__ = (
-        "name",
-        "it",
-        "length",
-        "item",
-        "first",
-        "last",
-        "index",
-        "index0",
-        "rindex",
-        "rindex0",
-        "_keys",
-    )
+    """Loop helper variables.
 
-    def __init__(self, name: str, it: Iterator[Any], length: int):
-        self.name = name
-        self.it = it
-        self.length = length
+    Only the zero based index is updated on each iteration. Other helper variables are
+    computed from it when they are accessed.
 
-        self.item = None
-        self.first = False
-        self.last = False
-        self.index = 0
-        self.index0 = -1
-        self.rindex = self.length + 1
-        self.rindex0 = self.length
+    If ``length`` is ``None``, as it is when looping over a generator, the remaining
+    items are buffered the first time ``length``, ``rindex``, ``rindex0`` or ``last``
+    is accessed. Loops that don't use those variables never hold more than one item.
+    """
 
-        self._keys: List[str] = [
+    __slots__ = ("name", "it", "_length", "item", "index0")
+
+    _keys = frozenset(
+        [
             "length",
             "index",
             "index0",
@@ -82,9 +73,52 @@ class ForLoop(Mapping[str, object]):
             "first",
             "last",
         ]
+    )
+
+    def __init__(self, name: str, it: Iterator[Any], length: Optional[int]):
+        self.name = name
+        self.it = it
+        self._length = length
+
+        self.item = None
+        self.index0 = -1
+
+    @property
+    def length(self) -> int:
+        """The total number of iterations."""
+        if self._length is None:
+            rest = list(self.it)
+            self.it = iter(rest)
+            self._length = self.index0 + 1 + len(rest)
+        return self._length
+
+    @property
+    def index(self) -> int:
+        """The one based index of the current iteration."""
+        return self.index0 + 1
+
+    @property
+    def rindex(self) -> int:
+        """The number of iterations remaining, including the current iteration."""
+        return self.length - self.index0
+
+    @property
+    def rindex0(self) -> int:
+        """The number of iterations remaining after the current iteration."""
+        return self.length - self.index0 - 1
+
+    @property
+    def first(self) -> bool:
+        """``True`` if this is the first iteration."""
+        return self.index0 == 0
+
+    @property
+    def last(self) -> bool:
+        """``True`` if this is the last iteration."""
+        return self.index0 >= 0 and self.index0 == self.length - 1
 
     def __repr__(self) -> str:  # pragma: no cover
-        return f"ForLoop(name='{self.name}', length={self.length})"
+        return f"ForLoop(name='{self.name}', length={self._length})"
 
     def __getitem__(self, key: str) -> object:
         if key in self._keys:
@@ -95,7 +129,7 @@ class ForLoop(Mapping[str, object]):
         return len(self._keys)
 
     def __next__(self) -> object:
-        self.step()
+        self.index0 += 1
         return next(self.it)
 
     def __iter__(self) -> Iterator[Any]:
@@ -104,32 +138,89 @@ class ForLoop(Mapping[str, object]):
     def __str__(self) -> str:
         return "ForLoop"
 
-    def step(self) -> None:
-        """Set the value for the current/next loop iteration and update forloop
-        helper variables."""
-
-        self.index += 1
-        self.index0 += 1
-        self.rindex -= 1
-        self.rindex0 -= 1
-
-        if self.index0 == 0:
-            self.first = True
-        else:
-            self.first = False
-
-        if self.rindex0 == 0:
-            self.last = True
-        else:
-            self.last = False
 
-        return None
+# Names of slots that might hold expressions or nodes, by class, or `None` if objects
+# of the class can't reference a variable.
+_search_slots: Dict[type, Optional[Tuple[str, ...]]] = {}
+
+
+def _slots_for(cls: type) -> Optional[Tuple[str, ...]]:
+    try:
+        return _search_slots[cls]
+    except KeyError:
+        pass
+
+    slots: Optional[Tuple[str, ...]] = None
+    if issubclass(cls, (Node, Expression, Filter)):
+        slots = tuple(
+            slot
+            for _cls in cls.__mro__
+            for slot in getattr(_cls, "__slots__", ())
+            if slot != "tok"
+        )
+    _search_slots[cls] = slots
+    return slots
+
+
+def _references_forloop(block: Node) -> bool:
+    """Return ``True`` if rendering ``block`` might read a ``forloop`` variable.
+
+    Nodes from outside this package, like those from custom tags, and ``include``
+    tags, which can share a ``forloop`` with another template, are assumed to
+    reference ``forloop``.
+    """
+    stack: List[object] = [block]
+
+    while stack:
+        obj = stack.pop()
+        cls = obj.__class__
+
+        if cls is list or cls is tuple:
+            stack.extend(obj)  # type: ignore
+            continue
+
+        if cls is dict:
+            stack.extend(obj.values())  # type: ignore
+            continue
+
+        if isinstance(obj, Identifier):
+            root = obj.path[0] if obj.path else None
+            if not isinstance(root, IdentifierPathElement) or root.value == "forloop":
+                return True
+            stack.extend(obj.path[1:])
+            continue
+
+        if cls is ForNode:
+            # A nested loop's block gets its own `forloop`.
+            assert isinstance(obj, ForNode)
+            stack.append(obj.expression)
+            stack.append(obj.default)
+            continue
+
+        slots = _slots_for(cls)
+        if slots is None:
+            if isinstance(obj, (list, tuple)):
+                stack.extend(obj)
+            elif isinstance(obj, dict):
+                stack.extend(obj.values())
+            continue
+
+        if cls is IncludeNode or (
+            issubclass(cls, Node)
+            and not cls.__module__.startswith(("liquid.ast", "liquid.builtin."))
+        ):
+            return True
+
+        for slot in slots:
+            stack.append(getattr(obj, slot, None))
+
+    return False
 
 
 class ForNode(Node):
     """Parse tree node for the built-in "for" tag."""
 
-    __slots__ = ("tok", "expression", "block", "default")
+    __slots__ = ("tok", "expression", "block", "default", "uses_forloop")
 
     def __init__(
         self,
@@ -143,6 +234,9 @@ class ForNode(Node):
         self.block = block
         self.default = default
 
+        # If the block never reads `forloop`, we don't need to build one.
+        self.uses_forloop = _references_forloop(block)
+
     def __str__(self) -> str:
         tag_str = f"for ({self.expression}) {{ {self.block} }}"
 
@@ -154,25 +248,25 @@ class ForNode(Node):
     def render_to_output(self, context: Context, buffer: TextIO) -> Optional[bool]:
         loop_iter, length = self.expression.evaluate(context)
 
-        if length:
+        # Length is None for a non-empty iterable of unknown length.
+        if length != 0:
             name = self.expression.name
+            namespace: Dict[str, object] = {name: None}
 
-            forloop = ForLoop(
-                name=name,
-                it=loop_iter,
-                length=length,
-            )
-
-            namespace = {
-                "forloop": forloop,
-                name: None,
-            }
+            if self.uses_forloop:
+                forloop = ForLoop(
+                    name=name,
+                    it=loop_iter,
+                    length=length,
+                )
+                namespace["forloop"] = forloop
+                loop_iter = forloop
 
             # Extend the context. Essentially giving priority to `ForLoopDrop`, then
             # delegating `get` and `assign` to the outer context.
-            with context.extend(namespace):
+            with context.extend(namespace, fixed_keys=True):
 
-                for itm in forloop:
+                for itm in loop_iter:
                     namespace[name] = itm
 
                     try:
@@ -192,25 +286,25 @@ class ForNode(Node):
     ) -> Optional[bool]:
         loop_iter, length = await self.expression.evaluate_async(context)
 
-        if length:
+        # Length is None for a non-empty iterable of unknown length.
+        if length != 0:
             name = self.expression.name
+            namespace: Dict[str, object] = {name: None}
 
-            forloop = ForLoop(
-                name=name,
-                it=loop_iter,
-                length=length,
-            )
-
-            namespace = {
-                "forloop": forloop,
-                name: None,
-            }
+            if self.uses_forloop:
+                forloop = ForLoop(
+                    name=name,
+                    it=loop_iter,
+                    length=length,
+                )
+                namespace["forloop"] = forloop
+                loop_iter = forloop
 
             # Extend the context. Essentially giving priority to `ForLoopDrop`, then
             # delegating `get` and `assign` to the outer context.
-            with context.extend(namespace):
+            with context.extend(namespace, fixed_keys=True):
 
-                for itm in forloop:
+                for itm in loop_iter:
                     namespace[name] = itm
 
                     try:
@@ -278,8 +372,7 @@ class ForTag(Tag):
         stream.next_token()
 
         expect(stream, TOKEN_EXPRESSION)
-        expr_iter = tokenize_loop_expression(stream.current.value)
-        expr = parse_loop_expression(TokenStream(expr_iter))
+        expr = self.env.parse_loop_expression_value(stream.current.value)
 
         stream.next_token()
 
@@ -1,11 +1,17 @@
 """Parse tree node and tag definition for the built in "include" tag."""
+from __future__ import annotations
+
 import sys
+import time
+import weakref
 
 from typing import Optional
 from typing import Dict
 from typing import Any
+from typing import Hashable
 from typing import TextIO
 from typing import Tuple
+from typing import TYPE_CHECKING
 
 from liquid.ast import Node
 from liquid.builtin.drops import IterableDrop
@@ -13,6 +19,7 @@ from liquid.context import Context
 
 from liquid.expression import Expression
 from liquid.expression import Identifier
+from liquid.expression import StringLiteral
 
 from liquid.exceptions import LiquidSyntaxError
 from liquid.lex import tokenize_include_expression
@@ -36,14 +43,132 @@ from liquid.token import TOKEN_COMMA
 from liquid.token import TOKEN_COLON
 from liquid.token import TOKEN_EOF
 
+from liquid.utils import LRUCache
+
+if TYPE_CHECKING:  # pragma: no cover
+    from liquid import Environment
+    from liquid.template import BoundTemplate
+
 
 TAG_INCLUDE = sys.intern("include")
 
 
+def _unlinked() -> None:
+    return None
+
+
+# Links are only followed if templates are loaded with these. Context subclasses that
+# load templates differently, and the profiler's load hooks, see every lookup.
+_GET_TEMPLATE = Context.get_template
+_GET_TEMPLATE_ASYNC = Context.get_template_async
+
+
+class TemplateLink:
+    """A partial template loaded by an ``include`` or ``render`` tag with a string
+    literal name, kept so the tag doesn't need to get it from the environment again.
+
+    A link is only followed for the environment it was made with, only until a
+    template is added to or removed from that environment's cache, and only until
+    the template's cache entry expires, if the cache is an
+    :class:`liquid.utils.LRUCache` with a ``ttl``. If ``auto_reload`` is enabled, the
+    template must still be up to date. Links are not followed if the render context's
+    ``get_template`` method has been overridden or patched. Links are not pickled or
+    copied, and they don't keep the template or environment alive.
+
+    :param env: The environment the template was loaded from.
+    :param version: The environment's ``cache_version`` when the link was made.
+    :param key: Anything else the template's name depends on, like the ``render``
+        tag's ``render_folder``.
+    :param template: The linked template.
+    :param expires: The time, according to :func:`time.monotonic`, at which the
+        template's cache entry expires, or ``None`` if it doesn't expire.
+    """
+
+    __slots__ = ("env", "version", "key", "template", "expires")
+
+    def __init__(
+        self,
+        env: Environment,
+        version: int,
+        key: Hashable,
+        template: BoundTemplate,
+        expires: Optional[float] = None,
+    ):
+        self.env = weakref.ref(env)
+        self.version = version
+        self.key = key
+        self.template = weakref.ref(template)
+        self.expires = expires
+
+    @classmethod
+    def from_cache(
+        cls,
+        env: Environment,
+        name: str,
+        key: Hashable,
+        template: BoundTemplate,
+    ) -> Optional[TemplateLink]:
+        """Return a link to a template that was just loaded with the given name, or
+        ``None`` if it is not the template in the environment's cache with that name.
+        """
+        # Read the version first. If the cache changes after this, the link won't be
+        # followed.
+        version = env.cache_version
+        cache = env.cache
+
+        if isinstance(cache, LRUCache):
+            if cache.peek(name) is not template:
+                return None
+            return cls(env, version, key, template, cache.expires(name))
+
+        if cache.get(name) is not template:
+            return None
+        return cls(env, version, key, template)
+
+    def __reduce__(self) -> Tuple[Any, ...]:
+        return (_unlinked, ())
+
+    def _get(self, env: Environment, key: Hashable) -> Optional[BoundTemplate]:
+        if self.env() is not env or self.version != env.cache_version:
+            return None
+        if self.key != key:
+            return None
+        if self.expires is not None and self.expires <= time.monotonic():
+            return None
+        return self.template()
+
+    def get(self, context: Context, key: Hashable = None) -> Optional[BoundTemplate]:
+        """Return the linked template, or ``None`` if it needs to be loaded again with
+        ``context.get_template``."""
+        if type(context).get_template is not _GET_TEMPLATE:
+            return None
+
+        env = context.env
+        template = self._get(env, key)
+        if template is None or not env.auto_reload:
+            return template
+        # pylint: disable=protected-access
+        return template if env._is_up_to_date(template) else None
+
+    async def get_async(
+        self, context: Context, key: Hashable = None
+    ) -> Optional[BoundTemplate]:
+        """An async version of :meth:`TemplateLink.get`."""
+        if type(context).get_template_async is not _GET_TEMPLATE_ASYNC:
+            return None
+
+        env = context.env
+        template = self._get(env, key)
+        if template is None or not env.auto_reload:
+            return template
+        # pylint: disable=protected-access
+        return template if await env._is_up_to_date_async(template) else None
+
+
 class IncludeNode(Node):
     """Parse tree node for the built-in "include" tag."""
 
-    __slots__ = ("tok", "name", "var", "alias", "args")
+    __slots__ = ("tok", "name", "var", "alias", "args", "_link")
 
     def __init__(
         self,
@@ -59,6 +184,9 @@ class IncludeNode(Node):
         self.alias = alias
         self.args = args or {}
 
+        # The partial template, if its name is a string literal.
+        self._link: Optional[TemplateLink] = None
+
     def __str__(self) -> str:
         buf = [f"{self.name}"]
 
@@ -79,9 +207,32 @@ class IncludeNode(Node):
     def __repr__(self) -> str:
         return f"IncludeNode(tok={self.tok!r}, name={self.name})"  # pragma: no cover
 
+    def _get_template(self, context: Context) -> BoundTemplate:
+        if self._link is not None:
+            template = self._link.get(context)
+            if template is not None:
+                return template
+
+        name = str(self.name.evaluate(context))
+        template = context.get_template(name)
+        if self.name.__class__ is StringLiteral:
+            self._link = TemplateLink.from_cache(context.env, name, None, template)
+        return template
+
+    async def _get_template_async(self, context: Context) -> BoundTemplate:
+        if self._link is not None:
+            template = await self._link.get_async(context)
+            if template is not None:
+                return template
+
+        name = str(await self.name.evaluate_async(context))
+        template = await context.get_template_async(name)
+        if self.name.__class__ is StringLiteral:
+            self._link = TemplateLink.from_cache(context.env, name, None, template)
+        return template
+
     def render_to_output(self, context: Context, buffer: TextIO) -> Optional[bool]:
-        name = self.name.evaluate(context)
-        template = context.get_template(str(name))
+        template = self._get_template(context)
 
         namespace: Dict[str, object] = {}
 
@@ -89,12 +240,18 @@ class IncludeNode(Node):
         for key, val in self.args.items():
             namespace[key] = val.evaluate(context)
 
-        with context.extend(namespace):
-            # Bind a variable to the included template.
-            if self.var is not None:
+        # Bind a variable to the included template.
+        if self.var is not None:
+            # The bound variable is evaluated with keyword arguments in scope, but
+            # its key must be in the namespace before the context is extended for
+            # the included template.
+            with context.extend(namespace, fixed_keys=True):
                 val = self.var.evaluate(context)
-                key = self.alias or template.name.split(".")[0]
 
+            key = self.alias or template.name.split(".")[0]
+            namespace[key] = val
+
+            with context.extend(namespace, fixed_keys=True):
                 # If the variable is array-like, render the template once for each
                 # item in the array.
                 #
@@ -111,9 +268,9 @@ class IncludeNode(Node):
                         namespace[key] = itm
                         template.render_with_context(context, buffer, partial=True)
                 else:
-                    namespace[key] = val
                     template.render_with_context(context, buffer, partial=True)
-            else:
+        else:
+            with context.extend(namespace, fixed_keys=True):
                 template.render_with_context(context, buffer, partial=True)
 
         return None
@@ -123,18 +280,20 @@ class IncludeNode(Node):
     ) -> Optional[bool]:
         """Same as ``render_to_output`` but uses async versions of get_template and
         render_with_context."""
-        name = await self.name.evaluate_async(context)
-        template = await context.get_template_async(str(name))
+        template = await self._get_template_async(context)
         namespace: Dict[str, object] = {}
 
         for key, val in self.args.items():
             namespace[key] = await val.evaluate_async(context)
 
-        with context.extend(namespace):
-            if self.var is not None:
+        if self.var is not None:
+            with context.extend(namespace, fixed_keys=True):
                 val = await self.var.evaluate_async(context)
-                key = self.alias or template.name.split(".")[0]
 
+            key = self.alias or template.name.split(".")[0]
+            namespace[key] = val
+
+            with context.extend(namespace, fixed_keys=True):
                 if isinstance(val, (tuple, list, IterableDrop)):
                     for itm in val:
                         namespace[key] = itm
@@ -142,11 +301,11 @@ class IncludeNode(Node):
                             context, buffer, partial=True
                         )
                 else:
-                    namespace[key] = val
                     await template.render_with_context_async(
                         context, buffer, partial=True
                     )
-            else:
+        else:
+            with context.extend(namespace, fixed_keys=True):
                 await template.render_with_context_async(context, buffer, partial=True)
 
         return None
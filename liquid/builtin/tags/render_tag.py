@@ -1,19 +1,25 @@
 """Parse tree node and tag definition for the built in "render" tag."""
+from __future__ import annotations
 
 import pathlib
 import sys
 
+from io import StringIO
+
 from typing import Optional
 from typing import Dict
 from typing import Any
+from typing import Hashable
 from typing import TextIO
 from typing import Tuple
+from typing import TYPE_CHECKING
 
 from liquid.ast import Node
 
 from liquid.builtin.drops import IterableDrop
 from liquid.builtin.tags.for_tag import ForLoop
 from liquid.builtin.tags.include_tag import TAG_INCLUDE
+from liquid.builtin.tags.include_tag import TemplateLink
 
 from liquid.context import Context
 from liquid.context import ReadOnlyChainMap
@@ -22,6 +28,7 @@ from liquid.exceptions import LiquidSyntaxError
 
 from liquid.expression import Expression
 from liquid.expression import Identifier
+from liquid.expression import StringLiteral
 
 from liquid.lex import tokenize_include_expression
 
@@ -46,6 +53,9 @@ from liquid.token import TOKEN_COLON
 from liquid.token import TOKEN_EOF
 from liquid.token import TOKEN_STRING
 
+if TYPE_CHECKING:  # pragma: no cover
+    from liquid.template import BoundTemplate
+
 
 TAG_RENDER = sys.intern("render")
 
@@ -53,7 +63,7 @@ TAG_RENDER = sys.intern("render")
 class RenderNode(Node):
     """Parse tree node for the built-in "render" tag."""
 
-    __slots__ = ("tok", "name", "var", "loop", "alias", "args")
+    __slots__ = ("tok", "name", "var", "loop", "alias", "args", "_link")
 
     def __init__(
         self,
@@ -71,6 +81,9 @@ class RenderNode(Node):
         self.alias = alias
         self.args = args or {}
 
+        # The partial template, if its name is a string literal.
+        self._link: Optional[TemplateLink] = None
+
     def __str__(self) -> str:
         buf = [f"{self.name}"]
 
@@ -91,28 +104,97 @@ class RenderNode(Node):
     def __repr__(self) -> str:
         return f"RenderNode(tok={self.tok!r}, name={self.name})"  # pragma: no cover
 
-    def render_to_output(self, context: Context, buffer: TextIO) -> Optional[bool]:
-        path = self.name.evaluate(context)
-        assert isinstance(path, str)
+    def _path(self, name: object, render_folder: object) -> str:
+        assert isinstance(name, str)
 
         # XXX: This `render_folder` and forced ".liquid" suffix is to simulate a Shopify
         # theme structure. If it does actually belong in Python Liquid, it needs to be
         # documented.
+        if render_folder:
+            # FIXME: Don't assume ".liquid"
+            return str(pathlib.Path(str(render_folder), name).with_suffix(".liquid"))
+        return name
 
+    def _get_template(self, context: Context) -> BoundTemplate:
         # TODO: Store this kind of thing on the context object but not the
         # globals/locals namespace.
         render_folder = context.get("render_folder", default=None)
 
-        if render_folder:
-            # FIXME: Don't assume ".liquid"
-            path = str(pathlib.Path(str(render_folder), path).with_suffix(".liquid"))
+        if self._link is not None:
+            template = self._link.get(context, render_folder)
+            if template is not None:
+                return template
+
+        path = self._path(self.name.evaluate(context), render_folder)
         template = context.get_template(path)
+        if self.name.__class__ is StringLiteral:
+            self._link = TemplateLink.from_cache(
+                context.env, path, render_folder, template
+            )
+        return template
+
+    async def _get_template_async(self, context: Context) -> BoundTemplate:
+        render_folder = context.get("render_folder", default=None)
+
+        if self._link is not None:
+            template = await self._link.get_async(context, render_folder)
+            if template is not None:
+                return template
+
+        name = await self.name.evaluate_async(context)
+        path = self._path(name, render_folder)
+        template = await context.get_template_async(path)
+        if self.name.__class__ is StringLiteral:
+            self._link = TemplateLink.from_cache(
+                context.env, path, render_folder, template
+            )
+        return template
+
+    def render_to_output(self, context: Context, buffer: TextIO) -> Optional[bool]:
+        template = self._get_template(context)
 
         # Evaluate keyword arguments once. Unlike 'include', 'render' can not
         # mutate variables in the outer scope, so there's no need to re-evaluate
         # arguments for each loop (if any).
         args = {k: v.evaluate(context) for k, v in self.args.items()}
+        val = self.var.evaluate(context) if self.var is not None else None
 
+        memo = context.render_memo
+        if memo is None:
+            self._render(context, template, args, val, buffer)
+            return None
+
+        key = self._memo_key(context, template.name, args, val)
+        if key is None or not template.is_pure():
+            context.memoizable = False
+            self._render(context, template, args, val, buffer)
+            return None
+
+        output = memo.get(key)
+
+        if output is None:
+            buf = StringIO()
+            if self._render(context, template, args, val, buf, memo_key=key):
+                output = memo[key] = buf.getvalue()
+            else:
+                context.memoizable = False
+                output = buf.getvalue()
+
+        buffer.write(output)
+        return None
+
+    def _render(
+        self,
+        context: Context,
+        template: BoundTemplate,
+        args: Dict[str, object],
+        val: object,
+        buffer: TextIO,
+        memo_key: Hashable = None,
+    ) -> bool:
+        """Render the partial template with a copy of the given context. Return
+        ``False`` if the output can't be memoized because of a partial template
+        rendered by this one."""
         # We're using a chain map here in case we need to push a forloop drop into
         # it. As drops are read only, the built-in collections.ChainMap will not do.
         namespace = ReadOnlyChainMap(args)
@@ -120,10 +202,10 @@ class RenderNode(Node):
         # New context with globals and filters from the parent, plus the read only
         # namespace containing render arguments and bound variable.
         ctx = context.copy(namespace, disabled_tags=[TAG_INCLUDE])
+        ctx.memo_key = memo_key
 
         # Optionally bind a variable to the render namespace.
         if self.var is not None:
-            val = self.var.evaluate(context)
             key = self.alias or template.name.split(".")[0]
 
             # If the variable is array-like, render the template once for each item.
@@ -141,6 +223,8 @@ class RenderNode(Node):
 
                 for itm in forloop:
                     args[key] = itm
+                    if memo_key is not None:
+                        ctx.memo_key = (memo_key, forloop.index0)
                     template.render_with_context(
                         ctx, buffer, partial=True, block_scope=True
                     )
@@ -154,50 +238,64 @@ class RenderNode(Node):
         else:
             template.render_with_context(ctx, buffer, partial=True, block_scope=True)
 
-        return None
+        return ctx.memoizable
 
     async def render_to_output_async(
         self, context: Context, buffer: TextIO
     ) -> Optional[bool]:
         """An awaitable version of `render_to_output` that loads templates
         asynchronously."""
-        path = await self.name.evaluate_async(context)
-        assert isinstance(path, str)
-
-        # XXX: This `render_folder` and forced ".liquid" suffix is to simulate a Shopify
-        # theme structure. If it does actually belong in Python Liquid, it needs to be
-        # documented.
-
-        # TODO: Store this kind of thing on the context object but not the
-        # globals/locals namespace.
-        render_folder = context.get("render_folder", default=None)
-
-        if render_folder:
-            # FIXME: Don't assume ".liquid"
-            path = str(pathlib.Path(str(render_folder), path).with_suffix(".liquid"))
-        template = await context.get_template_async(path)
+        template = await self._get_template_async(context)
 
         # Evaluate keyword arguments once. Unlike 'include', 'render' can not
         # mutate variables in the outer scope, so there's no need to re-evaluate
         # arguments for each loop (if any).
         args = {k: await v.evaluate_async(context) for k, v in self.args.items()}
+        val = await self.var.evaluate_async(context) if self.var is not None else None
+
+        memo = context.render_memo
+        if memo is None:
+            await self._render_async(context, template, args, val, buffer)
+            return None
+
+        key = self._memo_key(context, template.name, args, val)
+        if key is None or not template.is_pure():
+            context.memoizable = False
+            await self._render_async(context, template, args, val, buffer)
+            return None
+
+        output = memo.get(key)
+
+        if output is None:
+            buf = StringIO()
+            if await self._render_async(
+                context, template, args, val, buf, memo_key=key
+            ):
+                output = memo[key] = buf.getvalue()
+            else:
+                context.memoizable = False
+                output = buf.getvalue()
 
-        # We're using a chain map here in case we need to push a forloop drop into
-        # it. As drops are read only, the built-in collections.ChainMap will not do.
-        namespace = ReadOnlyChainMap(args)
+        buffer.write(output)
+        return None
 
-        # New context with globals and filters from the parent, plus the read only
-        # namespace containing render arguments and bound variable.
+    async def _render_async(
+        self,
+        context: Context,
+        template: BoundTemplate,
+        args: Dict[str, object],
+        val: object,
+        buffer: TextIO,
+        memo_key: Hashable = None,
+    ) -> bool:
+        """An async version of `_render`."""
+        namespace = ReadOnlyChainMap(args)
         ctx = context.copy(namespace, disabled_tags=[TAG_INCLUDE])
+        ctx.memo_key = memo_key
 
-        # Optionally bind a variable to the render namespace.
         if self.var is not None:
-            val = await self.var.evaluate_async(context)
             key = self.alias or template.name.split(".")[0]
 
-            # If the variable is array-like, render the template once for each item.
-            # `self.loop` being True indicates the render expression used "for" not
-            # "with". This distinction is not made when using the 'include' tag.
             if self.loop and isinstance(val, (tuple, list, IterableDrop)):
                 forloop = ForLoop(
                     name=key,
@@ -210,12 +308,12 @@ class RenderNode(Node):
 
                 for itm in forloop:
                     args[key] = itm
+                    if memo_key is not None:
+                        ctx.memo_key = (memo_key, forloop.index0)
                     await template.render_with_context_async(
                         ctx, buffer, partial=True, block_scope=True
                     )
             else:
-                # The bound variable is not array-like, shove it into the namespace
-                # via args.
                 args[key] = val
                 await template.render_with_context_async(
                     ctx, buffer, partial=True, block_scope=True
@@ -225,7 +323,72 @@ class RenderNode(Node):
                 ctx, buffer, partial=True, block_scope=True
             )
 
-        return None
+        return ctx.memoizable
+
+    def _memo_key(
+        self, context: Context, path: str, args: Dict[str, object], val: object
+    ) -> Optional[Hashable]:
+        """Return a memo key for rendering the named template with the given
+        arguments and bound variable, or ``None`` if any of them could change
+        between renders."""
+        values = []
+        for arg in args.values():
+            value = _memo_value(arg)
+            if value is None:
+                return None
+            values.append(value)
+
+        if self.var is not None:
+            value = _memo_value(val)
+            if value is None:
+                return None
+            values.append(value)
+
+        return (
+            context.memo_key,
+            path,
+            self.var is None,
+            self.loop,
+            self.alias,
+            tuple(args),
+            tuple(values),
+        )
+
+
+# Render arguments of these types are compared by value when memoizing output.
+MEMO_VALUE_TYPES = (str, int, float, bool, type(None))
+
+# Render arguments of exactly these types are compared by identity, as they might not
+# be hashable. Templates can't change them, so the same object will render the same
+# way for the duration of a render. Drops, including `forloop` and `tablerowloop`, and
+# other mappings and sequences can change, so partials rendered with them are not
+# memoized.
+MEMO_IDENTITY_TYPES = (list, tuple, dict)
+
+
+class _Identity:
+    """Wrap an object so it is hashed and compared by identity."""
+
+    __slots__ = ("obj",)
+
+    def __init__(self, obj: object):
+        self.obj = obj
+
+    def __hash__(self) -> int:
+        return id(self.obj)
+
+    def __eq__(self, other: object) -> bool:
+        return isinstance(other, _Identity) and other.obj is self.obj
+
+
+def _memo_value(obj: object) -> Optional[Hashable]:
+    # Include the type so `1`, `1.0` and `true`, which render differently, don't
+    # share a memo key.
+    if isinstance(obj, MEMO_VALUE_TYPES):
+        return (obj.__class__, obj)
+    if obj.__class__ in MEMO_IDENTITY_TYPES:
+        return _Identity(obj)
+    return None
 
 
 class RenderTag(Tag):
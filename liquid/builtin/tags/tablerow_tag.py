@@ -22,10 +22,8 @@ from liquid.ast import BlockNode
 
 from liquid.context import Context
 from liquid.expression import LoopExpression
-from liquid.lex import tokenize_loop_expression
 
 from liquid.parse import expect
-from liquid.parse import parse_loop_expression
 from liquid.parse import get_parser
 
 from liquid.tag import Tag
@@ -171,6 +169,11 @@ class TablerowNode(Node):
         name = self.expression.name
         loop_iter, length = self.expression.evaluate(context)
 
+        if length is None:
+            # Rows and columns need the total number of items up front.
+            items = list(loop_iter)
+            loop_iter, length = iter(items), len(items)
+
         if self.expression.cols:
             cols = self.expression.cols.evaluate(context)
             assert isinstance(cols, int)
@@ -185,7 +188,7 @@ class TablerowNode(Node):
             name: None,
         }
 
-        with context.extend(namespace):
+        with context.extend(namespace, fixed_keys=True):
             for i, row in enumerate(tablerow):
                 buffer.write(f'<tr class="row{i+1}">')
 
@@ -207,6 +210,11 @@ class TablerowNode(Node):
         name = self.expression.name
         loop_iter, length = await self.expression.evaluate_async(context)
 
+        if length is None:
+            # Rows and columns need the total number of items up front.
+            items = list(loop_iter)
+            loop_iter, length = iter(items), len(items)
+
         if self.expression.cols:
             cols = await self.expression.cols.evaluate_async(context)
             assert isinstance(cols, int)
@@ -221,7 +229,7 @@ class TablerowNode(Node):
             name: None,
         }
 
-        with context.extend(namespace):
+        with context.extend(namespace, fixed_keys=True):
             for i, row in enumerate(tablerow):
                 buffer.write(f'<tr class="row{i+1}">')
 
@@ -252,8 +260,7 @@ class TablerowTag(Tag):
         stream.next_token()
 
         expect(stream, TOKEN_EXPRESSION)
-        expr_iter = tokenize_loop_expression(stream.current.value)
-        loop_expression = parse_loop_expression(TokenStream(expr_iter))
+        loop_expression = self.env.parse_loop_expression_value(stream.current.value)
         stream.next_token()
 
         block = parser.parse_block(stream, (TAG_ENDTABLEROW,))
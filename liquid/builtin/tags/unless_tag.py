@@ -11,13 +11,11 @@ from liquid.ast import Node
 from liquid.ast import BlockNode
 
 from liquid.context import Context
-from liquid.lex import tokenize_boolean_expression
 from liquid.stream import TokenStream
 from liquid.tag import Tag
 
 from liquid.parse import get_parser
 from liquid.parse import expect
-from liquid.parse import parse_boolean_expression
 
 from liquid.token import Token
 from liquid.token import TOKEN_EOF
@@ -72,8 +70,7 @@ class UnlessTag(Tag):
 
     def parse_expression(self, stream: TokenStream) -> Expression:
         expect(stream, TOKEN_EXPRESSION)
-        expr_iter = tokenize_boolean_expression(stream.current.value)
-        return parse_boolean_expression(TokenStream(expr_iter))
+        return self.env.parse_boolean_expression_value(stream.current.value)
 
     def parse(self, stream: TokenStream) -> UnlessNode:
 
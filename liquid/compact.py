@@ -0,0 +1,89 @@
+"""An optional pass over parse trees that reduces the memory they retain.
+
+Once a template has been parsed, most of the source text held by its tokens is no
+longer needed. Compacting a parse tree replaces each node's token with one that
+keeps only what is used at render time, or to report an error: its line number, its
+type, the name of a tag and the text of a template literal. Equal tokens and equal
+template literals are shared between nodes, and between templates, and lists of
+statements are trimmed to size.
+
+Enable it by passing ``compact_trees=True`` to a new :class:`liquid.Environment`.
+"""
+from __future__ import annotations
+
+import sys
+
+from typing import Callable
+from typing import List
+from typing import TYPE_CHECKING
+
+from liquid.ast import Node
+from liquid.ast import ParseTree
+
+from liquid.builtin.literal import LiteralNode
+
+from liquid.token import Token
+from liquid.token import TOKEN_TAG
+
+if TYPE_CHECKING:  # pragma: no cover
+    from liquid import Environment
+
+
+def compact(tree: ParseTree, env: Environment) -> ParseTree:
+    """Compact the given parse tree, in place.
+
+    Nodes from custom tags, and the nodes in their blocks, are left as they are.
+    Compacting a parse tree more than once has no further effect.
+
+    :param tree: A parse tree, as returned from :meth:`liquid.Environment.parse`.
+    :type tree: liquid.ast.ParseTree
+    :param env: The environment the parse tree was parsed for. Tokens and literal
+        nodes are shared through the environment's caches.
+    :type env: liquid.Environment
+    :returns: The compacted parse tree.
+    :rtype: liquid.ast.ParseTree
+    """
+    share_token = env.share_token
+    share_literal = env.share_literal
+    stack: List[Node] = [tree]
+
+    while stack:
+        node = stack.pop()
+
+        for cls in node.__class__.__mro__:
+            for slot in getattr(cls, "__slots__", ()):
+                obj = getattr(node, slot, None)
+
+                if slot == "tok":
+                    if obj is not None:
+                        setattr(node, slot, share_token(_compact_token(obj)))
+                elif isinstance(obj, list) and all(isinstance(n, Node) for n in obj):
+                    # A slice of a list has no room to grow.
+                    statements = [_visit(n, stack, share_literal) for n in obj]
+                    setattr(node, slot, statements[:])
+                elif isinstance(obj, Node):
+                    setattr(node, slot, _visit(obj, stack, share_literal))
+
+    return tree
+
+
+def _compact_token(tok: Token) -> Token:
+    if tok.type == TOKEN_TAG:
+        # Tag names are used at render time to check for disabled tags, and all
+        # tags with the same name can share one string.
+        return Token(tok.linenum, TOKEN_TAG, sys.intern(tok.value))
+    return Token(tok.linenum, tok.type, "")
+
+
+def _visit(
+    node: Node, stack: List[Node], share_literal: Callable[[Token], LiteralNode]
+) -> Node:
+    cls = node.__class__
+
+    if cls is LiteralNode:
+        # The literal's text is the only thing it needs from its token.
+        return share_literal(node.tok)  # type: ignore
+
+    if cls.__module__.startswith(("liquid.ast", "liquid.builtin.")):
+        stack.append(node)
+    return node
@@ -0,0 +1,846 @@
+"""Compile parse trees to native Python render functions.
+
+Rather than walking a parse tree and dispatching to ``render`` and ``evaluate``
+methods for every node on every render, a :class:`CompiledBoundTemplate` generates
+Python source code for its parse tree once, and renders by calling the resulting
+function.
+
+Only built-in nodes and expressions are compiled. Any other node, like those from
+custom tags, is rendered by calling its ``render`` or ``render_async`` method from
+the generated code, so custom tags continue to work unchanged.
+"""
+from __future__ import annotations
+
+from contextlib import contextmanager
+from io import StringIO
+from itertools import count
+
+from typing import Any
+from typing import AsyncIterator
+from typing import Callable
+from typing import Collection
+from typing import Dict
+from typing import Iterator
+from typing import List
+from typing import Optional
+from typing import TextIO
+from typing import Tuple
+from typing import TYPE_CHECKING
+
+try:
+    from markupsafe import Markup
+except ImportError:
+    from liquid.exceptions import Markup  # type: ignore
+
+from liquid.ast import BlockNode
+from liquid.ast import IllegalNode
+from liquid.ast import Node
+
+from liquid.builtin.literal import LiteralNode
+from liquid.builtin.statement import LayoutContentNode
+from liquid.builtin.statement import StatementNode
+from liquid.builtin.statement import to_liquid_string
+from liquid.builtin.tags.assign_tag import AssignNode
+from liquid.builtin.tags.capture_tag import CaptureNode
+from liquid.builtin.tags.case_tag import CaseNode
+from liquid.builtin.tags.comment_tag import CommentNode
+from liquid.builtin.tags.echo_tag import EchoNode
+from liquid.builtin.tags.for_tag import BreakNode
+from liquid.builtin.tags.for_tag import ContinueNode
+from liquid.builtin.tags.for_tag import ForLoop
+from liquid.builtin.tags.for_tag import ForNode
+from liquid.builtin.tags.if_tag import IfNode
+from liquid.builtin.tags.liquid_tag import LiquidNode
+from liquid.builtin.tags.unless_tag import UnlessNode
+
+from liquid.context import Context
+
+from liquid.exceptions import BreakLoop
+from liquid.exceptions import ContinueLoop
+from liquid.exceptions import Error
+from liquid.exceptions import FilterValueError
+from liquid.exceptions import LiquidInterrupt
+from liquid.exceptions import LiquidSyntaxError
+from liquid.exceptions import NoSuchFilterFunc
+
+from liquid.output import BytesBuffer
+from liquid.output import SegmentBuffer
+
+from liquid.expression import Expression
+from liquid.expression import Nil
+from liquid.expression import Empty
+from liquid.expression import Blank
+from liquid.expression import Continue
+from liquid.expression import Literal
+from liquid.expression import Boolean
+from liquid.expression import StringLiteral
+from liquid.expression import IntegerLiteral
+from liquid.expression import FloatLiteral
+from liquid.expression import IdentifierPathElement
+from liquid.expression import Identifier
+from liquid.expression import PrefixExpression
+from liquid.expression import InfixExpression
+from liquid.expression import BooleanExpression
+from liquid.expression import FilteredExpression
+from liquid.expression import AssignmentExpression
+from liquid.expression import compare
+from liquid.expression import is_truthy
+
+from liquid.template import BoundTemplate
+from liquid.token import TOKEN_TAG
+
+if TYPE_CHECKING:  # pragma: no cover
+    from liquid.ast import ParseTree
+
+RenderFunc = Callable[[Context, TextIO, bool, bool], Any]
+
+# CPython limits the number of statically nested blocks (loops, `try` and `with`
+# statements) in a single function to 20, and the number of indentation levels to
+# 100. Nodes nested deeper than these limits are rendered by calling their `render`
+# method instead of being compiled inline.
+MAX_STATIC_BLOCKS = 12
+MAX_INDENT = 60
+
+
+def _interrupt(
+    context: Context,
+    err: LiquidInterrupt,
+    partial: bool,
+    block_scope: bool,
+    linenum: int,
+) -> None:
+    # If this is an "included" template, there could be a for loop in a parent
+    # template. Convert the interrupt to a syntax error if there is no parent.
+    if not partial or block_scope:
+        context.env.error(LiquidSyntaxError(f"unexpected '{err}'", linenum=linenum))
+    else:
+        raise err
+
+
+def _filter_error(name: str, err: Exception) -> Error:
+    return Error(f"filter '{name}': unexpected error: {err}")
+
+
+# Names available to all generated code.
+_NAMESPACE: Dict[str, object] = {
+    "_StringIO": StringIO,
+    "_BytesBuffer": BytesBuffer,
+    "_SegmentBuffer": SegmentBuffer,
+    "_Markup": Markup,
+    "_str": str,
+    "_ForLoop": ForLoop,
+    "_BreakLoop": BreakLoop,
+    "_ContinueLoop": ContinueLoop,
+    "_Error": Error,
+    "_FilterValueError": FilterValueError,
+    "_LiquidInterrupt": LiquidInterrupt,
+    "_NoSuchFilterFunc": NoSuchFilterFunc,
+    "_compare": compare,
+    "_is_truthy": is_truthy,
+    "_interrupt": _interrupt,
+    "_filter_error": _filter_error,
+    "_to_liquid_string": to_liquid_string,
+}
+
+
+class _Writer:
+    """The name of a buffer and its `write` method in generated code."""
+
+    __slots__ = ("buffer", "write")
+
+    def __init__(self, buffer: str, write: str):
+        self.buffer = buffer
+        self.write = write
+
+
+class CodeGenerator:
+    """Generate Python source code for a parse tree.
+
+    :param is_async: If ``True``, generate source for a coroutine function.
+    :type is_async: bool
+    :param stream: If ``True``, generate source for a generator function that yields
+        after rendering each top-level statement.
+    :type stream: bool
+    """
+
+    # pylint: disable=too-many-public-methods
+
+    def __init__(self, is_async: bool = False, stream: bool = False):
+        self.is_async = is_async
+        self.stream = stream
+        self.constants: Dict[str, object] = {}
+        self.lines: List[str] = []
+
+        self._indent = 0
+        self._blocks = 0
+        self._ids = count()
+
+        self._node_handlers: Dict[type, Callable[[Node, _Writer], None]] = {
+            BlockNode: self.visit_block,
+            IllegalNode: self.visit_nothing,
+            CommentNode: self.visit_nothing,
+            LiteralNode: self.visit_literal,
+            StatementNode: self.visit_statement,
+            EchoNode: self.visit_statement,
+            IfNode: self.visit_if,
+            UnlessNode: self.visit_unless,
+            CaseNode: self.visit_case,
+            ForNode: self.visit_for,
+            BreakNode: self.visit_break,
+            ContinueNode: self.visit_continue,
+            AssignNode: self.visit_assign,
+            CaptureNode: self.visit_capture,
+            LiquidNode: self.visit_liquid,
+        }
+
+    def generate(self, tree: ParseTree) -> str:
+        """Return Python source code for a function that renders the given tree."""
+        _async = "async " if self.is_async else ""
+        _get = "get_async" if self.is_async else "get"
+
+        self.emit(f"{_async}def render(context, buffer, partial, block_scope):")
+        with self.indented():
+            self.emit("env = context.env")
+            self.emit("disabled = context.disabled_tags")
+            self.emit("autoescape = context.autoescape")
+            self.emit("resolve = context.resolve")
+            self.emit(f"get = context.{_get}")
+            self.emit("get_filter = env.get_filter")
+            self.emit("assign = context.assign")
+            self.emit("extend = context.extend")
+            self.emit("write = buffer.write")
+            self.emit(
+                "write_literal = buffer.write_literal "
+                "if buffer.__class__ is _BytesBuffer else None"
+            )
+
+            out = _Writer("buffer", "write")
+
+            for node in self._merge_literals(tree.statements):
+                if isinstance(node, str):
+                    self.literal(node)
+                elif self.stream and node.__class__ is LayoutContentNode:
+                    self.layout_content(node, out)
+                else:
+                    self.top_level(node, out)
+
+                if self.stream:
+                    self.emit("yield None")
+
+            if self.stream and not tree.statements:
+                # Still a generator function.
+                self.emit("yield None")
+
+        return "\n".join(self.lines)
+
+    def top_level(self, node: Node, out: _Writer) -> None:
+        """Emit code that renders a top-level statement, handling errors and
+        interrupts."""
+        linenum = node.token().linenum
+        with self.block("try:"):
+            self.visit(node, out)
+        with self.block("except _LiquidInterrupt as err:"):
+            self.emit(f"_interrupt(context, err, partial, block_scope, {linenum})")
+        with self.block("except _Error as err:"):
+            self.emit(f"env.error(err, linenum={linenum})")
+
+    def layout_content(self, node: Node, out: _Writer) -> None:
+        """Emit code that streams a top-level ``{{ content_for_layout }}``, asking for
+        output to be flushed first. See `BoundTemplate.render_statements`."""
+        assert isinstance(node, LayoutContentNode)
+        content = self.tmp()
+        self.emit(f"{content} = {self.const(node)}.content(context)")
+
+        with self.block(f"if {content} is not None:"):
+            self.emit("yield True")
+            if self.is_async:
+                flush = self.tmp("_f")
+                with self.block(
+                    f"async for {flush} in "
+                    f"{content}.render_statements_async(context, buffer):"
+                ):
+                    self.emit(f"yield {flush}")
+            else:
+                self.emit(f"yield from {content}.render_statements(context, buffer)")
+
+        with self.block("else:"):
+            self.top_level(node, out)
+
+    def literal(self, text: str) -> None:
+        """Emit code that writes top-level literal template text to the output buffer,
+        pre-encoded if it is long and the buffer is a `BytesBuffer`."""
+        data = text.encode("utf-8")
+        if len(data) < BytesBuffer.literal_threshold:
+            self.emit(f"write({self.const(text)})")
+        else:
+            self.emit(
+                f"write_literal({self.const(text)}, {self.const(data)}) "
+                f"if write_literal else write({self.const(text)})"
+            )
+
+    def emit(self, line: str) -> None:
+        """Append a line of code at the current indentation level."""
+        self.lines.append("    " * self._indent + line)
+
+    @contextmanager
+    def indented(self) -> Iterator[None]:
+        """Indent lines emitted within the context manager."""
+        self._indent += 1
+        try:
+            yield
+        finally:
+            self._indent -= 1
+
+    @contextmanager
+    def block(self, line: str) -> Iterator[None]:
+        """Emit a compound statement header and indent its body. This counts towards
+        the limit of statically nested blocks. An empty body is a syntax error, so
+        we emit `pass` if nothing else was emitted."""
+        self.emit(line)
+        start = len(self.lines)
+        self._blocks += 1
+        self._indent += 1
+        try:
+            yield
+            if len(self.lines) == start:
+                self.emit("pass")
+        finally:
+            self._indent -= 1
+            self._blocks -= 1
+
+    def const(self, obj: object) -> str:
+        """Return the name of a new constant referencing `obj`."""
+        if isinstance(obj, (str, int)) and type(obj) in (str, int):
+            return repr(obj)
+        name = f"_k{next(self._ids)}"
+        self.constants[name] = obj
+        return name
+
+    def tmp(self, prefix: str = "_v") -> str:
+        """Return a new, unique, local variable name."""
+        return f"{prefix}{next(self._ids)}"
+
+    def await_(self, src: str) -> str:
+        """Await `src` if we're generating a coroutine function."""
+        if self.is_async:
+            return f"(await {src})"
+        return src
+
+    # Nodes
+
+    def visit(self, node: Node, out: _Writer) -> None:
+        """Emit code that renders `node` to `out`."""
+        handler = self._node_handlers.get(node.__class__)
+        if (
+            handler is None
+            or self._blocks >= MAX_STATIC_BLOCKS
+            or self._indent >= MAX_INDENT
+        ):
+            self.visit_fallback(node, out)
+            return
+
+        if node.token().type == TOKEN_TAG:
+            self.emit(f"if disabled: {self.const(node)}.raise_for_disabled(disabled)")
+
+        handler(node, out)
+
+    def visit_fallback(self, node: Node, out: _Writer) -> None:
+        """Emit code that delegates rendering to the node itself."""
+        if self.is_async:
+            self.emit(f"await {self.const(node)}.render_async(context, {out.buffer})")
+        else:
+            self.emit(f"{self.const(node)}.render(context, {out.buffer})")
+
+    def visit_nothing(self, node: Node, out: _Writer) -> None:
+        """Nodes that don't render anything."""
+
+    def visit_literal(self, node: Node, out: _Writer) -> None:
+        """Emit code that writes literal template text."""
+        assert isinstance(node, LiteralNode)
+        self.emit(f"{out.write}({self.const(node.tok.value)})")
+
+    def visit_block(self, node: Node, out: _Writer) -> None:
+        """Emit code that renders a block to an intermediate buffer, suppressing
+        output that contains only whitespace."""
+        assert isinstance(node, BlockNode)
+        statements = list(self._merge_literals(node.statements))
+
+        if all(isinstance(stmt, str) for stmt in statements):
+            # A block of literal text only. We can check for whitespace now.
+            text = "".join(statements)  # type: ignore
+            if text and not text.isspace():
+                self.emit(f"{out.write}({self.const(text)})")
+            return
+
+        buf = self.tmp("_b")
+        write = self.tmp("_w")
+        val = self.tmp("_s")
+
+        self.emit(f"{buf} = _StringIO()")
+        self.emit(f"{write} = {buf}.write")
+
+        inner = _Writer(buf, write)
+
+        for stmt in statements:
+            if isinstance(stmt, str):
+                self.emit(f"{write}({self.const(stmt)})")
+                continue
+
+            with self.block("try:"):
+                self.visit(stmt, inner)
+            with self.block("except _Error as err:"):
+                # Maybe resume rendering the block after an error.
+                self.emit("context.error(err)")
+            with self.block("except Exception:"):
+                # Write what we have so far and stop rendering the block.
+                self._write_unless_whitespace(buf, val, out)
+                self.emit("raise")
+
+        self._write_unless_whitespace(buf, val, out)
+
+    def _write_unless_whitespace(self, buf: str, val: str, out: _Writer) -> None:
+        self.emit(f"{val} = {buf}.getvalue()")
+        self.emit(f"if not {val}.isspace(): {out.write}({val})")
+
+    def visit_statement(self, node: Node, out: _Writer) -> None:
+        """Emit code for an output statement or `echo` tag."""
+        assert isinstance(node, StatementNode)
+        expr = node.expression
+        if expr.__class__ is FilteredExpression and not expr.filters:  # type: ignore
+            expr = expr.expression  # type: ignore
+
+        # String literals from template source are trusted, and numbers never need
+        # escaping, so their output is known before rendering.
+        if expr.__class__ in (StringLiteral, IntegerLiteral, FloatLiteral):
+            self.emit(f"{out.write}({self.const(str(expr.value))})")  # type: ignore
+            return
+
+        val = self.tmp()
+        self.filtered(node.expression, val)
+        self.emit(
+            f"{out.write}({val} if {val}.__class__ is _str and not autoescape "
+            f"or {val}.__class__ is _Markup "
+            f"else _to_liquid_string({val}, autoescape))"
+        )
+
+    def visit_assign(self, node: Node, out: _Writer) -> None:
+        """Emit code for the `assign` tag."""
+        assert isinstance(node, AssignNode)
+        expr = node.expression
+
+        if not isinstance(expr, AssignmentExpression):
+            self.emit(self.await_(f"{self.const(expr)}.evaluate(context)"))
+            return
+
+        val = self.tmp()
+        self.filtered(expr.expression, val)
+        self.emit(f"assign({self.const(expr.name)}, {val})")
+
+    def visit_capture(self, node: Node, out: _Writer) -> None:
+        """Emit code for the `capture` tag."""
+        assert isinstance(node, CaptureNode)
+        buf = self.tmp("_c")
+        self.emit(f"{buf} = _SegmentBuffer()")
+        self.visit(node.block, _Writer(buf, f"{buf}.write"))
+        self.emit(
+            f"assign({self.const(node.name)}, _Markup({buf}.getvalue()) "
+            f"if autoescape else {buf}.getvalue())"
+        )
+
+    def visit_liquid(self, node: Node, out: _Writer) -> None:
+        """Emit code for the `liquid` tag."""
+        assert isinstance(node, LiquidNode)
+        self.visit(node.block, out)
+
+    def visit_if(self, node: Node, out: _Writer) -> None:
+        """Emit code for the `if` tag."""
+        assert isinstance(node, IfNode)
+        if self._has_tag_alternatives(node.conditional_alternatives):
+            self.visit_fallback(node, out)
+            return
+
+        with self.indented_block(f"if {self.expr(node.condition)}:"):
+            self.visit(node.consequence, out)
+
+        for alt in node.conditional_alternatives:
+            with self.indented_block(f"elif {self.expr(alt.condition)}:"):
+                self.visit(alt.block, out)
+
+        if node.alternative:
+            with self.indented_block("else:"):
+                self.visit(node.alternative, out)
+
+    def visit_unless(self, node: Node, out: _Writer) -> None:
+        """Emit code for the `unless` tag."""
+        assert isinstance(node, UnlessNode)
+        with self.indented_block(f"if not {self.expr(node.condition)}:"):
+            self.visit(node.consequence, out)
+
+    def visit_case(self, node: Node, out: _Writer) -> None:
+        """Emit code for the `case` tag."""
+        assert isinstance(node, CaseNode)
+        if self._has_tag_alternatives(node.whens):
+            self.visit_fallback(node, out)
+            return
+
+        keyword = "if"
+
+        for when in node.whens:
+            with self.indented_block(f"{keyword} {self.expr(when.condition)}:"):
+                self.visit(when.block, out)
+            keyword = "elif"
+
+        if node.default:
+            if node.whens:
+                with self.indented_block("else:"):
+                    self.visit(node.default, out)
+            else:
+                self.visit(node.default, out)
+
+    def visit_for(self, node: Node, out: _Writer) -> None:
+        """Emit code for the `for` tag."""
+        assert isinstance(node, ForNode)
+        loop = self.tmp("_l")
+        length = self.tmp("_n")
+        forloop = self.tmp("_f")
+        namespace = self.tmp("_ns")
+        item = self.tmp("_i")
+
+        expr = self.const(node.expression)
+        name = self.const(node.expression.name)
+        evaluate = "evaluate_async" if self.is_async else "evaluate"
+
+        self.emit(f"{loop}, {length} = {self.await_(f'{expr}.{evaluate}(context)')}")
+
+        with self.indented_block(f"if {length} != 0:"):
+            if node.uses_forloop:
+                self.emit(f"{forloop} = _ForLoop({name}, {loop}, {length})")
+                self.emit(f"{namespace} = {{'forloop': {forloop}, {name}: None}}")
+                self.emit(f"{loop} = {forloop}")
+            else:
+                self.emit(f"{namespace} = {{{name}: None}}")
+            with self.block(f"with extend({namespace}):"):
+                with self.block(f"for {item} in {loop}:"):
+                    self.emit(f"{namespace}[{name}] = {item}")
+                    with self.block("try:"):
+                        self.visit(node.block, out)
+                    with self.block("except _ContinueLoop:"):
+                        self.emit("continue")
+                    with self.block("except _BreakLoop:"):
+                        self.emit("break")
+
+        if node.default:
+            with self.indented_block("else:"):
+                self.visit(node.default, out)
+
+    def visit_break(self, node: Node, out: _Writer) -> None:
+        """Emit code for the `break` tag."""
+        self.emit("raise _BreakLoop('break')")
+
+    def visit_continue(self, node: Node, out: _Writer) -> None:
+        """Emit code for the `continue` tag."""
+        self.emit("raise _ContinueLoop('continue')")
+
+    @contextmanager
+    def indented_block(self, line: str) -> Iterator[None]:
+        """Emit a statement header that does not count towards the limit of
+        statically nested blocks, like `if` and `else`, and indent its body."""
+        self.emit(line)
+        start = len(self.lines)
+        with self.indented():
+            yield
+            if len(self.lines) == start:
+                self.emit("pass")
+
+    @staticmethod
+    def _has_tag_alternatives(alternatives: Collection[Node]) -> bool:
+        # Conditional blocks check for disabled tags before evaluating their
+        # condition, which we can't do between `elif` clauses. The built-in tags
+        # never start a conditional block with a tag token.
+        return any(alt.token().type == TOKEN_TAG for alt in alternatives)
+
+    @staticmethod
+    def _merge_literals(statements: Collection[Node]) -> Iterator[Any]:
+        """Yield nodes from `statements`, replacing runs of literal nodes with a
+        single string."""
+        text: List[str] = []
+        for node in statements:
+            if node.__class__ is LiteralNode:
+                text.append(node.tok.value)  # type: ignore
+                continue
+            if text:
+                yield "".join(text)
+                text = []
+            yield node
+        if text:
+            yield "".join(text)
+
+    # Expressions
+
+    def filtered(self, expr: Expression, target: str) -> None:
+        """Emit code that assigns the result of evaluating `expr`, a filtered
+        expression, to the local variable `target`."""
+        if expr.__class__ is not FilteredExpression:
+            self.emit(f"{target} = {self.expr(expr)}")
+            return
+
+        assert isinstance(expr, FilteredExpression)
+        self.emit(f"{target} = {self.expr(expr.expression)}")
+
+        for fltr in expr.filters:
+            bound = self.tmp("_fn")
+            name = self.const(fltr.name)
+
+            with self.block("try:"):
+                self.emit(f"{bound} = get_filter({name})")
+            with self.block("except _NoSuchFilterFunc:"):
+                self.emit("if env.strict_filters: raise")
+                self.emit(f"{bound} = None")
+
+            args = [target, *(self.expr(arg) for arg in fltr.args)]
+            kwargs = [
+                f"{self.const(key)}: {self.expr(val)}"
+                for key, val in fltr.kwargs.items()
+            ]
+
+            memo_args = "".join(f"{arg}, " for arg in args[1:])
+            call_memoized = (
+                f"context.call_memoized({bound}, {target}, ({memo_args}), "
+                f"{{{', '.join(kwargs)}}})"
+            )
+
+            if kwargs:
+                call = ", ".join([*args, f"**{{{', '.join(kwargs)}}}"])
+                call_with_context = ", ".join(
+                    [*args, f"**{{{', '.join(kwargs)}, 'context': context}}"]
+                )
+            else:
+                call = ", ".join(args)
+                call_with_context = ", ".join([*args, "context=context"])
+
+            # Any exception causes us to abort the filter chain and discard the
+            # result. Nothing will be rendered.
+            with self.indented_block(f"if {bound} is not None:"):
+                with self.block("try:"):
+                    with self.indented_block(f"if {bound}.with_context:"):
+                        self.emit(f"{target} = {bound}.func({call_with_context})")
+                    with self.indented_block(f"elif {bound}.memoize:"):
+                        self.emit(f"{target} = {call_memoized}")
+                    with self.indented_block("else:"):
+                        self.emit(f"{target} = {bound}.func({call})")
+                with self.block("except _FilterValueError:"):
+                    self.emit("pass")
+                with self.block("except _Error:"):
+                    self.emit("raise")
+                with self.block("except Exception as err:"):
+                    self.emit(f"raise _filter_error({name}, err) from err")
+
+    def expr(self, expr: Expression) -> str:
+        """Return a Python expression that evaluates `expr`."""
+        # pylint: disable=too-many-return-statements
+        cls = expr.__class__
+
+        if cls is Nil:
+            return "None"
+        if cls is Continue:
+            return "0"
+        if cls in (Empty, Blank):
+            return self.const(expr)
+        if cls is Boolean:
+            return repr(expr.value)  # type: ignore
+        if cls is StringLiteral:
+            val = self.const(expr.value)  # type: ignore
+            return f"(_Markup({val}) if autoescape else {val})"
+        if cls in (IntegerLiteral, FloatLiteral, IdentifierPathElement, Literal):
+            return self.const(expr.value)  # type: ignore
+        if cls is Identifier:
+            return self.identifier(expr)  # type: ignore
+        if cls is PrefixExpression:
+            assert isinstance(expr, PrefixExpression)
+            return f"{self.const(expr)}._evaluate({self.expr(expr.right)})"
+        if cls is InfixExpression:
+            assert isinstance(expr, InfixExpression)
+            return (
+                f"_compare({self.expr(expr.left)}, "
+                f"{expr.operator!r}, {self.expr(expr.right)})"
+            )
+        if cls is BooleanExpression:
+            assert isinstance(expr, BooleanExpression)
+            return f"_is_truthy({self.expr(expr.expression)})"
+        if cls is FilteredExpression and not expr.filters:  # type: ignore
+            return self.expr(expr.expression)  # type: ignore
+
+        evaluate = "evaluate_async" if self.is_async else "evaluate"
+        return self.await_(f"{self.const(expr)}.{evaluate}(context)")
+
+    def identifier(self, expr: Identifier) -> str:
+        """Return a Python expression that resolves an identifier."""
+        path = expr.path
+
+        if all(elem.__class__ is IdentifierPathElement for elem in path):
+            if len(path) == 1:
+                # Context.get does exactly this with a single element path.
+                return f"resolve({self.const(path[0].value)})"
+            if expr.resolver is not None and not self.is_async:
+                return f"{self.const(expr.resolver)}(context)"
+            return self.await_(
+                f"get({self.const(tuple(elem.value for elem in path))})"
+            )
+
+        elems = ", ".join(self.expr(elem) for elem in path)
+        return self.await_(f"get([{elems}])")
+
+
+def generate_source(
+    tree: ParseTree, is_async: bool = False, stream: bool = False
+) -> str:
+    """Return Python source code for a function that renders the given parse tree."""
+    return CodeGenerator(is_async, stream).generate(tree)
+
+
+def compile_tree(
+    tree: ParseTree, is_async: bool = False, stream: bool = False, name: str = ""
+) -> RenderFunc:
+    """Compile the given parse tree to a Python function.
+
+    The resulting function accepts a render context, an output buffer and the
+    ``partial`` and ``block_scope`` flags from
+    :meth:`liquid.template.BoundTemplate.render_with_context`. If ``is_async`` is
+    ``True``, the resulting function is a coroutine function. If ``stream`` is
+    ``True``, the resulting function is a generator, or async generator, that yields
+    after rendering each top-level statement.
+    """
+    generator = CodeGenerator(is_async, stream)
+    source = generator.generate(tree)
+    namespace = {**_NAMESPACE, **generator.constants}
+    code = compile(source, f"<liquid template {name!r}>", "exec")
+    exec(code, namespace)  # pylint: disable=exec-used
+    func: RenderFunc = namespace["render"]  # type: ignore
+    return func
+
+
+class CompiledBoundTemplate(BoundTemplate):
+    """A :class:`liquid.template.BoundTemplate` that compiles its parse tree to a
+    native Python function the first time it is rendered.
+
+    Use it by setting the ``template_class`` attribute of an
+    :class:`liquid.Environment`.
+
+    .. code-block:: python
+
+        from liquid import Environment
+        from liquid.compiler import CompiledBoundTemplate
+
+        env = Environment()
+        env.template_class = CompiledBoundTemplate
+    """
+
+    def __init__(self, *args: Any, **kwargs: Any) -> None:
+        super().__init__(*args, **kwargs)
+        # Compiled functions keyed by `is_async` and `stream` flags.
+        self._funcs: Dict[Tuple[bool, bool], RenderFunc] = {}
+
+    def compiled(self, is_async: bool = False, stream: bool = False) -> RenderFunc:
+        """Return this template compiled to a Python function, compiling it if it
+        has not been compiled before. See :func:`compile_tree`."""
+        try:
+            return self._funcs[(is_async, stream)]
+        except KeyError:
+            func = compile_tree(
+                self.tree, is_async=is_async, stream=stream, name=self.name
+            )
+            self._funcs[(is_async, stream)] = func
+            return func
+
+    @property
+    def render_func(self) -> RenderFunc:
+        """This template's compiled render function."""
+        return self.compiled()
+
+    @property
+    def render_func_async(self) -> RenderFunc:
+        """This template's compiled render coroutine function."""
+        return self.compiled(is_async=True)
+
+    def render_with_context(
+        self,
+        context: Context,
+        buffer: TextIO,
+        *args: Any,
+        partial: bool = False,
+        block_scope: bool = False,
+        **kwargs: Any,
+    ) -> None:
+        namespace = self._make_globals(partial, args, kwargs)
+        with context.extend(namespace=namespace, fixed_keys=True):
+            self.render_func(context, buffer, partial, block_scope)
+
+    async def render_with_context_async(
+        self,
+        context: Context,
+        buffer: TextIO,
+        *args: Any,
+        partial: bool = False,
+        block_scope: bool = False,
+        **kwargs: Any,
+    ) -> None:
+        if context.prefetcher is not None:
+            # Render one statement at a time, so we can start lookups for upcoming
+            # statements in between.
+            await super().render_with_context_async(
+                context,
+                buffer,
+                *args,
+                partial=partial,
+                block_scope=block_scope,
+                **kwargs,
+            )
+            return
+
+        namespace = self._make_globals(partial, args, kwargs)
+        with context.extend(namespace=namespace, fixed_keys=True):
+            await self.render_func_async(context, buffer, partial, block_scope)
+
+    def render_statements(
+        self,
+        context: Context,
+        buffer: TextIO,
+        partial: bool = False,
+        block_scope: bool = False,
+    ) -> Iterator[Optional[bool]]:
+        func = self.compiled(stream=True)
+        yield from func(context, buffer, partial, block_scope)
+
+    async def render_statements_async(
+        self,
+        context: Context,
+        buffer: TextIO,
+        partial: bool = False,
+        block_scope: bool = False,
+    ) -> AsyncIterator[Optional[bool]]:
+        func = self.compiled(is_async=True, stream=True)
+        prefetcher = context.prefetcher
+
+        if prefetcher is None:
+            async for flush in func(context, buffer, partial, block_scope):
+                yield flush
+            return
+
+        # Adjacent literals are compiled into one statement, so `index` can fall behind
+        # the statement being rendered. Literals don't have any lookups.
+        lookups = self.chained_lookups()
+        prefetcher.start(context, lookups, 0)
+        index = 0
+        async for flush in func(context, buffer, partial, block_scope):
+            if flush is None:
+                index += 1
+                prefetcher.start(context, lookups, index)
+            yield flush
+
+
+__all__: Tuple[str, ...] = (
+    "CodeGenerator",
+    "CompiledBoundTemplate",
+    "compile_tree",
+    "generate_source",
+)
@@ -2,26 +2,32 @@
 
 from __future__ import annotations
 
+import asyncio
 import collections.abc
 import datetime
 import functools
 import itertools
 import warnings
 
+from collections import ChainMap
 from collections import deque
 from contextlib import contextmanager
 from itertools import cycle
 from operator import getitem
 
 from typing import Any
+from typing import Awaitable
 from typing import Callable
 from typing import Dict
+from typing import Hashable
 from typing import Iterable
 from typing import Iterator
 from typing import List
 from typing import Mapping
 from typing import Optional
 from typing import Sequence
+from typing import Set
+from typing import Tuple
 from typing import Union
 from typing import TYPE_CHECKING
 
@@ -35,6 +41,7 @@ from liquid import Mode
 
 if TYPE_CHECKING:  # pragma: no cover
     from liquid import Environment
+    from liquid.filter import BoundFilter
     from liquid.template import BoundTemplate
 
 # Maximum number of times a context can be extended or wrapped.
@@ -42,10 +49,23 @@ MAX_CONTEXT_DEPTH = 30
 
 ContextPath = Union[str, Sequence[Union[str, int]]]
 Namespace = Mapping[str, object]
+Resolver = Callable[["Context"], object]
+
+# A variable name and the keys of a chained lookup, like `product.title`.
+Lookup = Tuple[str, Tuple[Union[str, int], ...]]
+
+# Filter argument types that can be part of a filter memo key.
+FILTER_MEMO_TYPES = (str, int, float, bool, type(None))
 
 
 _undefined = object()
 
+# Returned from lookups that didn't find a key, in place of raising an exception.
+_missing = object()
+
+# Objects of these types never have a string key, like `product.title`.
+_NO_STRING_KEYS = frozenset((str, list, tuple, int, float, bool, type(None)))
+
 
 def _getitem(obj: Union[Mapping[Any, Any], Sequence[Any]], key: Any) -> object:
     """Item getter with special methods for arrays/lists and hashes/dicts."""
@@ -82,6 +102,194 @@ async def _getitem_async(obj: Any, key: Any) -> object:
     return getitem(obj, key)
 
 
+def _lookup(obj: Any, key: Any) -> object:
+    """Like `_getitem`, but return `_missing` if `key` is not in `obj`, rather than
+    raising an exception. Looking up a missing key in a dictionary never raises."""
+    if obj.__class__ is dict and (
+        (key.__class__ is str and key != "size") or key.__class__ is int
+    ):
+        return obj.get(key, _missing)
+
+    if key.__class__ is str and key not in ("size", "first", "last"):
+        if obj.__class__ in _NO_STRING_KEYS:
+            return _missing
+
+    try:
+        return _getitem(obj, key)
+    except (KeyError, IndexError, TypeError):
+        return _missing
+
+
+def _key_getter(key: Union[str, int]) -> Callable[[Any], object]:
+    """Return a function that gets the constant `key` from an object, with the same
+    semantics as `_getitem`, returning `_missing` if the key does not exist."""
+    errors = (KeyError, IndexError, TypeError)
+
+    if key == "size":
+
+        def get_size(obj: Any) -> object:
+            if isinstance(obj, collections.abc.Sized):
+                return len(obj)
+            try:
+                return getitem(obj, key)
+            except errors:
+                return _missing
+
+        return get_size
+
+    if key in ("first", "last"):
+        index = 0 if key == "first" else -1
+
+        def get_end(obj: Any) -> object:
+            if obj.__class__ is dict:
+                return obj.get(key, _missing)
+            try:
+                if isinstance(obj, collections.abc.Sequence):
+                    return obj[index] if obj else _missing
+                return getitem(obj, key)
+            except errors:
+                return _missing
+
+        return get_end
+
+    # A plain mapping key or sequence index. Resolvers look up plain keys in
+    # dictionaries themselves.
+    string_key = isinstance(key, str)
+
+    def get_key(obj: Any) -> object:
+        if string_key and obj.__class__ in _NO_STRING_KEYS:
+            return _missing
+        try:
+            return getitem(obj, key)
+        except errors:
+            return _missing
+
+    return get_key
+
+
+def make_resolver(name: str, keys: Sequence[Union[str, int]]) -> Resolver:
+    """Return a function that resolves the path `name` followed by `keys` from a
+    render context, equivalent to ``context.get([name, *keys])``.
+
+    Special keys, like ``size`` and ``first``, are classified in advance and short
+    paths are unrolled, so resolving a variable doesn't need to inspect each key.
+    Plain keys are looked up in dictionaries without a function call, and a missing
+    key never raises an exception.
+    """
+    getters = tuple(_key_getter(key) for key in keys)
+
+    # Keys that can be looked up in a dictionary with `dict.get`.
+    plain = tuple(key not in ("size", "first", "last") for key in keys)
+
+    missing = _missing
+    _dict = dict
+    dict_get = dict.get
+
+    if not getters:
+
+        def resolve0(context: Context) -> object:
+            return context.resolve(name)
+
+        return resolve0
+
+    if len(getters) == 1:
+        (get0,) = getters
+        (key0,) = keys
+        (plain0,) = plain
+
+        def resolve1(context: Context) -> object:
+            obj = context.resolve(name)
+
+            if plain0 and obj.__class__ is _dict:
+                obj = dict_get(obj, key0, missing)
+            else:
+                obj = get0(obj)
+
+            if obj is missing:
+                return context.undefined(name)
+            return obj
+
+        return resolve1
+
+    if len(getters) == 2:
+        get0, get1 = getters
+        key0, key1 = keys
+        plain0, plain1 = plain
+
+        def resolve2(context: Context) -> object:
+            obj = context.resolve(name)
+
+            if plain0 and obj.__class__ is _dict:
+                obj = dict_get(obj, key0, missing)
+            else:
+                obj = get0(obj)
+
+            if obj is missing:
+                return context.undefined(name)
+
+            if plain1 and obj.__class__ is _dict:
+                obj = dict_get(obj, key1, missing)
+            else:
+                obj = get1(obj)
+
+            if obj is missing:
+                return context.undefined(name)
+            return obj
+
+        return resolve2
+
+    if len(getters) == 3:
+        get0, get1, get2 = getters
+        key0, key1, key2 = keys
+        plain0, plain1, plain2 = plain
+
+        def resolve3(context: Context) -> object:
+            obj = context.resolve(name)
+
+            if plain0 and obj.__class__ is _dict:
+                obj = dict_get(obj, key0, missing)
+            else:
+                obj = get0(obj)
+
+            if obj is missing:
+                return context.undefined(name)
+
+            if plain1 and obj.__class__ is _dict:
+                obj = dict_get(obj, key1, missing)
+            else:
+                obj = get1(obj)
+
+            if obj is missing:
+                return context.undefined(name)
+
+            if plain2 and obj.__class__ is _dict:
+                obj = dict_get(obj, key2, missing)
+            else:
+                obj = get2(obj)
+
+            if obj is missing:
+                return context.undefined(name)
+            return obj
+
+        return resolve3
+
+    steps = tuple(zip(keys, plain, getters))
+
+    def resolve(context: Context) -> object:
+        obj = context.resolve(name)
+        for key, _plain, get in steps:
+            if _plain and obj.__class__ is _dict:
+                obj = dict_get(obj, key, missing)
+            else:
+                obj = get(obj)
+
+            if obj is missing:
+                return context.undefined(name)
+        return obj
+
+    return resolve
+
+
 def get_item(
     obj: Sequence[Any],
     *items: Any,
@@ -100,6 +308,26 @@ def is_undefined(obj: object) -> bool:
     return isinstance(obj, Undefined)
 
 
+def _get(mapping: Mapping[str, object], key: str) -> object:
+    """Return the value of `key` in `mapping`, or `_missing` if `mapping` does not
+    contain `key`."""
+    cls = mapping.__class__
+    if cls is dict or cls is ReadOnlyChainMap or cls is BuiltIn:
+        return mapping.get(key, _missing)
+
+    if cls is ChainMap:
+        for _mapping in mapping.maps:  # type: ignore
+            obj = _get(_mapping, key)
+            if obj is not _missing:
+                return obj
+        return _missing
+
+    try:
+        return mapping[key]
+    except KeyError:
+        return _missing
+
+
 class ReadOnlyChainMap(Mapping[str, object]):
     """Combine multiple mappings for sequential lookup.
 
@@ -130,10 +358,11 @@ class ReadOnlyChainMap(Mapping[str, object]):
         return len(self._maps)
 
     def get(self, key: str, default: object = None) -> object:
-        try:
-            return self[key]
-        except KeyError:
-            return default
+        for mapping in self._maps:
+            obj = _get(mapping, key)
+            if obj is not _missing:
+                return obj
+        return default
 
     def push(self, namespace: Mapping[Any, Any]) -> None:
         """Add a mapping to the front of the chain map."""
@@ -144,6 +373,150 @@ class ReadOnlyChainMap(Mapping[str, object]):
         return self._maps.popleft()
 
 
+class Scope(Mapping[str, object]):
+    """A stack of namespaces with a fixed set of base namespaces underneath, as used
+    for the scope of a render context.
+
+    Pushed namespaces are searched in order, most recently pushed first, like a chain
+    map. Dictionaries pushed with ``fixed_keys=True``, as built-in tags do, promise not
+    to gain or lose keys while they are pushed, so their keys are indexed instead. While
+    every pushed namespace is indexed, looking up a name in a pushed namespace, or a
+    name that is not in any pushed namespace, costs the same regardless of how many
+    namespaces have been pushed.
+
+    :param base: Namespaces to search, in order, after searching pushed namespaces.
+    """
+
+    __slots__ = ("_base", "_frames", "_index", "_shadowed", "_unindexed")
+
+    def __init__(self, *base: Mapping[str, object]):
+        self._base = base
+
+        # Pushed namespaces, most recently pushed last.
+        self._frames: List[Mapping[str, object]] = []
+
+        # The most recently pushed dictionary for each key in a pushed dictionary.
+        self._index: Dict[str, Mapping[str, object]] = {}
+
+        # Index entries replaced by each push, restored on pop, or None for pushed
+        # namespaces that are not indexed.
+        self._shadowed: List[Optional[List[Any]]] = []
+
+        # The number of pushed namespaces that are not in the index.
+        self._unindexed = 0
+
+    def __getitem__(self, key: str) -> object:
+        if self._unindexed:
+            return self._search(key)
+
+        frame = self._index.get(key)
+        if frame is not None:
+            try:
+                return frame[key]
+            except KeyError:
+                # The key was removed after the namespace was pushed.
+                return self._search(key)
+
+        for mapping in self._base:
+            try:
+                return mapping[key]
+            except KeyError:
+                pass
+        raise KeyError(key)
+
+    def get(self, key: str, default: object = None) -> object:
+        """Return the value of `key` in the first namespace that contains it, or
+        `default` if no namespace contains `key`. Unlike `__getitem__`, a missing key
+        does not raise an exception if all namespaces are dictionaries."""
+        if self._unindexed:
+            try:
+                return self._search(key)
+            except KeyError:
+                return default
+
+        frame = self._index.get(key)
+        if frame is not None:
+            obj = frame.get(key, _missing)
+            if obj is not _missing:
+                return obj
+            # The key was removed after the namespace was pushed.
+            try:
+                return self._search(key)
+            except KeyError:
+                return default
+
+        for mapping in self._base:
+            if mapping.__class__ is dict:
+                obj = mapping.get(key, _missing)
+            else:
+                obj = _get(mapping, key)
+            if obj is not _missing:
+                return obj
+        return default
+
+    def _search(self, key: str) -> object:
+        for mapping in reversed(self._frames):
+            try:
+                return mapping[key]
+            except KeyError:
+                pass
+
+        for mapping in self._base:
+            try:
+                return mapping[key]
+            except KeyError:
+                pass
+        raise KeyError(key)
+
+    def __iter__(self) -> Iterator[str]:
+        return itertools.chain(*reversed(self._frames), *self._base)
+
+    def __len__(self) -> int:
+        return sum(len(map) for map in itertools.chain(self._frames, self._base))
+
+    def size(self) -> int:
+        """Return the number of namespaces in the scope."""
+        return len(self._frames) + len(self._base)
+
+    def push(self, namespace: Mapping[str, object], fixed_keys: bool = False) -> None:
+        """Push a namespace on to the scope. Names in the pushed namespace take
+        priority over all other namespaces.
+
+        :param namespace: The namespace to push.
+        :param fixed_keys: If ``True`` and ``namespace`` is a dictionary, keys will not
+            be added to or removed from ``namespace`` until it is popped, so its keys
+            can be indexed. Defaults to ``False``.
+        """
+        self._frames.append(namespace)
+
+        if fixed_keys and isinstance(namespace, dict):
+            index = self._index
+            shadowed = [(key, index.get(key)) for key in namespace]
+            for key in namespace:
+                index[key] = namespace
+            self._shadowed.append(shadowed)
+        else:
+            self._shadowed.append(None)
+            self._unindexed += 1
+
+    def pop(self) -> Mapping[str, object]:
+        """Remove the most recently pushed namespace from the scope."""
+        namespace = self._frames.pop()
+        shadowed = self._shadowed.pop()
+
+        if shadowed is not None:
+            index = self._index
+            for key, frame in reversed(shadowed):
+                if frame is None:
+                    del index[key]
+                else:
+                    index[key] = frame
+        else:
+            self._unindexed -= 1
+
+        return namespace
+
+
 class BuiltIn(Mapping[str, object]):
     """Mapping-like object for resolving built-in, dynamic objects."""
 
@@ -159,6 +532,11 @@ class BuiltIn(Mapping[str, object]):
             return datetime.date.today()
         raise KeyError(str(key))
 
+    def get(self, key: str, default: object = None) -> object:
+        if key in ("now", "today"):
+            return self[key]
+        return default
+
     def __len__(self) -> int:
         return 2
 
@@ -212,6 +590,11 @@ class Undefined(Mapping[Any, object]):
         return []
 
 
+@functools.lru_cache(maxsize=1024)
+def _shared_undefined(name: str) -> Undefined:
+    return Undefined(name)
+
+
 class DebugUndefined(Undefined):
     """An undefined that returns debug information when rendered."""
 
@@ -272,6 +655,140 @@ class StrictUndefined(Undefined):
         raise UndefinedError(f"'{self.name}' is undefined")
 
 
+class Prefetcher:
+    """Start async drop lookups for upcoming statements concurrently, while earlier
+    statements are still being rendered.
+
+    Each ``__getitem_async__`` call is made at most once per object and key, and is
+    shared by a prefetched lookup and the lookup made by the statement that uses it.
+    Objects are compared by identity, so a variable that has been reassigned since
+    its lookup was started is looked up again.
+
+    Lookups are speculative. Lookups for statements in ``if``, ``unless`` and ``case``
+    branches are started whether or not the branch is rendered. Before the first async
+    drop in a path, only mappings are followed; a path through any other object, like
+    a drop without ``__getitem_async__``, is left until its statement is rendered, so
+    its ``__getitem__`` is not called ahead of time.
+
+    :param lookahead: The number of top-level statements, after the one being
+        rendered, to start lookups for.
+    :type lookahead: int
+    :param limit: The maximum number of ``__getitem_async__`` calls awaited at the
+        same time.
+    :type limit: int
+    """
+
+    __slots__ = ("lookahead", "limit", "_semaphore", "_lookups", "_tasks")
+
+    def __init__(self, lookahead: int, limit: int):
+        self.lookahead = lookahead
+        self.limit = limit
+
+        # Created when the first lookup starts, so that it belongs to the running
+        # event loop.
+        self._semaphore: Optional[asyncio.Semaphore] = None
+
+        # Started lookups keyed by object id and key. The object is kept too, so its
+        # id can't be reused by another object.
+        self._lookups: Dict[
+            Tuple[int, Hashable], Tuple[object, asyncio.Future[Any]]
+        ] = {}
+        self._tasks: Set[asyncio.Future[Any]] = set()
+
+    def start(
+        self, context: Context, lookups: Sequence[Sequence[Lookup]], index: int
+    ) -> None:
+        """Start lookups for the statement ``lookahead`` places after the statement at
+        ``index``, or for every statement up to it if ``index`` is ``0``.
+
+        :param context: The render context the statements will be rendered with.
+        :param lookups: Chained variables for each top-level statement, as returned by
+            :meth:`liquid.template.BoundTemplate.chained_lookups`.
+        :param index: The index of the statement about to be rendered.
+        """
+        stop = index + self.lookahead + 1
+        for paths in lookups[0 if index == 0 else stop - 1 : stop]:
+            for name, keys in paths:
+                self._start(context, name, keys)
+
+    def _start(
+        self, context: Context, name: str, keys: Tuple[Union[str, int], ...]
+    ) -> None:
+        obj = context.resolve(name, default=None)
+        for i, key in enumerate(keys):
+            if hasattr(obj, "__getitem_async__"):
+                self._spawn(self._follow(obj, keys[i:]))
+                return
+            if not isinstance(obj, Mapping):
+                # Sync drops would be called again when the statement is rendered.
+                return
+            try:
+                obj = _getitem(obj, key)
+            except Exception:  # pylint: disable=broad-except
+                # The error is handled when the variable is evaluated.
+                return
+
+    async def _follow(self, obj: Any, keys: Tuple[Union[str, int], ...]) -> None:
+        try:
+            for key in keys:
+                if not hasattr(obj, "__getitem_async__") and not isinstance(
+                    obj, Mapping
+                ):
+                    return
+                obj = await self.getitem(obj, key)
+        except Exception:  # pylint: disable=broad-except
+            pass
+
+    async def getitem(self, obj: Any, key: Any) -> object:
+        """Like ``_getitem_async``, but reuse a lookup that has already been started
+        with the same object and key."""
+        if not hasattr(obj, "__getitem_async__"):
+            return await _getitem_async(obj, key)
+
+        try:
+            entry = self._lookups.get((id(obj), key))
+        except TypeError:
+            # Unhashable key
+            return await _getitem_async(obj, key)
+
+        if entry is None:
+            future = self._spawn(self._fetch(obj, key))
+            self._lookups[(id(obj), key)] = (obj, future)
+        else:
+            future = entry[1]
+
+        # Don't cancel the lookup for everyone else waiting on it if we're cancelled.
+        value, err = await asyncio.shield(future)
+        if err is not None:
+            raise err
+        return value
+
+    async def _fetch(
+        self, obj: Any, key: Any
+    ) -> Tuple[object, Optional[BaseException]]:
+        if self._semaphore is None:
+            self._semaphore = asyncio.Semaphore(self.limit)
+
+        async with self._semaphore:
+            try:
+                return await _getitem_async(obj, key), None
+            except Exception as err:  # pylint: disable=broad-except
+                # Raised by `getitem`, for each caller.
+                return None, err
+
+    def _spawn(self, coro: Awaitable[Any]) -> asyncio.Future[Any]:
+        task = asyncio.ensure_future(coro)
+        self._tasks.add(task)
+        task.add_done_callback(self._tasks.discard)
+        return task
+
+    def cancel(self) -> None:
+        """Cancel unfinished lookups and forget finished ones."""
+        for task in list(self._tasks):
+            task.cancel()
+        self._lookups.clear()
+
+
 # pylint: disable=too-many-instance-attributes redefined-builtin
 class Context:
     """Liquid template context."""
@@ -285,6 +802,11 @@ class Context:
         "disabled_tags",
         "autoescape",
         "_copy_depth",
+        "render_memo",
+        "memo_key",
+        "memoizable",
+        "prefetcher",
+        "filter_memo",
     )
 
     def __init__(
@@ -293,6 +815,9 @@ class Context:
         globals: Optional[Namespace] = None,
         disabled_tags: Optional[List[str]] = None,
         copy_depth: int = 0,
+        render_memo: Optional[Dict[Hashable, str]] = None,
+        prefetcher: Optional[Prefetcher] = None,
+        filter_memo: Optional[Dict[Hashable, Tuple[object, object]]] = None,
     ):
         self.env = env
 
@@ -306,7 +831,7 @@ class Context:
 
         # Namespaces are searched in this order. When a context is extended, the
         # temporary namespace is pushed to the front of this chain.
-        self.scope = ReadOnlyChainMap(self.locals, self.globals, builtin)
+        self.scope = Scope(self.locals, self.globals, builtin)
 
         # A namspace supporting stateful tags. Such as `cycle`, `increment`,
         # `decrement` and `ifchanged`.
@@ -330,6 +855,33 @@ class Context:
         # gracefully.
         self._copy_depth = copy_depth
 
+        # Output from partial templates rendered with the "render" tag, shared by all
+        # contexts copied from this one. `None` if render memoization is disabled.
+        if render_memo is None and env.memoize_render:
+            render_memo = {}
+        self.render_memo = render_memo
+
+        # Memo keys from the "render" tag are prefixed with this, as partial templates
+        # can see the arguments their parent was rendered with.
+        self.memo_key: Hashable = None
+
+        # Set to `False` if a partial template that can't be memoized was rendered
+        # with this context, in which case this context's output can't be memoized
+        # either.
+        self.memoizable = True
+
+        # Starts async lookups ahead of the statement being rendered, shared by all
+        # contexts copied from this one. `None` if prefetching is disabled.
+        if prefetcher is None and env.prefetch_async:
+            prefetcher = Prefetcher(env.prefetch_async, env.prefetch_limit)
+        self.prefetcher = prefetcher
+
+        # Results from filters marked with `memoize`, shared by all contexts copied
+        # from this one. `None` if filter memoization is disabled.
+        if filter_memo is None and env.filter_memo_size:
+            filter_memo = {}
+        self.filter_memo = filter_memo
+
     def assign(self, key: str, val: Any) -> None:
         """Add `val` to the context with key `key`."""
         self.locals[key] = val
@@ -344,12 +896,11 @@ class Context:
 
         obj = self.resolve(name, default)
 
-        if items:
-            try:
-                return functools.reduce(_getitem, items, obj)
-            except (KeyError, IndexError, TypeError):
-                if default == _undefined:
-                    return self.env.undefined(name)
+        for item in items:
+            obj = _lookup(obj, item)
+            if obj is _missing:
+                if default is _undefined:
+                    return self.undefined(name)
                 return default
 
         return obj
@@ -366,12 +917,22 @@ class Context:
         obj = self.resolve(name, default)
 
         if items:
-            try:
-                for item in items:
-                    obj = await _getitem_async(obj, item)
-            except (KeyError, IndexError, TypeError):
-                if default == _undefined:
-                    return self.env.undefined(name)
+            getitem = (
+                _getitem_async if self.prefetcher is None else self.prefetcher.getitem
+            )
+            for item in items:
+                if obj.__class__ is dict and item.__class__ is str and item != "size":
+                    obj = obj.get(item, _missing)
+                else:
+                    try:
+                        obj = await getitem(obj, item)
+                    except (KeyError, IndexError, TypeError):
+                        obj = _missing
+
+                if obj is _missing:
+                    if default is _undefined:
+                        return self.undefined(name)
+                    return default
 
         return obj
 
@@ -381,33 +942,74 @@ class Context:
         This is like `get`, but does a single, top-level lookup rather than a
         chained lookup from a sequence of keys.
         """
-        try:
-            return self.scope[name]
-        except KeyError:
-            if default == _undefined:
-                return self.env.undefined(name)
+        obj = self.scope.get(name, _missing)
+        if obj is _missing:
+            if default is _undefined:
+                return self.undefined(name)
             return default
+        return obj
+
+    def undefined(self, name: str) -> object:
+        """Return an instance of the environment's undefined type for the variable
+        `name`. Instances of the default :class:`Undefined` type are shared, as they
+        behave the same for any name."""
+        undefined = self.env.undefined
+        if undefined is Undefined:
+            return _shared_undefined(name)
+        return undefined(name)
 
-    @functools.lru_cache(maxsize=128)
     def filter(self, name: str) -> Callable[..., object]:
-        """Return the filter function with given name."""
-        try:
-            filter_func = self.env.filters[name]
-        except KeyError as err:
-            raise NoSuchFilterFunc(f"unknown filter '{name}'") from err
+        """Return the filter function with given name.
 
-        kwargs: Dict[str, Any] = {}
+        Filter functions that need the active render context will have this context
+        bound to their ``context`` argument.
+        """
+        _filter = self.env.get_filter(name)
+        if _filter.with_context:
+            return functools.partial(_filter.func, context=self)
+        return _filter.func
 
-        if getattr(filter_func, "with_context", False):
-            kwargs["context"] = self
+    def call_memoized(
+        self,
+        bound: BoundFilter,
+        val: object,
+        args: Sequence[object],
+        kwargs: Mapping[str, object],
+    ) -> object:
+        """Call the given filter, reusing the result from an earlier call in this
+        render with the same input object and argument values, if there is one.
 
-        if getattr(filter_func, "with_environment", False):
-            kwargs["environment"] = self.env
+        Filters are only memoized if all of their arguments are strings, numbers,
+        booleans or ``None``. The oldest result is discarded when there are more than
+        ``filter_memo_size`` results.
+        """
+        memo = self.filter_memo
+        if memo is None:
+            return bound.func(val, *args, **kwargs)
+
+        for arg in itertools.chain(args, kwargs.values()):
+            if not isinstance(arg, FILTER_MEMO_TYPES):
+                return bound.func(val, *args, **kwargs)
+
+        # Include argument types so `1`, `1.0` and `true` don't share a key.
+        key = (
+            bound.filter,
+            id(val),
+            tuple((arg.__class__, arg) for arg in args),
+            tuple((name, arg.__class__, arg) for name, arg in kwargs.items()),
+        )
 
-        if kwargs:
-            return functools.partial(filter_func, **kwargs)
+        entry = memo.get(key)
+        # The input object is kept with its result, so its id can't be reused.
+        if entry is not None and entry[0] is val:
+            return entry[1]
 
-        return filter_func
+        result = bound.func(val, *args, **kwargs)
+
+        if len(memo) >= self.env.filter_memo_size:
+            del memo[next(iter(memo))]
+        memo[key] = (val, result)
+        return result
 
     def get_template(self, name: str) -> BoundTemplate:
         """Load a template from the environment."""
@@ -456,14 +1058,22 @@ class Context:
         return idx
 
     @contextmanager
-    def extend(self, namespace: Namespace) -> Iterator[Context]:
-        """Extend this context with the given read-only namespace."""
+    def extend(
+        self, namespace: Namespace, fixed_keys: bool = False
+    ) -> Iterator[Context]:
+        """Extend this context with the given read-only namespace.
+
+        Keys and values in the namespace can be changed while the context is
+        extended. If ``fixed_keys`` is ``True``, values can change, but keys must not
+        be added to or removed from ``namespace`` until the context manager exits,
+        which makes resolving variables faster. See :class:`Scope`.
+        """
         if self.scope.size() > MAX_CONTEXT_DEPTH:
             raise ContextDepthError(
                 "maximum context depth reached, possible recursive include"
             )
 
-        self.scope.push(namespace)
+        self.scope.push(namespace, fixed_keys)
 
         try:
             yield self
@@ -485,6 +1095,9 @@ class Context:
             globals=ReadOnlyChainMap(namespace, self.globals),
             disabled_tags=disabled_tags,
             copy_depth=self._copy_depth + 1,
+            render_memo=self.render_memo,
+            prefetcher=self.prefetcher,
+            filter_memo=self.filter_memo,
         )
 
     def error(self, exc: Error) -> None:
@@ -1,12 +1,23 @@
 """Shared configuration from which templates can be loaded and parsed."""
 
 from __future__ import annotations
+
+import asyncio
+import pickle
+import threading
+import time
+
+from concurrent.futures import ProcessPoolExecutor
+from concurrent.futures import ThreadPoolExecutor
+from fnmatch import fnmatch
 from functools import lru_cache
+from functools import partial
 from pathlib import Path
 
 from typing import Callable
 from typing import Dict
 from typing import Any
+from typing import List
 from typing import Type
 from typing import Union
 from typing import Optional
@@ -16,20 +27,44 @@ from typing import MutableMapping
 import warnings
 
 from liquid.context import Undefined
+from liquid.filter import BoundFilter
+from liquid.fragment_cache import FragmentCache
+from liquid.fragment_cache import LRUFragmentCache
+from liquid.compact import compact
 from liquid.mode import Mode
+from liquid.optimize import optimize
 from liquid.tag import Tag
 from liquid.template import BoundTemplate
+from liquid.template import _reachable
+from liquid.tree_cache import TreeCache
 from liquid.lex import get_lexer
+from liquid.lex import tokenize_boolean_expression
+from liquid.lex import tokenize_filtered_expression
+from liquid.lex import tokenize_loop_expression
 from liquid.stream import TokenStream
 from liquid.parse import get_parser
+from liquid.parse import parse_boolean_expression
+from liquid.parse import parse_filtered_expression
+from liquid.parse import parse_loop_expression
 from liquid.utils import LRUCache
 
 from liquid import ast
 from liquid import builtin
 from liquid import loaders
 
+from liquid.builtin.literal import LiteralNode
+
+from liquid.expression import Expression
+from liquid.expression import FilteredExpression
+from liquid.expression import LoopExpression
+
+from liquid.token import Token
+
 from liquid.exceptions import Error
 from liquid.exceptions import LiquidSyntaxError
+from liquid.exceptions import NoSuchFilterFunc
+from liquid.exceptions import PreloadError
+from liquid.exceptions import TemplateNotFound
 from liquid.exceptions import lookup_warning
 
 
@@ -85,6 +120,76 @@ class Environment:
     :param globals: An optional mapping that will be added to the context of any
         template loaded from this environment. Defaults to ``None``.
     :type globals: dict
+    :param tree_cache: An optional persistent parse tree cache. If given, parsed
+        templates are stored in and loaded from the cache, so other processes don't
+        need to parse templates again. Defaults to ``None``.
+    :type tree_cache: liquid.tree_cache.TreeCache
+    :param optimize: If ``True``, parse trees are optimized before they are rendered
+        for the first time. Adjacent template literals are merged, filtered expressions
+        that use only literals and pure filters are evaluated in advance, and ``if``,
+        ``unless`` and ``case`` branches with constant conditions are removed. All
+        filters should be registered before parsing templates. Defaults to ``False``.
+    :type optimize: bool
+    :param reload_interval: The minimum number of seconds between checks that a cached
+        template is up to date, when ``auto_reload`` is ``True``. Defaults to ``0``,
+        meaning templates are checked every time they are requested. For event driven
+        reloading, disable ``auto_reload`` and use a
+        :class:`liquid.watcher.TemplateWatcher`.
+    :type reload_interval: float
+    :param cache: An optional mapping to use as the template cache, like a
+        :class:`liquid.utils.LRUCache` with a ``max_weight`` or ``ttl``. If given,
+        ``cache_size`` is ignored. Defaults to ``None``, meaning a new ``LRUCache`` with
+        a capacity of ``cache_size`` is used.
+    :type cache: MutableMapping[Any, Any]
+    :param expression_cache_size: The capacity of each of the environment's parsed
+        expression caches. Templates that repeat an output statement or tag expression
+        share one expression object, rather than parsing it again. Defaults to 1024. If
+        ``expression_cache_size`` is ``None`` or less than ``1``, expressions are not
+        cached.
+    :type expression_cache_size: int
+    :param fragment_cache: Where the ``cache`` tag stores rendered fragments.
+        Defaults to ``None``, meaning a new
+        :class:`liquid.fragment_cache.LRUFragmentCache` with a capacity of 300
+        fragments is used.
+    :type fragment_cache: liquid.fragment_cache.FragmentCache
+    :param memoize_render: If ``True``, output from the ``render`` tag is reused when
+        the same partial template is rendered with the same arguments more than once
+        in a single render. Partial templates that use stateful tags, like ``cycle``
+        and ``increment``, or filters that are not marked as pure, are always
+        rendered. Defaults to ``False``.
+    :type memoize_render: bool
+    :param prefetch_async: The number of top-level statements, after the one being
+        rendered, for which async drop lookups are started early when rendering with
+        :meth:`liquid.template.BoundTemplate.render_async`. Lookups that don't depend
+        on each other are awaited concurrently, and output is still written in order.
+        Lookups are speculative, and include those in ``if`` and ``case`` branches
+        that might not be rendered. Defaults to ``0``, meaning lookups are not started
+        early.
+    :type prefetch_async: int
+    :param prefetch_limit: The maximum number of async drop lookups awaited at the
+        same time when ``prefetch_async`` is enabled. Defaults to ``10``.
+    :type prefetch_limit: int
+    :param preload_partials: If ``True``, when
+        :meth:`liquid.Environment.get_template_async` loads a template that is not
+        cached, templates named by its ``include`` and ``render`` tags, and the
+        templates they name, are loaded and cached too. Each level of the dependency
+        graph is fetched with one call to the loader's ``get_sources_async`` method.
+        Partial templates with a name that can't be known until render time, and
+        ``render`` tags rendered with a ``render_folder`` variable, are still loaded
+        when they are rendered. Defaults to ``False``.
+    :type preload_partials: bool
+    :param filter_memo_size: The maximum number of results from filters marked with
+        :func:`liquid.filter.memoize`, like ``sort`` and ``where``, kept for reuse
+        during a single render. Set it to ``0`` to disable filter memoization.
+        Defaults to ``256``.
+    :type filter_memo_size: int
+    :param compact_trees: If ``True``, parse trees are compacted after parsing, and
+        after optimizing if ``optimize`` is enabled. Source text that isn't needed to
+        render a template or report an error is discarded, and equal tokens and
+        template literals are shared between templates, through a cache with a
+        capacity of ``expression_cache_size``. See :mod:`liquid.compact`. Defaults to
+        ``False``.
+    :type compact_trees: bool
     """
 
     # pylint: disable=redefined-builtin too-many-arguments
@@ -103,6 +208,18 @@ class Environment:
         auto_reload: bool = True,
         cache_size: int = 300,
         globals: Optional[Mapping[str, object]] = None,
+        tree_cache: Optional[TreeCache] = None,
+        optimize: bool = False,
+        reload_interval: float = 0,
+        cache: Optional[MutableMapping[Any, Any]] = None,
+        expression_cache_size: int = 1024,
+        fragment_cache: Optional[FragmentCache] = None,
+        memoize_render: bool = False,
+        prefetch_async: int = 0,
+        prefetch_limit: int = 10,
+        preload_partials: bool = False,
+        filter_memo_size: int = 256,
+        compact_trees: bool = False,
     ):
         self.tag_start_string = tag_start_string
         self.tag_end_string = tag_end_string
@@ -128,17 +245,65 @@ class Environment:
         # Filter register.
         self.filters: Dict[str, Callable[..., Any]] = {}
 
+        # Filter functions from the register, bound to this environment.
+        self._bound_filters: Dict[str, BoundFilter] = {}
+
         # tolerance mode
         self.mode = tolerance
 
         # Template cache
-        if cache_size and cache_size > 0:
-            self.cache: MutableMapping[Any, Any] = LRUCache(cache_size)
+        self.cache: MutableMapping[Any, Any]
+        if cache is not None:
+            self.cache = cache
+            self.auto_reload = auto_reload
+        elif cache_size and cache_size > 0:
+            self.cache = LRUCache(cache_size)
             self.auto_reload = auto_reload
         else:
             self.cache = {}
             self.auto_reload = False
 
+        # Incremented whenever a template is added to the template cache, or removed
+        # by a `TemplateWatcher`. Partial templates linked to `include` and `render`
+        # tags are looked up again if it has changed. See
+        # `liquid.builtin.tags.include_tag.TemplateLink`.
+        self.cache_version = 0
+        self._cache_version_lock = threading.Lock()
+
+        # Minimum number of seconds between checks that a cached template is up to
+        # date.
+        self.reload_interval = reload_interval
+
+        # Persistent parse tree cache
+        self.tree_cache = tree_cache
+
+        # Indicates if parse trees should be optimized after parsing.
+        self.optimize = optimize
+
+        # Parsed expressions, by expression source, for each kind of expression.
+        self.expression_cache_size = expression_cache_size
+        self._init_expression_caches()
+
+        # Rendered output of `cache` blocks.
+        self.fragment_cache = fragment_cache or LRUFragmentCache()
+
+        # Indicates if output from the `render` tag is memoized for each render.
+        self.memoize_render = memoize_render
+
+        # The number of top-level statements to look ahead for async lookups, and
+        # the maximum number of async lookups awaited at the same time.
+        self.prefetch_async = prefetch_async
+        self.prefetch_limit = prefetch_limit
+
+        # Indicates if `get_template_async` loads partial templates ahead of time.
+        self.preload_partials = preload_partials
+
+        # The maximum number of memoized filter results kept for each render.
+        self.filter_memo_size = filter_memo_size
+
+        # Indicates if parse trees should be compacted after parsing.
+        self.compact_trees = compact_trees
+
         self.template_class = BoundTemplate
 
         builtin.register(self)
@@ -157,6 +322,114 @@ class Environment:
             )
         )
 
+    def __getstate__(self) -> Dict[str, Any]:
+        state = self.__dict__.copy()
+
+        # Don't send cached templates along with a pickled environment.
+        if isinstance(self.cache, LRUCache):
+            state["cache"] = LRUCache(
+                self.cache.capacity,
+                max_weight=self.cache.max_weight,
+                weigh=self.cache.weigh,
+                ttl=self.cache.ttl,
+            )
+        else:
+            state["cache"] = {}
+
+        # Nor cached fragments.
+        if isinstance(self.fragment_cache, LRUFragmentCache):
+            state["fragment_cache"] = LRUFragmentCache(
+                self.fragment_cache.cache.capacity,
+                max_size=self.fragment_cache.cache.max_weight,
+            )
+
+        # Expression caches are rebuilt by `__setstate__`.
+        del state["_parse_boolean_expression"]
+        del state["_parse_filtered_expression"]
+        del state["_parse_loop_expression"]
+        del state["_share_token"]
+        del state["_share_literal"]
+        del state["_cache_version_lock"]
+        return state
+
+    def __setstate__(self, state: Dict[str, Any]) -> None:
+        self.__dict__.update(state)
+        self._cache_version_lock = threading.Lock()
+        self._init_expression_caches()
+
+    def _init_expression_caches(self) -> None:
+        size = self.expression_cache_size
+        if size and size > 0:
+            cache = lru_cache(maxsize=size)
+            self._parse_boolean_expression = cache(_parse_boolean_expression)
+            self._parse_filtered_expression = cache(_parse_filtered_expression)
+            self._parse_loop_expression = cache(_parse_loop_expression)
+            self._share_token = cache(_share_token)
+            self._share_literal = cache(LiteralNode)
+        else:
+            self._parse_boolean_expression = _parse_boolean_expression
+            self._parse_filtered_expression = _parse_filtered_expression
+            self._parse_loop_expression = _parse_loop_expression
+            self._share_token = _share_token
+            self._share_literal = LiteralNode
+
+    def parse_boolean_expression_value(self, value: str) -> Expression:
+        """Parse a boolean expression, like those found in ``if`` and ``unless`` tags,
+        reusing a previously parsed expression if one is available.
+
+        Expressions returned from this method are shared between templates, and must
+        not be modified.
+
+        :param value: The expression source.
+        :type value: str
+        """
+        return self._parse_boolean_expression(value)
+
+    def parse_filtered_expression_value(self, value: str) -> FilteredExpression:
+        """Parse a filtered expression, like those found in output statements and
+        ``echo`` tags, reusing a previously parsed expression if one is available.
+
+        Expressions returned from this method are shared between templates, and must
+        not be modified.
+
+        :param value: The expression source.
+        :type value: str
+        """
+        return self._parse_filtered_expression(value)
+
+    def parse_loop_expression_value(self, value: str) -> LoopExpression:
+        """Parse a loop expression, like those found in ``for`` and ``tablerow``
+        tags, reusing a previously parsed expression if one is available.
+
+        Expressions returned from this method are shared between templates, and must
+        not be modified.
+
+        :param value: The expression source.
+        :type value: str
+        """
+        return self._parse_loop_expression(value)
+
+    def share_token(self, tok: Token) -> Token:
+        """Return a token equal to the given token, reusing a previously shared token
+        if one is available. Used by :func:`liquid.compact.compact`.
+
+        :param tok: A token from a parse tree.
+        :type tok: liquid.token.Token
+        """
+        return self._share_token(tok)
+
+    def share_literal(self, tok: Token) -> LiteralNode:
+        """Return a template literal node for the given token, reusing a previously
+        shared node if one is available. Used by :func:`liquid.compact.compact`.
+
+        Nodes returned from this method are shared between templates, and must not be
+        modified.
+
+        :param tok: A literal token.
+        :type tok: liquid.token.Token
+        """
+        return self._share_literal(tok)
+
     def add_tag(self, tag: Type[Tag]) -> None:
         """Register a liquid tag with the environment. Built-in tags are registered for
         you automatically with every new :class:`Environment`.
@@ -181,12 +454,67 @@ class Environment:
         :type func: Callable[..., Any]
         """
         self.filters[name] = func
+        self._bound_filters.pop(name, None)
+
+    def get_filter(self, name: str) -> BoundFilter:
+        """Return the filter function registered with the given name, bound to this
+        environment.
+
+        Filter functions are bound once, then reused for every render context. If the
+        filter function requires the active render context, it must be passed as the
+        named argument ``context`` every time the filter function is called.
+
+        :param name: The filter's name.
+        :type name: str
+        :raises:
+            :class:`liquid.exceptions.NoSuchFilterFunc`: if a filter with the given
+            name has not been registered.
+        """
+        bound = self._bound_filters.get(name)
+
+        # The filter register might have been modified directly.
+        if bound is None or bound.filter is not self.filters.get(name):
+            try:
+                filter_func = self.filters[name]
+            except KeyError as err:
+                raise NoSuchFilterFunc(f"unknown filter '{name}'") from err
+
+            func = filter_func
+            if getattr(filter_func, "with_environment", False):
+                func = partial(filter_func, environment=self)
+
+            with_context = getattr(filter_func, "with_context", False)
+            bound = BoundFilter(
+                filter_func,
+                func,
+                with_context,
+                getattr(filter_func, "memoize", False) and not with_context,
+            )
+            self._bound_filters[name] = bound
+
+        return bound
 
     def parse(self, source: str) -> ast.ParseTree:
         """Parse the given string as a liquid template.
 
         More often than not you'll want to use `Environment.from_string` instead.
         """
+        if self.tree_cache is None:
+            return self._parse(source)
+
+        key = self.tree_cache.key(self, source)
+        parse_tree = self.tree_cache.load(key)
+
+        if parse_tree is None:
+            parse_tree = self._parse(source)
+            self.tree_cache.dump(key, parse_tree)
+        elif self.compact_trees:
+            # Share tokens and literals with templates parsed by this process.
+            compact(parse_tree, self)
+
+        return parse_tree
+
+    def _parse(self, source: str) -> ast.ParseTree:
         tokenize = get_lexer(
             self.tag_start_string,
             self.tag_end_string,
@@ -197,6 +525,11 @@ class Environment:
 
         token_iter = tokenize(source)
         parse_tree = parser.parse(TokenStream(token_iter))
+
+        if self.optimize:
+            optimize(parse_tree, self)
+        if self.compact_trees:
+            compact(parse_tree, self)
         return parse_tree
 
     # pylint: disable=redefined-builtin
@@ -248,19 +581,24 @@ class Environment:
         :param name: The template's name. The loader is responsible for interpretting
             the name.
         :param globals: A mapping of context variables made available every time the
-            resulting template is rendered.
+            resulting template is rendered. If given, a copy of the cached template is
+            returned, and the cached template is left unchanged.
         :returns: A parsed template ready to be rendered.
         :rtype: liquid.template.BoundTemplate
         :raises:
             :class:`liquid.exceptions.TemplateNotFound`: if a template with the given
             name can not be found.
         """
-        template = self._check_cache(name, globals)
+        template = self._check_cache(name)
 
         if not template:
-            template = self.loader.load(self, name, globals=self.make_globals(globals))
-            self.cache[name] = template
+            template = self.loader.load(self, name, globals=self.make_globals())
+            self._cache_template(name, template)
 
+        if globals:
+            # Cached templates are shared, possibly between threads, so they don't
+            # keep globals from any one call.
+            return template.with_globals(globals)
         return template
 
     async def get_template_async(
@@ -271,34 +609,315 @@ class Environment:
         """An async version of ``get_template``."""
         template = self.cache.get(name)
 
-        if isinstance(template, BoundTemplate) and (
-            not self.auto_reload or await template.is_up_to_date_async()
+        if not isinstance(template, BoundTemplate) or (
+            self.auto_reload and not await self._is_up_to_date_async(template)
         ):
-            template.globals.update(self.make_globals(globals))
-        else:
             template = await self.loader.load_async(
                 self,
                 name,
-                globals=self.make_globals(globals),
+                globals=self.make_globals(),
             )
-            self.cache[name] = template
+            self._cache_template(name, template)
+
+            if self.preload_partials:
+                await self._preload_partials_async(template)
 
+        if globals:
+            return template.with_globals(globals)
         return template
 
-    def _check_cache(
+    async def _preload_partials_async(self, template: BoundTemplate) -> None:
+        """Load and cache partial templates with a literal name that are referenced
+        by the given template, one level of the dependency graph at a time."""
+        seen = {template.name}
+        templates = [template]
+
+        while templates:
+            names: List[str] = []
+            for _template in templates:
+                analysis = _template.analyze(
+                    follow_partials=False, raise_for_failures=False
+                )
+                for _name in analysis.templates:
+                    if _name not in seen and not isinstance(
+                        self._peek_cache(_name), BoundTemplate
+                    ):
+                        seen.add(_name)
+                        names.append(_name)
+
+            if not names:
+                return
+
+            templates = []
+            for _name, result in (await self._load_many_async(names)).items():
+                if isinstance(result, BoundTemplate):
+                    self._cache_template(_name, result)
+                    templates.append(result)
+
+    async def _load_many_async(self, names: List[str]) -> Dict[str, object]:
+        """Load the named templates for ``preload_partials``. Return a mapping of
+        names to templates, or to the exception raised while loading them."""
+        loader = self.loader
+        _globals = self.make_globals()
+
+        if _overrides(loader, "load_async") and not _overrides(
+            loader, "load_from_source"
+        ):
+            # A loader that changes templates in `load_async` can't be given a
+            # batch of sources.
+            results = await asyncio.gather(
+                *(loader.load_async(self, _name, globals=_globals) for _name in names),
+                return_exceptions=True,
+            )
+            return dict(zip(names, results))
+
+        loaded: Dict[str, object] = {}
+        sources = await loader.get_sources_async(self, names)
+        for _name, source in sources.items():
+            try:
+                loaded[_name] = loader.load_from_source(
+                    self, _name, source, globals=_globals
+                )
+            except Error as err:
+                # The error is raised again if the template is rendered.
+                loaded[_name] = err
+        return loaded
+
+    def _peek_cache(self, name: str) -> object:
+        # Look for a cached template without counting a hit or moving it up.
+        if isinstance(self.cache, LRUCache):
+            return self.cache.peek(name)
+        return self.cache.get(name)
+
+    def cache_sizes(self) -> Dict[Any, int]:
+        """Return an estimate of the memory retained by each cached template's parse
+        tree, in bytes, by template name.
+
+        Objects shared with other cached templates, like expressions from the
+        expression caches, or tokens and literals shared by ``compact_trees``, are not
+        counted. A template's size is roughly the memory that would be freed by
+        removing it from the cache.
+        """
+        templates = [
+            (name, template)
+            for name, template in self.cache.items()
+            if isinstance(template, BoundTemplate)
+        ]
+        reachable = [_reachable(template.tree) for _, template in templates]
+
+        refs: Dict[int, int] = {}
+        for objects in reachable:
+            for _id in objects:
+                refs[_id] = refs.get(_id, 0) + 1
+
+        return {
+            name: sum(size for _id, size in objects.items() if refs[_id] == 1)
+            for (name, _), objects in zip(templates, reachable)
+        }
+
+    def preload(
         self,
-        name: str,
-        globals: Optional[Mapping[str, object]] = None,
-    ) -> Optional[BoundTemplate]:
+        pattern: str = "*.liquid",
+        workers: Optional[int] = None,
+        raise_for_errors: bool = True,
+    ) -> Dict[str, BoundTemplate]:
+        """Load, parse and cache all templates from the configured loader with a name
+        matching the given pattern.
+
+        Template sources are read concurrently in a thread pool and parsed in a pool of
+        processes. Parsed templates are added to the template cache, so they are not
+        parsed again when requested with :meth:`get_template`. If the cache is smaller
+        than the number of matching templates, some will be evicted.
+
+        Parsing in other processes requires the environment, including its tags and
+        filters, to be picklable. Otherwise templates are parsed in this process. In
+        ``Mode.WARN``, warnings issued by other processes are not shown.
+
+        :param pattern: An :func:`fnmatch.fnmatch` pattern to match against template
+            names, as returned by the loader's ``list_templates`` method. ``*`` matches
+            any characters, including ``/``. Defaults to ``"*.liquid"``, which matches
+            all templates with a ``.liquid`` suffix, in any directory. Use ``"*"`` to
+            preload every template the loader can list.
+        :type pattern: str
+        :param workers: The maximum number of processes to parse templates with.
+            Defaults to the number of processors on the machine. If ``workers`` is
+            less than ``2``, templates are parsed in this process.
+        :type workers: Optional[int]
+        :param raise_for_errors: If ``True``, raise a
+            :class:`liquid.exceptions.PreloadError` after loading all other templates,
+            if any templates could not be read or parsed. Defaults to ``True``.
+        :type raise_for_errors: bool
+        :returns: A mapping of template names to templates that were loaded.
+        :rtype: Dict[str, liquid.template.BoundTemplate]
+        :raises:
+            :class:`NotImplementedError`: if the loader can't list templates.
+        """
+        names = [
+            name for name in self.loader.list_templates() if fnmatch(name, pattern)
+        ]
+        errors: Dict[str, Exception] = {}
+
+        # Reading template sources is I/O bound.
+        with ThreadPoolExecutor() as pool:
+            results = list(zip(names, pool.map(self._preload_source, names)))
+
+        sources: Dict[str, loaders.TemplateSource] = {}
+        for name, result in results:
+            if isinstance(result, Exception):
+                errors[name] = result
+            else:
+                sources[name] = result
+
+        trees: Dict[str, ast.ParseTree] = {}
+        unparsed: Dict[str, str] = {}
+
+        for name, template_source in sources.items():
+            if self.tree_cache is not None:
+                tree = self.tree_cache.load(
+                    self.tree_cache.key(self, template_source.source)
+                )
+                if tree is not None:
+                    if self.compact_trees:
+                        compact(tree, self)
+                    trees[name] = tree
+                    continue
+            unparsed[name] = template_source.source
+
+        for name, result in self._parse_many(unparsed, workers).items():
+            if isinstance(result, Exception):
+                if isinstance(result, LiquidSyntaxError):
+                    result.filename = Path(sources[name].filename)
+                    result.source = sources[name].source
+                errors[name] = result
+                continue
+
+            if self.tree_cache is not None:
+                self.tree_cache.dump(
+                    self.tree_cache.key(self, sources[name].source), result
+                )
+            trees[name] = result
+
+        templates: Dict[str, BoundTemplate] = {}
+        for name, tree in trees.items():
+            template = self.template_class(
+                env=self,
+                name=name,
+                path=Path(sources[name].filename),
+                parse_tree=tree,
+                globals=self.make_globals(),
+            )
+            template.uptodate = sources[name].uptodate
+            self._cache_template(name, template)
+            templates[name] = template
+
+        if errors and raise_for_errors:
+            raise PreloadError(errors)
+
+        return templates
+
+    def _preload_source(self, name: str) -> Union[loaders.TemplateSource, Exception]:
+        try:
+            return self.loader.get_source(self, name)
+        except Exception as err:  # pylint: disable=broad-except
+            exc = TemplateNotFound(name)
+            exc.__cause__ = err
+            return exc
+
+    def _parse_many(
+        self, sources: Dict[str, str], workers: Optional[int]
+    ) -> Dict[str, Union[ast.ParseTree, Exception]]:
+        """Parse many template sources, maybe in a pool of processes."""
+        results: Dict[str, Union[ast.ParseTree, Exception]] = {}
+        remaining = dict(sources)
+
+        if len(sources) > 1 and (workers is None or workers > 1):
+            try:
+                env_data = pickle.dumps(self, protocol=pickle.HIGHEST_PROTOCOL)
+            except (pickle.PicklingError, TypeError, AttributeError):
+                env_data = None
+
+            if env_data is not None:
+                with ProcessPoolExecutor(
+                    max_workers=workers,
+                    initializer=_init_preload_worker,
+                    initargs=(env_data,),
+                ) as pool:
+                    futures = {
+                        name: pool.submit(_preload_parse, source)
+                        for name, source in sources.items()
+                    }
+
+                    for name, future in futures.items():
+                        try:
+                            tree = future.result()
+                        except Error as err:
+                            results[name] = err
+                        except Exception:  # pylint: disable=broad-except
+                            # Probably an unpicklable parse tree or a broken pool.
+                            # We'll try again in this process.
+                            continue
+                        else:
+                            if self.compact_trees:
+                                # Share tokens and literals with templates parsed
+                                # by this process.
+                                compact(tree, self)
+                            results[name] = tree
+                        del remaining[name]
+
+        for name, source in remaining.items():
+            try:
+                results[name] = self._parse(source)
+            except Error as err:
+                results[name] = err
+
+        return results
+
+    def bump_cache_version(self) -> None:
+        """Increment ``cache_version``, so ``include`` and ``render`` tags look up
+        their partial templates again. Call this after removing templates from the
+        template cache. Safe to call from any thread."""
+        with self._cache_version_lock:
+            self.cache_version += 1
+
+    def _cache_template(self, name: str, template: BoundTemplate) -> None:
+        self.cache[name] = template
+        self.bump_cache_version()
+
+    def _check_cache(self, name: str) -> Optional[BoundTemplate]:
         _cached = self.cache.get(name)
 
         if isinstance(_cached, BoundTemplate) and (
-            not self.auto_reload or _cached.is_up_to_date
+            not self.auto_reload or self._is_up_to_date(_cached)
         ):
-            _cached.globals.update(self.make_globals(globals))
             return _cached
         return None
 
+    def _is_up_to_date(self, template: BoundTemplate) -> bool:
+        if not self.reload_interval:
+            return template.is_up_to_date
+
+        now = time.monotonic()
+        if now - template.checked_at < self.reload_interval:
+            return True
+
+        uptodate = template.is_up_to_date
+        if uptodate:
+            template.checked_at = now
+        return uptodate
+
+    async def _is_up_to_date_async(self, template: BoundTemplate) -> bool:
+        if not self.reload_interval:
+            return await template.is_up_to_date_async()
+
+        now = time.monotonic()
+        if now - template.checked_at < self.reload_interval:
+            return True
+
+        uptodate = await template.is_up_to_date_async()
+        if uptodate:
+            template.checked_at = now
+        return uptodate
+
     # pylint: disable=redefined-builtin
     def make_globals(
         self, globals: Optional[Mapping[str, object]] = None
@@ -328,6 +947,40 @@ class Environment:
             warnings.warn(str(exc), category=lookup_warning(exc.__class__))
 
 
+def _overrides(loader: loaders.BaseLoader, method: str) -> bool:
+    return getattr(type(loader), method) is not getattr(loaders.BaseLoader, method)
+
+
+# The environment used to parse templates in a preload worker process.
+_preload_env: Optional[Environment] = None
+
+
+def _init_preload_worker(env_data: bytes) -> None:
+    global _preload_env  # pylint: disable=global-statement,invalid-name
+    _preload_env = pickle.loads(env_data)
+
+
+def _preload_parse(source: str) -> ast.ParseTree:
+    assert _preload_env is not None
+    return _preload_env._parse(source)  # pylint: disable=protected-access
+
+
+def _parse_boolean_expression(value: str) -> Expression:
+    return parse_boolean_expression(TokenStream(tokenize_boolean_expression(value)))
+
+
+def _parse_filtered_expression(value: str) -> FilteredExpression:
+    return parse_filtered_expression(TokenStream(tokenize_filtered_expression(value)))
+
+
+def _parse_loop_expression(value: str) -> LoopExpression:
+    return parse_loop_expression(TokenStream(tokenize_loop_expression(value)))
+
+
+def _share_token(tok: Token) -> Token:
+    return tok
+
+
 @lru_cache(maxsize=10)
 def get_implicit_environment(*args: Any) -> Environment:
     """Return an :class:`Environment` initialized with the given arguments."""
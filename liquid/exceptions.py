@@ -92,6 +92,21 @@ class TemplateNotFound(Error):
         return msg
 
 
+class PreloadError(Error):
+    """Exception raised when one or more templates could not be preloaded.
+
+    :param errors: A mapping of template names to the exception raised while loading
+        or parsing the template.
+    :type errors: Dict[str, Exception]
+    """
+
+    def __init__(self, errors: Dict[str, Exception]):
+        self.errors = errors
+        super().__init__(
+            f"{len(errors)} template(s) failed to load: {', '.join(sorted(errors))}"
+        )
+
+
 class ContextDepthError(Error):
     """Exception raised when the maximum context depth is reached.
 
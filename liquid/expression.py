@@ -6,6 +6,7 @@ from abc import ABC
 from abc import abstractmethod
 
 from collections import abc
+from itertools import chain
 from itertools import islice
 
 from typing import Dict
@@ -25,6 +26,8 @@ except ImportError:
     from liquid.exceptions import Markup  # type: ignore
 
 from liquid.context import Context
+from liquid.context import Resolver
+from liquid.context import make_resolver
 
 from liquid.exceptions import LiquidTypeError
 from liquid.exceptions import Error
@@ -232,11 +235,27 @@ IdentifierPath = List[Union[IdentifierPathElement, "Identifier"]]
 
 
 class Identifier(Expression):
-    __slots__ = ("path",)
+    __slots__ = ("path", "resolver")
 
     def __init__(self, path: IdentifierPath):
         self.path = path
 
+        # A function that resolves this identifier from a render context, if every
+        # element of the path is known at parse time. Don't modify `path` after
+        # the identifier has been created.
+        self.resolver: Optional[Resolver] = None
+
+        if path and all(elem.__class__ is IdentifierPathElement for elem in path):
+            name = path[0].value
+            if isinstance(name, str):
+                self.resolver = make_resolver(
+                    name, [elem.value for elem in path[1:]]  # type: ignore
+                )
+
+    def __reduce__(self) -> Tuple[Any, ...]:
+        # Resolvers can't be pickled. They are rebuilt by `__init__`.
+        return (self.__class__, (self.path,))
+
     def __eq__(self, other: object) -> bool:
         return isinstance(other, Identifier) and self.path == other.path
 
@@ -257,6 +276,8 @@ class Identifier(Expression):
         return hash(str(self))
 
     def evaluate(self, context: Context) -> object:
+        if self.resolver is not None:
+            return self.resolver(context)
         path: List[Any] = [elem.evaluate(context) for elem in self.path]
         return context.get(path)
 
@@ -464,7 +485,7 @@ class FilteredExpression(Expression):
 
         for fltr in self.filters:
             try:
-                func = context.filter(fltr.name)
+                bound = context.env.get_filter(fltr.name)
             except NoSuchFilterFunc:
                 if context.env.strict_filters:
                     raise
@@ -475,7 +496,12 @@ class FilteredExpression(Expression):
             try:
                 args = fltr.evaluate_args(context)
                 kwargs = fltr.evaluate_kwargs(context)
-                result = func(result, *args, **kwargs)
+                if bound.with_context:
+                    kwargs["context"] = context
+                if bound.memoize:
+                    result = context.call_memoized(bound, result, args, kwargs)
+                else:
+                    result = bound.func(result, *args, **kwargs)
             except FilterValueError:
                 # Pass over filtered expressions who's left value is not allowed.
                 continue
@@ -491,7 +517,7 @@ class FilteredExpression(Expression):
 
         for fltr in self.filters:
             try:
-                func = context.filter(fltr.name)
+                bound = context.env.get_filter(fltr.name)
             except NoSuchFilterFunc:
                 if context.env.strict_filters:
                     raise
@@ -502,7 +528,12 @@ class FilteredExpression(Expression):
             try:
                 args = await fltr.evaluate_args_async(context)
                 kwargs = await fltr.evaluate_kwargs_async(context)
-                result = func(result, *args, **kwargs)
+                if bound.with_context:
+                    kwargs["context"] = context
+                if bound.memoize:
+                    result = context.call_memoized(bound, result, args, kwargs)
+                else:
+                    result = bound.func(result, *args, **kwargs)
             except FilterValueError:
                 # Pass over filtered expressions who's left value is not allowed.
                 continue
@@ -633,7 +664,14 @@ class LoopExpression(Expression):
             f"offset={self.offset}, cols={self.cols}, reversed={self.reversed})"
         )
 
-    def evaluate(self, context: Context) -> Tuple[Iterator[Any], int]:
+    def evaluate(self, context: Context) -> Tuple[Iterator[Any], Optional[int]]:
+        """Return an iterator over this loop's items and the number of items it will
+        yield.
+
+        The number of items is ``None`` if the iterable does not know its own length,
+        like a generator. In that case the iterator is guaranteed to yield at least
+        one item.
+        """
         # For the sake of the special for loop offset `continue`, we need to derive an
         # identifier for this loop and store the theoretical stop index on the render
         # context using that identifier.
@@ -647,24 +685,11 @@ class LoopExpression(Expression):
         ]
 
         if self.identifier:
-            # An identifier that must resolve to a list or dict in the current
-            # global or local namespaces.
+            # An identifier that must resolve to a list, dict or some other iterable
+            # in the current global or local namespaces.
             assert isinstance(self.identifier, Identifier)
             _offset_key.append(str(self.identifier))
-
             obj = self.identifier.evaluate(context)
-
-            if isinstance(obj, abc.Mapping):
-                length = len(obj)
-                loop_iter: Iterator[Any] = iter(obj.items())
-            elif isinstance(obj, abc.Sequence):
-                length = len(obj)
-                loop_iter = iter(obj)
-
-            else:
-                raise LiquidTypeError(
-                    f"expected array or hash at '{self.identifier}', found '{str(obj)}'"
-                )
         else:
             assert self.start is not None
             assert self.stop is not None
@@ -680,9 +705,7 @@ class LoopExpression(Expression):
             stop = stop + 1
 
             _offset_key.append(f"{start}..{stop}")
-
-            loop_iter = iter(range(start, stop))
-            length = stop - start
+            obj = range(start, stop)
 
         limit: Optional[int] = None
         offset: Optional[int] = None
@@ -696,42 +719,23 @@ class LoopExpression(Expression):
                 assert isinstance(_offset, int)
                 offset = _offset
 
-            length = max(length - offset, 0)
-
         if self.limit:
             _limit = self.limit.evaluate(context)
             assert isinstance(_limit, int)
             limit = _limit
-            length = min(length, limit)
-
-        context.stopindex(key=offset_key, index=length)
-        loop_iter = islice(loop_iter, offset, limit)
-
-        if self.reversed:
-            loop_iter = reversed(list(loop_iter))
 
-        return loop_iter, length
+        return self._iter(context, obj, offset_key, offset, limit)
 
-    async def evaluate_async(self, context: Context) -> Tuple[Iterator[Any], int]:
+    async def evaluate_async(
+        self, context: Context
+    ) -> Tuple[Iterator[Any], Optional[int]]:
+        """An async version of :meth:`LoopExpression.evaluate`."""
         _offset_key = [self.name]
 
         if self.identifier:
             assert isinstance(self.identifier, Identifier)
             _offset_key.append(str(self.identifier))
-
             obj = await self.identifier.evaluate_async(context)
-
-            if isinstance(obj, abc.Mapping):
-                length = len(obj)
-                loop_iter: Iterator[Any] = iter(obj.items())
-            elif isinstance(obj, abc.Sequence):
-                length = len(obj)
-                loop_iter = iter(obj)
-
-            else:
-                raise LiquidTypeError(
-                    f"expected array or hash at '{self.identifier}', found '{str(obj)}'"
-                )
         else:
             assert self.start is not None
             assert self.stop is not None
@@ -744,8 +748,7 @@ class LoopExpression(Expression):
 
             stop = stop + 1
             _offset_key.append(f"{start}..{stop}")
-            loop_iter = iter(range(start, stop))
-            length = stop - start
+            obj = range(start, stop)
 
         limit: Optional[int] = None
         offset: Optional[int] = None
@@ -759,23 +762,124 @@ class LoopExpression(Expression):
                 assert isinstance(_offset, int)
                 offset = _offset
 
-            length = max(length - offset, 0)
-
         if self.limit:
             _limit = await self.limit.evaluate_async(context)
             assert isinstance(_limit, int)
             limit = _limit
-            length = min(length, limit)
 
-        context.stopindex(key=offset_key, index=length)
-        loop_iter = islice(loop_iter, offset, limit)
+        return self._iter(context, obj, offset_key, offset, limit)
 
-        if self.reversed:
-            loop_iter = reversed(list(loop_iter))
+    def _iter(
+        self,
+        context: Context,
+        obj: object,
+        offset_key: str,
+        offset: Optional[int],
+        limit: Optional[int],
+    ) -> Tuple[Iterator[Any], Optional[int]]:
+        # Offset and limit are applied before reversing, and never copy a sequence.
+        lo = max(offset or 0, 0)
+
+        if isinstance(obj, abc.Mapping):
+            size = len(obj)
+            lo = min(lo, size)
+            hi = size if limit is None else min(size, lo + max(limit, 0))
+            loop_iter: Iterator[Any] = islice(iter(obj.items()), lo, hi)
+            if self.reversed:
+                loop_iter = reversed(list(loop_iter))
+            length: Optional[int] = hi - lo
+
+        elif isinstance(obj, abc.Sequence):
+            size = len(obj)
+            lo = min(lo, size)
+            hi = size if limit is None else min(size, lo + max(limit, 0))
+            if self.reversed:
+                loop_iter = map(obj.__getitem__, range(hi - 1, lo - 1, -1))
+            elif lo == 0 and hi == size:
+                loop_iter = iter(obj)
+            else:
+                loop_iter = islice(obj, lo, hi)
+            length = hi - lo
+
+        elif isinstance(obj, abc.Iterable) and not isinstance(obj, (str, bytes)):
+            loop_iter, length = _iter_lazy(obj, lo, limit, self.reversed)
+            if length is None:
+                # Check for an empty iterable without exhausting it.
+                try:
+                    first = next(loop_iter)
+                except StopIteration:
+                    loop_iter, length = iter(()), 0
+                else:
+                    loop_iter = chain((first,), loop_iter)
+
+        else:
+            raise LiquidTypeError(
+                f"expected array or hash at '{self.identifier}', found '{str(obj)}'"
+            )
+
+        if length is not None:
+            context.stopindex(key=offset_key, index=length)
+        else:
+            loop_iter = _count_stopindex(loop_iter, context, offset_key)
 
         return loop_iter, length
 
 
+def _count_stopindex(
+    it: Iterator[Any], context: Context, offset_key: str
+) -> Iterator[Any]:
+    """Yield items from an iterator of unknown length, recording the number of items
+    consumed so far as the stop index for ``offset_key``.
+
+    Unlike loops over sequences, a loop over an iterable of unknown length that is
+    exited early with ``break`` records the number of items it consumed, not the number
+    it would have consumed.
+    """
+    context.stopindex(key=offset_key, index=0)
+    count = 0
+    for item in it:
+        count += 1
+        context.stopindex(key=offset_key, index=count)
+        yield item
+
+
+def _iter_lazy(
+    obj: abc.Iterable[Any], offset: int, limit: Optional[int], reversed_: bool
+) -> Tuple[Iterator[Any], Optional[int]]:
+    """Return an iterator over an iterable that is not a sequence or mapping, and the
+    number of items it will yield, or ``None`` if that can't be known without
+    consuming the iterable.
+
+    Offset and limit are pushed down to objects that support slicing, like database
+    query sets, so only the requested window is fetched.
+    """
+    stop = None if limit is None else offset + max(limit, 0)
+
+    if offset or stop is not None:
+        try:
+            obj = obj[offset:stop]  # type: ignore
+        except (TypeError, KeyError, ValueError, AttributeError):
+            if isinstance(obj, abc.Sized):
+                size = max(len(obj) - offset, 0)
+                length: Optional[int] = size if limit is None else min(size, limit)
+            else:
+                length = None
+            it: Iterator[Any] = islice(iter(obj), offset, stop)
+        else:
+            length = len(obj) if isinstance(obj, abc.Sized) else None
+            it = iter(obj)
+    else:
+        length = len(obj) if isinstance(obj, abc.Sized) else None
+        it = iter(obj)
+
+    if reversed_:
+        items = list(it)
+        items.reverse()
+        return iter(items), len(items)
+
+    return it, length
+
+
 Number = Union[int, float]
 
 
@@ -11,6 +11,7 @@ from functools import wraps
 from typing import Tuple
 from typing import Any
 from typing import Callable
+from typing import NamedTuple
 from typing import Union
 from typing import Optional
 from typing import TYPE_CHECKING
@@ -27,6 +28,25 @@ if TYPE_CHECKING:
     N = Union[float, int]
 
 
+class BoundFilter(NamedTuple):
+    """A filter function bound to an :class:`liquid.Environment`.
+
+    :param filter: The filter function as it was registered with the environment.
+    :param func: The filter function to call. If the registered filter function was
+        decorated with ``with_environment``, ``func`` has the environment bound to its
+        ``environment`` argument.
+    :param with_context: If ``True``, ``func`` must be called with the active render
+        context as the named argument ``context``.
+    :param memoize: If ``True``, results from ``func`` can be reused for the rest of a
+        render, for the same input object and argument values.
+    """
+
+    filter: Callable[..., Any]
+    func: Callable[..., Any]
+    with_context: bool
+    memoize: bool = False
+
+
 def with_context(_filter: FilterT) -> FilterT:
     """Pass the active :class:`liquid.context.Context` as the named argument
     ``context`` to the decorated filter function.
@@ -49,6 +69,37 @@ def with_environment(_filter: FilterT) -> FilterT:
     return _filter
 
 
+def pure(_filter: FilterT) -> FilterT:
+    """Mark the decorated filter function as pure.
+
+    A pure filter function always returns the same result given the same arguments,
+    and has no side effects. When an environment is configured to optimize parse
+    trees, filters marked as pure might be evaluated at parse time if their input
+    and arguments are all literals.
+
+    :param _filter: The filter function to decorate.
+    :type _filter: Callable[..., Any]
+    """
+    _filter.pure = True  # type: ignore
+    return _filter
+
+
+def memoize(_filter: FilterT) -> FilterT:
+    """Mark the decorated filter function as pure, and worth memoizing.
+
+    Results are reused for the rest of a render when the filter is applied to the same
+    object, by identity, with the same string, number, boolean or ``nil`` arguments.
+    Use it for filters that are expensive compared to a dictionary lookup, like
+    sorting or searching an array.
+
+    :param _filter: The filter function to decorate.
+    :type _filter: Callable[..., Any]
+    """
+    _filter.pure = True  # type: ignore
+    _filter.memoize = True  # type: ignore
+    return _filter
+
+
 def string_filter(_filter: FilterT) -> FilterT:
     """A filter function decorator that converts the first positional argument to a
     string."""
@@ -0,0 +1,131 @@
+"""Caches for rendered template fragments.
+
+A fragment cache stores the output of ``{% cache %}`` blocks, so identical
+fragments, like navigation menus and footers, don't need to be rendered again for
+every request. The in-process :class:`LRUFragmentCache` is used by default. Implement
+:class:`FragmentCache` to share fragments between processes using memcached, Redis or
+similar.
+"""
+from __future__ import annotations
+
+import hashlib
+import time
+
+from abc import ABC
+from abc import abstractmethod
+
+from typing import Iterable
+from typing import Optional
+from typing import Tuple
+
+from liquid.utils import LRUCache
+from liquid.utils import CacheInfo
+
+
+class FragmentCache(ABC):
+    """Base class for all rendered fragment caches.
+
+    Subclasses must implement ``get`` and ``set``. Those with an async client can
+    override ``get_async`` and ``set_async`` too, which are used when rendering
+    asynchronously. For example, a cache using Redis might look like this.
+
+    .. code-block:: python
+
+        class RedisFragmentCache(FragmentCache):
+            def __init__(self, client, prefix="liquid:fragment:"):
+                self.client = client
+                self.prefix = prefix
+
+            def get(self, key):
+                data = self.client.get(self.prefix + key)
+                return None if data is None else data.decode("utf-8")
+
+            def set(self, key, value, ttl=None):
+                self.client.set(self.prefix + key, value.encode("utf-8"), ex=ttl)
+    """
+
+    @abstractmethod
+    def get(self, key: str) -> Optional[str]:
+        """Return the rendered fragment stored with the given key, or ``None`` if the
+        key does not exist or has expired."""
+
+    @abstractmethod
+    def set(self, key: str, value: str, ttl: Optional[float] = None) -> None:
+        """Store a rendered fragment with the given key.
+
+        :param ttl: The number of seconds the fragment is valid for, or ``None`` if
+            it does not expire.
+        """
+
+    async def get_async(self, key: str) -> Optional[str]:
+        """An async version of :meth:`get`. Defaults to calling :meth:`get`."""
+        return self.get(key)
+
+    async def set_async(
+        self, key: str, value: str, ttl: Optional[float] = None
+    ) -> None:
+        """An async version of :meth:`set`. Defaults to calling :meth:`set`."""
+        self.set(key, value, ttl)
+
+    def clear(self) -> None:
+        """Remove all fragments from the cache. The default implementation does
+        nothing."""
+
+    def key(self, digest: str, parts: Iterable[object]) -> str:
+        """Return a cache key for a block with the given digest and evaluated key
+        expressions.
+
+        Key expression values are converted to strings, so objects used as keys
+        should have a string representation that changes when they do, like a
+        timestamp or version number.
+        """
+        hash_ = hashlib.sha256(digest.encode("utf-8", "surrogatepass"))
+        for part in parts:
+            hash_.update(b"\0")
+            hash_.update(str(part).encode("utf-8", "surrogatepass"))
+        return hash_.hexdigest()
+
+
+def _fragment_size(item: Tuple[Optional[float], str]) -> int:
+    return len(item[1])
+
+
+class LRUFragmentCache(FragmentCache):
+    """An in-process fragment cache that discards the least recently used fragments
+    when it is full.
+
+    :param capacity: The maximum number of fragments to keep. Defaults to ``300``.
+    :type capacity: int
+    :param max_size: The maximum total number of characters in cached fragments, or
+        ``None`` for no limit. Defaults to ``None``.
+    :type max_size: Optional[int]
+    """
+
+    def __init__(self, capacity: int = 300, max_size: Optional[int] = None):
+        self.cache = LRUCache(
+            capacity,
+            max_weight=max_size,
+            weigh=_fragment_size,
+        )
+
+    def get(self, key: str) -> Optional[str]:
+        item: Optional[Tuple[Optional[float], str]] = self.cache.get(key)
+        if item is None:
+            return None
+
+        expires, value = item
+        if expires is not None and expires <= time.monotonic():
+            self.cache.pop(key, None)
+            return None
+        return value
+
+    def set(self, key: str, value: str, ttl: Optional[float] = None) -> None:
+        expires = None if ttl is None else time.monotonic() + ttl
+        self.cache[key] = (expires, value)
+
+    def clear(self) -> None:
+        self.cache.clear()
+
+    def cache_info(self) -> CacheInfo:
+        """Return hit, miss and eviction counts for the underlying cache."""
+        return self.cache.cache_info()
@@ -0,0 +1,102 @@
+"""Render a template into a layout template, like a theme, without rendering it to
+a string first.
+
+Pass a :class:`LayoutContent` to the layout template as ``content_for_layout``. When
+the layout reaches ``{{ content_for_layout }}``, the content template is rendered
+with the layout's render context, directly to the layout's output buffer.
+
+.. code-block:: python
+
+    from liquid import Environment
+    from liquid import FileSystemLoader
+    from liquid.layout import LayoutContent
+
+    env = Environment(loader=FileSystemLoader("templates/"))
+    theme = env.get_template("theme.liquid")
+    page = env.get_template("index.liquid")
+
+    for chunk in theme.render_stream(content_for_layout=LayoutContent(page), **data):
+        ...
+
+When streaming, output from the layout is flushed before its content is rendered.
+"""
+from __future__ import annotations
+
+from typing import Any
+from typing import AsyncIterator
+from typing import Iterator
+from typing import Optional
+from typing import TextIO
+from typing import TYPE_CHECKING
+
+if TYPE_CHECKING:  # pragma: no cover
+    from liquid.context import Context
+    from liquid.template import BoundTemplate
+
+
+class LayoutContent:
+    """A template to be rendered in place of ``{{ content_for_layout }}``.
+
+    The content template can see all of the layout's variables, plus any
+    ``args`` and ``kwargs``, which are passed to the :class:`dict` constructor. Used
+    with filters, like ``{{ content_for_layout | strip }}``, the content template is
+    rendered to a string first, with just ``args`` and ``kwargs``.
+
+    :param template: The content template.
+    :type template: liquid.template.BoundTemplate
+    """
+
+    __slots__ = ("template", "args", "kwargs")
+
+    def __init__(self, template: BoundTemplate, *args: Any, **kwargs: Any):
+        self.template = template
+        self.args = args
+        self.kwargs = kwargs
+
+    def __str__(self) -> str:
+        return self.template.render(*self.args, **self.kwargs)
+
+    def __repr__(self) -> str:  # pragma: no cover
+        return f"LayoutContent(template={self.template!r})"
+
+    def render_with_context(self, context: Context, buffer: TextIO) -> None:
+        """Render the content template to the layout's output buffer."""
+        self.template.render_with_context(context, buffer, *self.args, **self.kwargs)
+
+    async def render_with_context_async(
+        self, context: Context, buffer: TextIO
+    ) -> None:
+        """An async version of :meth:`LayoutContent.render_with_context`."""
+        if context.prefetcher is None:
+            await self.template.render_with_context_async(
+                context, buffer, *self.args, **self.kwargs
+            )
+            return
+
+        # Rendering a whole template would cancel the layout's prefetched lookups.
+        async for _ in self.render_statements_async(context, buffer):
+            pass
+
+    def render_statements(
+        self, context: Context, buffer: TextIO
+    ) -> Iterator[Optional[bool]]:
+        """Render the content template's top-level statements to the layout's output
+        buffer, yielding ``False`` after each statement or ``True`` if output
+        should be flushed."""
+        namespace = self.template._make_globals(  # pylint: disable=protected-access
+            False, self.args, self.kwargs
+        )
+        with context.extend(namespace=namespace, fixed_keys=True):
+            for flush in self.template.render_statements(context, buffer):
+                yield flush or False
+
+    async def render_statements_async(
+        self, context: Context, buffer: TextIO
+    ) -> AsyncIterator[Optional[bool]]:
+        """An async version of :meth:`LayoutContent.render_statements`."""
+        namespace = self.template._make_globals(  # pylint: disable=protected-access
+            False, self.args, self.kwargs
+        )
+        with context.extend(namespace=namespace, fixed_keys=True):
+            async for flush in self.template.render_statements_async(context, buffer):
+                yield flush or False
@@ -222,13 +222,23 @@ def compile_liquid_rules(
     stmt_s = re.escape(statement_start_string)
     stmt_e = re.escape(statement_end_string)
 
+    # Literal text is consumed in runs of characters that can't start a tag or
+    # statement, rather than checking for a delimiter after every character.
+    stop = "".join(
+        re.escape(c) for c in sorted({tag_start_string[0], statement_start_string[0]})
+    )
+
     liquid_rules = [
         ("RAW", rf"{tag_s}\s*raw\s*{tag_e}(?P<raw>.*?){tag_s}\s*endraw\s*{tag_e}"),
         (TOKEN_STATEMENT, rf"{stmt_s}-?\s*(?P<stmt>.*?)\s*(?P<rss>-?){stmt_e}"),
         # The "name" group is zero or more characters so that a malformed tag (one
         # with no name) does not get treated as a literal.
         ("TAG", rf"{tag_s}-?\s*(?P<name>\w*)\s*(?P<expr>.*?)\s*(?P<rst>-?){tag_e}"),
-        (TOKEN_LITERAL, rf".+?(?=(({tag_s}|{stmt_s})(?P<rstrip>-?))|$)"),
+        (
+            TOKEN_LITERAL,
+            rf".(?:[^{stop}]+|(?!{tag_s}|{stmt_s}).)*"
+            rf"(?=({tag_s}|{stmt_s})(?P<rstrip>-?))?",
+        ),
     ]
 
     return _compile_rules(liquid_rules)
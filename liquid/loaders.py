@@ -7,10 +7,12 @@ from __future__ import annotations
 
 import asyncio
 import os
+import threading
 
 from abc import ABC
 
 from collections import abc
+from concurrent.futures import ThreadPoolExecutor
 from functools import partial
 from pathlib import Path
 
@@ -19,8 +21,11 @@ from typing import NamedTuple
 from typing import Callable
 from typing import Dict
 from typing import Iterable
+from typing import List
 from typing import Mapping
 from typing import Optional
+from typing import Sequence
+from typing import Set
 from typing import Tuple
 from typing import Union
 from typing import TYPE_CHECKING
@@ -68,6 +73,42 @@ class BaseLoader(ABC):
         """ """
         return self.get_source(env, template_name)
 
+    async def get_sources_async(
+        self,
+        env: Environment,
+        template_names: Sequence[str],
+    ) -> Dict[str, TemplateSource]:
+        """Get template sources for many templates at once.
+
+        Used by :meth:`liquid.Environment.get_template_async` to load partial templates
+        when ``preload_partials`` is enabled. The default implementation awaits
+        ``get_source_async`` for each name concurrently.
+
+        :returns: A mapping of template names to template sources. Templates that
+            can't be found are not included.
+        """
+        results = await asyncio.gather(
+            *(self.get_source_async(env, name) for name in template_names),
+            return_exceptions=True,
+        )
+
+        sources: Dict[str, TemplateSource] = {}
+        for name, result in zip(template_names, results):
+            if isinstance(result, BaseException):
+                if not isinstance(result, Exception):
+                    raise result
+            else:
+                sources[name] = result
+        return sources
+
+    def list_templates(self) -> List[str]:
+        """Return a list of names of all templates available to this loader.
+
+        Used by :meth:`liquid.Environment.preload`. Not all loaders can list their
+        templates. The default implementation raises a ``NotImplementedError``.
+        """
+        raise NotImplementedError("this loader can't list its templates")
+
     # pylint: disable=redefined-builtin
     def load(
         self,
@@ -76,15 +117,11 @@ class BaseLoader(ABC):
         globals: Optional[Mapping[str, object]] = None,
     ) -> BoundTemplate:
         try:
-            source, filename, uptodate = self.get_source(env, name)
+            template_source = self.get_source(env, name)
         except Exception as err:
             raise TemplateNotFound(name) from err
 
-        template = env.from_string(
-            source, globals=globals, name=name, path=Path(filename)
-        )
-        template.uptodate = uptodate
-        return template
+        return self.load_from_source(env, name, template_source, globals=globals)
 
     async def load_async(
         self,
@@ -94,10 +131,27 @@ class BaseLoader(ABC):
     ) -> BoundTemplate:
         try:
             template_source = await self.get_source_async(env, name)
-            source, filename, uptodate = template_source
         except Exception as err:
             raise TemplateNotFound(name) from err
 
+        return self.load_from_source(env, name, template_source, globals=globals)
+
+    def load_from_source(
+        self,
+        env: Environment,
+        name: str,
+        template_source: TemplateSource,
+        globals: Optional[Mapping[str, object]] = None,
+    ) -> BoundTemplate:
+        """Parse a template source from this loader's ``get_source`` or
+        ``get_sources_async`` methods.
+
+        Used by ``load``, ``load_async`` and, for templates fetched in batches, by
+        :meth:`liquid.Environment.get_template_async` when ``preload_partials`` is
+        enabled. Loaders that need to change the templates they load, for example by
+        adding globals, should override this method rather than ``load``.
+        """
+        source, filename, uptodate = template_source
         template = env.from_string(
             source, globals=globals, name=name, path=Path(filename)
         )
@@ -145,6 +199,27 @@ class FileSystemLoader(BaseLoader):
             source = fd.read()
         return source, source_path.stat().st_mtime
 
+    def _resolve_and_read(self, template_name: str) -> Tuple[Path, str, float]:
+        source_path = self._resolve_path(template_name)
+        return (source_path, *self._read(source_path))
+
+    def list_templates(self) -> List[str]:
+        """Return a sorted list of names of all files in the search path, relative to
+        the search path directory they were found in.
+
+        Hidden files and directories, those with a name starting with a dot, are not
+        listed. If the same name appears in more than one directory, it is listed once.
+        """
+        names = set()
+        for path in self.search_path:
+            for root, dirnames, filenames in os.walk(path):
+                # Don't descend into hidden directories, like `.git`.
+                dirnames[:] = [name for name in dirnames if not name.startswith(".")]
+                for filename in filenames:
+                    if not filename.startswith("."):
+                        names.add(Path(root, filename).relative_to(path).as_posix())
+        return sorted(names)
+
     def get_source(self, _: Environment, template_name: str) -> TemplateSource:
         source_path = self._resolve_path(template_name)
         source, mtime = self._read(source_path)
@@ -163,14 +238,11 @@ class FileSystemLoader(BaseLoader):
     async def get_source_async(
         self, env: Environment, template_name: str
     ) -> TemplateSource:
-        loop = asyncio.get_running_loop()
-
-        source_path = await loop.run_in_executor(
-            None, self._resolve_path, template_name
+        # One trip to the thread pool per template.
+        source_path, source, mtime = await asyncio.get_running_loop().run_in_executor(
+            None, self._resolve_and_read, template_name
         )
 
-        source, mtime = await loop.run_in_executor(None, self._read, source_path)
-
         return TemplateSource(
             source, str(source_path), partial(self._uptodate, source_path, mtime)
         )
@@ -197,3 +269,114 @@ class DictLoader(BaseLoader):
             raise TemplateNotFound(template_name) from err
 
         return TemplateSource(source, template_name, None)
+
+    def list_templates(self) -> List[str]:
+        return sorted(self.templates)
+
+
+class BatchLoader(BaseLoader):
+    """Base class for async loaders that can fetch many template sources with one
+    request, like loaders for a remote file store, HTTP service or database.
+
+    Subclasses implement :meth:`get_sources_async`. Calls to ``get_source_async`` that
+    are made before the event loop next gets a chance to run, like those from
+    ``render`` tags being rendered concurrently, are combined into a single call to
+    :meth:`get_sources_async`. Calls from different event loops, like those of threads
+    rendering with their own event loop, are fetched in separate batches.
+
+    Templates loaded synchronously, with ``Environment.get_template`` or when
+    rendering with ``render``, are fetched one at a time, by running
+    :meth:`get_sources_async` in a new event loop. Subclasses using clients that are
+    bound to an event loop, like many connection pools, should implement
+    ``get_source`` too, or only be used asynchronously.
+    """
+
+    def __init__(self) -> None:
+        # Names of templates waiting to be fetched, for each environment and event
+        # loop. Futures can only be resolved from the loop they belong to.
+        self._pending: Dict[
+            Tuple[Environment, asyncio.AbstractEventLoop],
+            Dict[str, asyncio.Future[Optional[TemplateSource]]],
+        ] = {}
+        self._lock = threading.Lock()
+
+        # The event loop only keeps weak references to tasks.
+        self._tasks: Set[asyncio.Future[None]] = set()
+
+    async def get_sources_async(
+        self,
+        env: Environment,
+        template_names: Sequence[str],
+    ) -> Dict[str, TemplateSource]:
+        """Fetch template sources for all of the given names at once.
+
+        :returns: A mapping of template names to template sources. Templates that
+            can't be found are not included.
+        """
+        raise NotImplementedError(
+            "batch loaders must implement a get_sources_async method"
+        )
+
+    def get_source(self, env: Environment, template_name: str) -> TemplateSource:
+        coro = self.get_sources_async(env, [template_name])
+        try:
+            asyncio.get_running_loop()
+        except RuntimeError:
+            sources = asyncio.run(coro)
+        else:
+            # Called synchronously from a coroutine. We can't run another event loop
+            # in this thread.
+            with ThreadPoolExecutor(max_workers=1) as executor:
+                sources = executor.submit(asyncio.run, coro).result()
+
+        source = sources.get(template_name)
+        if source is None:
+            raise TemplateNotFound(template_name)
+        return source
+
+    async def get_source_async(
+        self,
+        env: Environment,
+        template_name: str,
+    ) -> TemplateSource:
+        loop = asyncio.get_running_loop()
+        key = (env, loop)
+
+        with self._lock:
+            pending = self._pending.get(key)
+            if pending is None:
+                pending = self._pending[key] = {}
+                loop.call_soon(self._dispatch, key)
+
+            future = pending.get(template_name)
+            if future is None:
+                future = pending[template_name] = loop.create_future()
+
+        source = await asyncio.shield(future)
+        if source is None:
+            raise TemplateNotFound(template_name)
+        return source
+
+    def _dispatch(self, key: Tuple[Environment, asyncio.AbstractEventLoop]) -> None:
+        with self._lock:
+            pending = self._pending.pop(key)
+        task = asyncio.ensure_future(self._fetch(key[0], pending))
+        self._tasks.add(task)
+        task.add_done_callback(self._tasks.discard)
+
+    async def _fetch(
+        self,
+        env: Environment,
+        pending: Dict[str, asyncio.Future[Optional[TemplateSource]]],
+    ) -> None:
+        try:
+            sources = await self.get_sources_async(env, list(pending))
+        except Exception as err:  # pylint: disable=broad-except
+            for future in pending.values():
+                if not future.done():
+                    future.set_exception(err)
+            return
+
+        for name, future in pending.items():
+            if not future.done():
+                future.set_result(sources.get(name))
@@ -0,0 +1,420 @@
+"""An optional optimization pass over parse trees.
+
+The optimizer rewrites a freshly parsed tree so that it renders the same output with
+less work. It merges adjacent template literals, evaluates filtered expressions that
+depend only on literals and pure filters, and removes ``if``, ``unless`` and ``case``
+branches with constant conditions.
+
+Enable it by passing ``optimize=True`` to a new :class:`liquid.Environment`.
+"""
+from __future__ import annotations
+
+from typing import Callable
+from typing import Dict
+from typing import List
+from typing import Optional
+from typing import Tuple
+from typing import Type
+from typing import TYPE_CHECKING
+
+try:
+    from markupsafe import Markup
+except ImportError:
+    from liquid.exceptions import Markup  # type: ignore
+
+from liquid.ast import BlockNode
+from liquid.ast import ConditionalBlockNode
+from liquid.ast import Node
+from liquid.ast import ParseTree
+
+from liquid.builtin.literal import LiteralNode
+from liquid.builtin.statement import StatementNode
+from liquid.builtin.statement import to_liquid_string
+from liquid.builtin.tags.assign_tag import AssignNode
+from liquid.builtin.tags.capture_tag import CaptureNode
+from liquid.builtin.tags.case_tag import CaseNode
+from liquid.builtin.tags.comment_tag import CommentNode
+from liquid.builtin.tags.echo_tag import EchoNode
+from liquid.builtin.tags.for_tag import ForNode
+from liquid.builtin.tags.if_tag import IfNode
+from liquid.builtin.tags.ifchanged_tag import IfChangedNode
+from liquid.builtin.tags.liquid_tag import LiquidNode
+from liquid.builtin.tags.tablerow_tag import TablerowNode
+from liquid.builtin.tags.unless_tag import UnlessNode
+
+from liquid.context import Context
+from liquid.exceptions import NoSuchFilterFunc
+
+from liquid.expression import AssignmentExpression
+from liquid.expression import Blank
+from liquid.expression import BooleanExpression
+from liquid.expression import Empty
+from liquid.expression import Expression
+from liquid.expression import FilteredExpression
+from liquid.expression import IdentifierPathElement
+from liquid.expression import InfixExpression
+from liquid.expression import Literal
+from liquid.expression import Nil
+from liquid.expression import PrefixExpression
+
+from liquid.token import Token
+from liquid.token import TOKEN_LITERAL
+
+if TYPE_CHECKING:  # pragma: no cover
+    from liquid import Environment
+
+# Filter results of these types can be stored in a parse tree without fear of them
+# being modified by a later render.
+IMMUTABLE_TYPES = (str, int, float, bool, type(None), Markup)
+
+# Returned from `Optimizer.constant` when an expression's value can't be known until
+# render time.
+_UNKNOWN = object()
+
+
+def optimize(tree: ParseTree, env: Environment) -> ParseTree:
+    """Optimize the given parse tree, in place, for rendering with the given
+    environment.
+
+    Filters must be registered with the environment before templates are parsed.
+    Replacing a pure filter after parsing will not change the output of templates
+    that have already been optimized.
+
+    :param tree: A parse tree, as returned from :meth:`liquid.Environment.parse`.
+    :type tree: liquid.ast.ParseTree
+    :param env: The environment the parse tree was parsed for.
+    :type env: liquid.Environment
+    :returns: The optimized parse tree.
+    :rtype: liquid.ast.ParseTree
+    """
+    tree.statements = Optimizer(env).visit_statements(tree.statements)
+    return tree
+
+
+def is_constant(expr: Expression) -> bool:
+    """Return ``True`` if the given expression is built only from literals, so its
+    value does not depend on render context data."""
+    if isinstance(expr, (Nil, Empty, Blank)):
+        return True
+    if isinstance(expr, Literal):
+        return not isinstance(expr, IdentifierPathElement)
+    if isinstance(expr, BooleanExpression):
+        return is_constant(expr.expression)
+    if isinstance(expr, PrefixExpression):
+        return is_constant(expr.right)
+    if isinstance(expr, InfixExpression):
+        return is_constant(expr.left) and is_constant(expr.right)
+    if isinstance(expr, FilteredExpression):
+        return not expr.filters and is_constant(expr.expression)
+    return False
+
+
+class Optimizer:
+    """Parse tree rewriting visitor. Nodes from custom tags are left as they are."""
+
+    def __init__(self, env: Environment):
+        self.env = env
+
+        # A render context without any data, for evaluating constant expressions.
+        self.context = Context(env)
+
+        self.visitors: Dict[Type[Node], Callable[[Node], Optional[Node]]] = {
+            CommentNode: self.visit_comment,
+            StatementNode: self.visit_statement,
+            EchoNode: self.visit_echo,
+            AssignNode: self.visit_assign,
+            IfNode: self.visit_if,
+            UnlessNode: self.visit_unless,
+            CaseNode: self.visit_case,
+            ForNode: self.visit_for,
+            TablerowNode: self.visit_nested_block,
+            CaptureNode: self.visit_nested_block,
+            IfChangedNode: self.visit_nested_block,
+            LiquidNode: self.visit_nested_block,
+        }
+
+    def visit(self, node: Node) -> Optional[Node]:
+        """Return an optimized version of the given node, or ``None`` if the node
+        can be removed."""
+        visitor = self.visitors.get(node.__class__)
+        if visitor is None:
+            return node
+        return visitor(node)
+
+    def visit_statements(self, statements: List[Node]) -> List[Node]:
+        """Return an optimized list of statements."""
+        optimized: List[Node] = []
+
+        for stmt in statements:
+            node = self.visit(stmt)
+            if node is None:
+                continue
+
+            if node.__class__ is BlockNode:
+                # A block that took the place of a pruned conditional tag. If the
+                # block is all literals, its output is known now.
+                literal = self.fold_block(node)  # type: ignore
+                if literal is not None:
+                    if literal.tok.value:
+                        optimized.append(literal)
+                    continue
+
+            optimized.append(node)
+
+        return self.merge_literals(optimized)
+
+    def visit_block(self, block: BlockNode) -> BlockNode:
+        """Optimize the statements in the given block, in place."""
+        block.statements = self.visit_statements(block.statements)
+        return block
+
+    def visit_nested_block(self, node: Node) -> Node:
+        """Optimize a tag's block without changing the tag itself."""
+        self.visit_block(node.block)  # type: ignore
+        return node
+
+    def visit_comment(self, _: Node) -> None:
+        # Comments don't render anything. Removing them lets us merge the literals
+        # either side.
+        return None
+
+    def visit_for(self, node: ForNode) -> Node:  # type: ignore
+        self.visit_block(node.block)
+        if node.default:
+            self.visit_block(node.default)
+        return node
+
+    def visit_statement(self, node: StatementNode) -> Node:  # type: ignore
+        expr = self.fold(node.expression)
+
+        if is_constant(expr):
+            try:
+                val = expr.evaluate(self.context)
+            except Exception:  # pylint: disable=broad-except
+                pass
+            else:
+                return LiteralNode(
+                    Token(
+                        node.tok.linenum,
+                        TOKEN_LITERAL,
+                        to_liquid_string(val, self.env.autoescape),
+                    )
+                )
+
+        if expr is not node.expression:
+            return StatementNode(node.tok, expr)
+        return node
+
+    def visit_echo(self, node: EchoNode) -> Node:  # type: ignore
+        # Echo nodes are not replaced with literals, so disabled "echo" tags are still
+        # detected at render time.
+        expr = self.fold(node.expression)
+        if expr is not node.expression:
+            return EchoNode(node.tok, expr)
+        return node
+
+    def visit_assign(self, node: AssignNode) -> Node:  # type: ignore
+        expr = self.fold(node.expression.expression)
+        if expr is not node.expression.expression:
+            return AssignNode(node.tok, AssignmentExpression(node.expression.name, expr))
+        return node
+
+    def visit_if(self, node: IfNode) -> Optional[Node]:  # type: ignore
+        branches = [(node.tok, node.condition, node.consequence)]
+        branches.extend(
+            (alt.tok, alt.condition, alt.block) for alt in node.conditional_alternatives
+        )
+
+        remaining, alternative = self.prune(branches, node.alternative)
+
+        if not remaining:
+            return alternative
+
+        if len(remaining) == len(branches) and alternative is node.alternative:
+            return node
+
+        _, condition, consequence = remaining[0]
+        return IfNode(
+            tok=node.tok,
+            condition=condition,
+            consequence=consequence,
+            conditional_alternatives=[
+                ConditionalBlockNode(tok, condition=condition, block=block)
+                for tok, condition, block in remaining[1:]
+            ],
+            alternative=alternative,
+        )
+
+    def visit_unless(self, node: UnlessNode) -> Optional[Node]:  # type: ignore
+        self.visit_block(node.consequence)
+        value = self.constant(node.condition)
+
+        if value is _UNKNOWN:
+            return node
+        if value:
+            return None
+        return node.consequence
+
+    def visit_case(self, node: CaseNode) -> Optional[Node]:  # type: ignore
+        branches = [(when.tok, when.condition, when.block) for when in node.whens]
+        remaining, default = self.prune(branches, node.default)
+
+        if not remaining:
+            return default
+
+        if len(remaining) == len(branches) and default is node.default:
+            return node
+
+        return CaseNode(
+            node.tok,
+            whens=[
+                ConditionalBlockNode(tok, condition=condition, block=block)
+                for tok, condition, block in remaining
+            ],
+            default=default,
+        )
+
+    def prune(
+        self,
+        branches: List[Tuple[Token, Expression, BlockNode]],
+        alternative: Optional[BlockNode],
+    ) -> Tuple[List[Tuple[Token, Expression, BlockNode]], Optional[BlockNode]]:
+        """Remove conditional branches that can never be rendered.
+
+        Returns a list of branches that need to be evaluated at render time and the
+        block to render if none of them are truthy. If the list is empty, the block is
+        always rendered.
+        """
+        remaining = []
+
+        for tok, condition, block in branches:
+            self.visit_block(block)
+            value = self.constant(condition)
+
+            if value is _UNKNOWN:
+                remaining.append((tok, condition, block))
+            elif value:
+                # Any branches after a constant truthy condition are unreachable.
+                return remaining, block
+
+        if alternative:
+            self.visit_block(alternative)
+        return remaining, alternative
+
+    def constant(self, expr: Expression) -> object:
+        """Return the value of the given expression, or ``_UNKNOWN`` if its value
+        depends on render context data."""
+        if not is_constant(expr):
+            return _UNKNOWN
+
+        try:
+            return expr.evaluate(self.context)
+        except Exception:  # pylint: disable=broad-except
+            # Leave it for render time, where the error will be handled according to
+            # the environment's tolerance mode.
+            return _UNKNOWN
+
+    def fold(self, expr: Expression) -> Expression:
+        """Return a new expression with the longest run of pure filters applied to a
+        literal already evaluated, or ``expr`` unchanged if no filters can be
+        applied now.
+
+        Expressions are never modified in place. Filters that raise an exception are
+        left for render time.
+        """
+        if expr.__class__ is not FilteredExpression or not is_constant(
+            expr.expression  # type: ignore
+        ):
+            return expr
+
+        assert isinstance(expr, FilteredExpression)
+        context = self.context
+
+        try:
+            value = expr.expression.evaluate(context)
+        except Exception:  # pylint: disable=broad-except
+            return expr
+
+        folded = 0
+        result = value
+
+        for i, fltr in enumerate(expr.filters):
+            if not all(is_constant(arg) for arg in fltr.args) or not all(
+                is_constant(arg) for arg in fltr.kwargs.values()
+            ):
+                break
+
+            try:
+                bound = self.env.get_filter(fltr.name)
+            except NoSuchFilterFunc:
+                break
+
+            if not getattr(bound.filter, "pure", False) or bound.with_context:
+                break
+
+            try:
+                value = bound.func(
+                    value,
+                    *fltr.evaluate_args(context),
+                    **fltr.evaluate_kwargs(context),
+                )
+            except Exception:  # pylint: disable=broad-except
+                break
+
+            # Intermediate results, like lists from `split`, are fine as long as a
+            # later filter turns them into something immutable.
+            if isinstance(value, IMMUTABLE_TYPES):
+                folded = i + 1
+                result = value
+
+        if not folded:
+            return expr
+        return FilteredExpression(Literal(result), expr.filters[folded:])
+
+    def fold_block(self, block: BlockNode) -> Optional[LiteralNode]:
+        """Return a literal node equivalent to the given block, or ``None`` if the
+        block contains anything other than literals."""
+        if not all(stmt.__class__ is LiteralNode for stmt in block.statements):
+            return None
+
+        val = "".join(stmt.tok.value for stmt in block.statements)  # type: ignore
+
+        # Blocks containing only whitespace don't render anything.
+        if val.isspace():
+            val = ""
+
+        return LiteralNode(Token(block.tok.linenum, TOKEN_LITERAL, val))
+
+    @staticmethod
+    def merge_literals(statements: List[Node]) -> List[Node]:
+        """Return a list of statements with adjacent literal nodes merged into one,
+        and empty literals removed."""
+        merged: List[Node] = []
+        run: List[LiteralNode] = []
+
+        def flush() -> None:
+            if len(run) == 1:
+                merged.append(run[0])
+            elif run:
+                tok = run[0].tok
+                merged.append(
+                    LiteralNode(
+                        Token(
+                            tok.linenum,
+                            TOKEN_LITERAL,
+                            "".join(node.tok.value for node in run),
+                        )
+                    )
+                )
+            run.clear()
+
+        for stmt in statements:
+            if stmt.__class__ is LiteralNode:
+                if stmt.tok.value:  # type: ignore
+                    run.append(stmt)  # type: ignore
+            else:
+                flush()
+                merged.append(stmt)
+
+        flush()
+        return merged
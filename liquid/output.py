@@ -0,0 +1,102 @@
+"""Output buffers for rendering templates.
+
+Rendering to a :class:`io.StringIO` and encoding the result copies the output twice.
+A :class:`BytesBuffer` encodes dynamic output as it goes, and keeps the bytes of
+long template literals, which are encoded once per template, by reference.
+
+A :class:`SegmentBuffer` collects text that is used once it has all been rendered,
+like the output of a ``capture`` block, without copying it.
+"""
+from typing import List
+
+
+class BytesBuffer:
+    """A write-only text buffer that collects encoded output as a list of byte
+    strings.
+
+    Consecutive writes are joined and encoded together, so the number of byte strings
+    stays low, even when templates write lots of small pieces of text. Template
+    literals that are at least ``literal_threshold`` bytes long are appended as they
+    are, without being copied.
+
+    :param encoding: The encoding used to convert written text to bytes. Template
+        literals are only pre-encoded for UTF-8. Defaults to ``"utf-8"``.
+    :type encoding: str
+    :param errors: How encoding errors are handled, as understood by
+        :meth:`str.encode`. Defaults to ``"strict"``.
+    :type errors: str
+    """
+
+    __slots__ = ("encoding", "errors", "utf8", "_buffers", "_pending")
+
+    # The minimum length of pre-encoded template literal bytes that will be kept as a
+    # separate buffer. Shorter literals are encoded with surrounding text.
+    literal_threshold = 512
+
+    def __init__(self, encoding: str = "utf-8", errors: str = "strict"):
+        self.encoding = encoding
+        self.errors = errors
+        self.utf8 = encoding.lower().replace("_", "-") in ("utf-8", "utf8")
+        self._buffers: List[bytes] = []
+        self._pending: List[str] = []
+
+    def write(self, text: str) -> int:
+        """Write text to the buffer. Return the number of characters written."""
+        self._pending.append(text)
+        return len(text)
+
+    def write_bytes(self, data: bytes) -> int:
+        """Write bytes, already encoded with this buffer's encoding, to the buffer.
+        Return the number of bytes written."""
+        if self._pending:
+            self._flush()
+        self._buffers.append(data)
+        return len(data)
+
+    def write_literal(self, text: str, data: bytes) -> None:
+        """Write template literal text, given the same text encoded as UTF-8. The
+        encoded text is used if it is long enough to be worth keeping separate."""
+        if self.utf8 and len(data) >= self.literal_threshold:
+            self.write_bytes(data)
+        else:
+            self._pending.append(text)
+
+    def _flush(self) -> None:
+        self._buffers.append(
+            "".join(self._pending).encode(self.encoding, self.errors)
+        )
+        self._pending.clear()
+
+    def getbuffers(self) -> List[bytes]:
+        """Return a list of byte strings that make up the output written so far,
+        suitable for passing to :func:`os.writev` or :meth:`socket.socket.sendmsg`."""
+        if self._pending:
+            self._flush()
+        return list(self._buffers)
+
+    def getvalue(self) -> bytes:
+        """Return the output written so far as a single byte string."""
+        buffers = self.getbuffers()
+        if len(buffers) == 1:
+            return buffers[0]
+        return b"".join(buffers)
+
+
+class SegmentBuffer:
+    """A write-only text buffer that keeps written text as a list of strings.
+
+    Unlike :class:`io.StringIO`, written text is not copied, and text from a single
+    write is returned from :meth:`getvalue` as it is.
+    """
+
+    __slots__ = ("_segments", "write")
+
+    def __init__(self) -> None:
+        self._segments: List[str] = []
+        self.write = self._segments.append
+
+    def getvalue(self) -> str:
+        """Return the text written so far as a single string."""
+        if len(self._segments) == 1:
+            return self._segments[0]
+        return "".join(self._segments)
@@ -0,0 +1,445 @@
+"""Per-node render profiling.
+
+A :class:`Profiler` records wall time, call counts and output size for parse tree
+nodes, filters, template loading and parsing, grouped by template name and line
+number. Hooks are installed when a profiler is enabled and removed when it is
+disabled, so profiling costs nothing unless a profiler is running.
+
+.. code-block:: python
+
+    from liquid.profiler import Profiler
+
+    with Profiler() as profiler:
+        template.render(**data)
+
+    print(profiler.format_report(limit=10))
+
+    with open("render.folded", "w") as fd:
+        profiler.write_stacks(fd)
+"""
+from __future__ import annotations
+
+import threading
+
+from contextvars import ContextVar
+from functools import wraps
+from time import perf_counter
+
+from typing import Any
+from typing import Callable
+from typing import Dict
+from typing import List
+from typing import NamedTuple
+from typing import Optional
+from typing import TextIO
+from typing import Tuple
+from typing import Type
+
+from liquid.ast import BlockNode
+from liquid.ast import Node
+from liquid.context import Context
+from liquid.environment import Environment
+from liquid.filter import BoundFilter
+from liquid.template import BoundTemplate
+from liquid.token import Token
+from liquid.token import TOKEN_LITERAL
+from liquid.token import TOKEN_STATEMENT
+from liquid.token import TOKEN_TAG
+
+# The kinds of profile entry.
+KIND_NODE = "node"
+KIND_FILTER = "filter"
+KIND_TEMPLATE = "template"
+KIND_LOAD = "load"
+KIND_PARSE = "parse"
+
+_STRING_TEMPLATE = "<string>"
+
+# The profiler that has installed its hooks, if any.
+_active: Optional[Profiler] = None
+_active_lock = threading.Lock()
+
+
+class ProfileEntry(NamedTuple):
+    """Aggregated measurements for one node, filter, template render, template load
+    or parse.
+
+    :param kind: One of ``"node"``, ``"filter"``, ``"template"``, ``"load"`` or
+        ``"parse"``.
+    :param template: The name of the template being rendered or loaded.
+    :param linenum: The line number of the node, or of the node applying a filter.
+        ``0`` for template renders, loads and parses.
+    :param name: The node's tag name, ``"output"`` or ``"literal"``, a filter name,
+        or the name of a loaded template.
+    :param calls: The number of times it was called.
+    :param time: Total wall time in seconds, including time spent in nested nodes,
+        filters and templates.
+    :param size: The number of characters written to the output buffer. Always
+        ``0`` for filters, loads and parses.
+    """
+
+    kind: str
+    template: str
+    linenum: int
+    name: str
+    calls: int
+    time: float
+    size: int
+
+
+class _Frame:
+    __slots__ = ("label", "template", "linenum", "child")
+
+    def __init__(self, label: str, template: str, linenum: int):
+        self.label = label
+        self.template = template
+        self.linenum = linenum
+        self.child = 0.0
+
+
+_Key = Tuple[str, str, int, str]
+_Stack = Tuple[_Frame, ...]
+
+# A stack of frames per thread and per asyncio task.
+_stack: ContextVar[_Stack] = ContextVar("liquid_profiler_stack", default=())
+
+
+class Profiler:
+    """Record render statistics for nodes, filters and templates.
+
+    Only one profiler can be enabled at a time. While it is enabled, it records
+    renders in all environments and threads.
+
+    Compiled templates (see :class:`liquid.compiler.CompiledBoundTemplate`) don't
+    call ``Node.render`` for built-in tags, so only template renders, loads, parses,
+    filters and custom tags are recorded for them.
+
+    While a profiler is enabled, ``include`` and ``render`` tags load their partial
+    template with ``Context.get_template`` every time they are rendered, rather than
+    reusing a link to it, so every lookup is recorded as a load.
+    """
+
+    def __init__(self) -> None:
+        self._lock = threading.Lock()
+        self._stats: Dict[_Key, List[Any]] = {}
+        self._stacks: Dict[str, float] = {}
+        self._patched: List[Tuple[type, str, Any]] = []
+
+    def __enter__(self) -> Profiler:
+        self.enable()
+        return self
+
+    def __exit__(self, *args: Any) -> None:
+        self.disable()
+
+    @property
+    def enabled(self) -> bool:
+        """``True`` if this profiler's hooks are installed."""
+        return _active is self
+
+    def enable(self) -> None:
+        """Install profiling hooks.
+
+        :raises RuntimeError: If another profiler is already enabled.
+        """
+        global _active  # pylint: disable=global-statement
+        with _active_lock:
+            if _active is self:
+                return
+            if _active is not None:
+                raise RuntimeError("another profiler is already enabled")
+            _active = self
+
+        self._patch(Node, "render", self._wrap_render)
+        self._patch(Node, "render_async", self._wrap_render_async)
+        self._patch(BoundTemplate, "render_with_context", self._wrap_template)
+        self._patch(
+            BoundTemplate, "render_with_context_async", self._wrap_template_async
+        )
+        self._patch(Context, "get_template", self._wrap_load)
+        self._patch(Context, "get_template_async", self._wrap_load_async)
+        self._patch(Environment, "parse", self._wrap_parse)
+        self._patch(Environment, "get_filter", self._wrap_get_filter)
+
+    def disable(self) -> None:
+        """Remove profiling hooks. Recorded statistics are kept."""
+        global _active  # pylint: disable=global-statement
+        with _active_lock:
+            if _active is not self:
+                return
+
+            while self._patched:
+                cls, attr, original = self._patched.pop()
+                setattr(cls, attr, original)
+            _active = None
+
+    def reset(self) -> None:
+        """Discard recorded statistics."""
+        with self._lock:
+            self._stats.clear()
+            self._stacks.clear()
+
+    def report(self) -> List[ProfileEntry]:
+        """Return recorded statistics, most time consuming first."""
+        with self._lock:
+            entries = [
+                ProfileEntry(*key, calls, elapsed, size)
+                for key, (calls, elapsed, size) in self._stats.items()
+            ]
+        entries.sort(key=lambda entry: entry.time, reverse=True)
+        return entries
+
+    def format_report(self, limit: Optional[int] = None) -> str:
+        """Return recorded statistics as a plain text table.
+
+        :param limit: The maximum number of rows to include. Defaults to all rows.
+        :type limit: Optional[int]
+        """
+        header = f"{'time (ms)':>10} {'calls':>7} {'size':>9}  {'kind':<8} location"
+        lines = [header]
+        for entry in self.report()[:limit]:
+            location = entry.template or _STRING_TEMPLATE
+            if entry.linenum:
+                location += f":{entry.linenum}"
+            lines.append(
+                f"{entry.time * 1000:>10.3f} {entry.calls:>7} {entry.size:>9}  "
+                f"{entry.kind:<8} {location} {entry.name}"
+            )
+        return "\n".join(lines)
+
+    def stacks(self) -> List[str]:
+        """Return recorded statistics as folded stacks, one per line, suitable for
+        flame graph tools like ``flamegraph.pl`` or speedscope.
+
+        Each line is a semicolon separated list of frames, followed by the time spent
+        in the innermost frame, excluding its children, in whole microseconds.
+        """
+        with self._lock:
+            items = sorted(self._stacks.items())
+        return [f"{stack} {round(elapsed * 1e6)}" for stack, elapsed in items]
+
+    def write_stacks(self, fd: TextIO) -> None:
+        """Write folded stacks to the given file-like object. See :meth:`stacks`."""
+        for line in self.stacks():
+            fd.write(line + "\n")
+
+    def _patch(
+        self,
+        base: type,
+        attr: str,
+        wrap: Callable[[Callable[..., Any]], Callable[..., Any]],
+    ) -> None:
+        # Patch `base` and any subclass that overrides `attr`.
+        for cls in _subclasses(base):
+            original = cls.__dict__.get(attr)
+            if original is not None:
+                self._patched.append((cls, attr, original))
+                setattr(cls, attr, wraps(original)(wrap(original)))
+
+    def _push(
+        self, label: str, template: Optional[str] = None, linenum: int = 0
+    ) -> Tuple[_Frame, Any]:
+        stack = _stack.get()
+        if template is None:
+            template = stack[-1].template if stack else ""
+        frame = _Frame(label, template, linenum)
+        return frame, _stack.set(stack + (frame,))
+
+    def _pop(
+        self,
+        frame: _Frame,
+        token: Any,
+        key: _Key,
+        elapsed: float,
+        size: int = 0,
+    ) -> None:
+        stack = _stack.get()
+        _stack.reset(token)
+        if len(stack) > 1:
+            stack[-2].child += elapsed
+
+        path = ";".join(f.label for f in stack)
+        with self._lock:
+            stats = self._stats.get(key)
+            if stats is None:
+                self._stats[key] = [1, elapsed, size]
+            else:
+                stats[0] += 1
+                stats[1] += elapsed
+                stats[2] += size
+            self._stacks[path] = self._stacks.get(path, 0.0) + elapsed - frame.child
+
+    def _wrap_render(self, render: Callable[..., Any]) -> Callable[..., Any]:
+        def _render(node: Node, context: Context, buffer: TextIO) -> Optional[bool]:
+            # Blocks share a token with their tag, so are not recorded separately.
+            if isinstance(node, BlockNode):
+                return render(node, context, buffer)
+
+            name, linenum = _node_name(node.token())
+            frame, token = self._push(f"{name}:{linenum}", linenum=linenum)
+            size = _tell(buffer)
+            start = perf_counter()
+            try:
+                return render(node, context, buffer)
+            finally:
+                elapsed = perf_counter() - start
+                key = (KIND_NODE, frame.template, linenum, name)
+                self._pop(frame, token, key, elapsed, _tell(buffer) - size)
+
+        return _render
+
+    def _wrap_render_async(self, render: Callable[..., Any]) -> Callable[..., Any]:
+        async def _render(
+            node: Node, context: Context, buffer: TextIO
+        ) -> Optional[bool]:
+            if isinstance(node, BlockNode):
+                return await render(node, context, buffer)
+
+            name, linenum = _node_name(node.token())
+            frame, token = self._push(f"{name}:{linenum}", linenum=linenum)
+            size = _tell(buffer)
+            start = perf_counter()
+            try:
+                return await render(node, context, buffer)
+            finally:
+                elapsed = perf_counter() - start
+                key = (KIND_NODE, frame.template, linenum, name)
+                self._pop(frame, token, key, elapsed, _tell(buffer) - size)
+
+        return _render
+
+    def _wrap_template(self, render: Callable[..., Any]) -> Callable[..., Any]:
+        def _render_with_context(
+            template: BoundTemplate,
+            context: Context,
+            buffer: TextIO,
+            *args: Any,
+            **kwargs: Any,
+        ) -> None:
+            name = template.name or _STRING_TEMPLATE
+            frame, token = self._push(name, template=template.name)
+            size = _tell(buffer)
+            start = perf_counter()
+            try:
+                render(template, context, buffer, *args, **kwargs)
+            finally:
+                elapsed = perf_counter() - start
+                key = (KIND_TEMPLATE, template.name, 0, name)
+                self._pop(frame, token, key, elapsed, _tell(buffer) - size)
+
+        return _render_with_context
+
+    def _wrap_template_async(self, render: Callable[..., Any]) -> Callable[..., Any]:
+        async def _render_with_context(
+            template: BoundTemplate,
+            context: Context,
+            buffer: TextIO,
+            *args: Any,
+            **kwargs: Any,
+        ) -> None:
+            name = template.name or _STRING_TEMPLATE
+            frame, token = self._push(name, template=template.name)
+            size = _tell(buffer)
+            start = perf_counter()
+            try:
+                await render(template, context, buffer, *args, **kwargs)
+            finally:
+                elapsed = perf_counter() - start
+                key = (KIND_TEMPLATE, template.name, 0, name)
+                self._pop(frame, token, key, elapsed, _tell(buffer) - size)
+
+        return _render_with_context
+
+    def _wrap_load(self, get_template: Callable[..., Any]) -> Callable[..., Any]:
+        def _get_template(context: Context, name: str) -> BoundTemplate:
+            # Parsing while loading is attributed to the loaded template.
+            key = (KIND_LOAD, _current_template(), 0, name)
+            frame, token = self._push(f"load:{name}", template=name)
+            start = perf_counter()
+            try:
+                return get_template(context, name)  # type: ignore
+            finally:
+                elapsed = perf_counter() - start
+                self._pop(frame, token, key, elapsed)
+
+        return _get_template
+
+    def _wrap_load_async(self, get_template: Callable[..., Any]) -> Callable[..., Any]:
+        async def _get_template(context: Context, name: str) -> BoundTemplate:
+            # Parsing while loading is attributed to the loaded template.
+            key = (KIND_LOAD, _current_template(), 0, name)
+            frame, token = self._push(f"load:{name}", template=name)
+            start = perf_counter()
+            try:
+                return await get_template(context, name)  # type: ignore
+            finally:
+                elapsed = perf_counter() - start
+                self._pop(frame, token, key, elapsed)
+
+        return _get_template
+
+    def _wrap_parse(self, parse: Callable[..., Any]) -> Callable[..., Any]:
+        def _parse(env: Environment, source: str) -> Any:
+            frame, token = self._push(KIND_PARSE)
+            start = perf_counter()
+            try:
+                return parse(env, source)
+            finally:
+                elapsed = perf_counter() - start
+                key = (KIND_PARSE, frame.template, 0, KIND_PARSE)
+                self._pop(frame, token, key, elapsed)
+
+        return _parse
+
+    def _wrap_get_filter(self, get_filter: Callable[..., Any]) -> Callable[..., Any]:
+        def _get_filter(env: Environment, name: str) -> BoundFilter:
+            bound: BoundFilter = get_filter(env, name)
+            return bound._replace(func=self._wrap_filter(name, bound.func))
+
+        return _get_filter
+
+    def _wrap_filter(self, name: str, func: Callable[..., Any]) -> Callable[..., Any]:
+        def _filter(*args: Any, **kwargs: Any) -> Any:
+            stack = _stack.get()
+            linenum = stack[-1].linenum if stack else 0
+            frame, token = self._push(f"|{name}", linenum=linenum)
+            start = perf_counter()
+            try:
+                return func(*args, **kwargs)
+            finally:
+                elapsed = perf_counter() - start
+                key = (KIND_FILTER, frame.template, linenum, name)
+                self._pop(frame, token, key, elapsed)
+
+        return _filter
+
+
+def _subclasses(cls: Type[Any]) -> List[Type[Any]]:
+    classes = [cls]
+    for subclass in cls.__subclasses__():
+        for _cls in _subclasses(subclass):
+            if _cls not in classes:
+                classes.append(_cls)
+    return classes
+
+
+def _current_template() -> str:
+    stack = _stack.get()
+    return stack[-1].template if stack else ""
+
+
+def _node_name(tok: Token) -> Tuple[str, int]:
+    if tok.type == TOKEN_TAG:
+        return tok.value, tok.linenum
+    if tok.type == TOKEN_STATEMENT:
+        return "output", tok.linenum
+    if tok.type == TOKEN_LITERAL:
+        return "literal", tok.linenum
+    return tok.type, tok.linenum
+
+
+def _tell(buffer: TextIO) -> int:
+    try:
+        return buffer.tell()
+    except (AttributeError, OSError, ValueError):
+        return 0
@@ -2,31 +2,46 @@
 
 from __future__ import annotations
 
+import copy
+import sys
+import time
+
 from collections import ChainMap
 from collections import abc
 
 from io import StringIO
 from pathlib import Path
 
+from typing import AsyncIterator
 from typing import Awaitable
 from typing import Dict
 from typing import Any
+from typing import Iterable
 from typing import Iterator
+from typing import List
 from typing import Mapping
 from typing import Optional
 from typing import TextIO
+from typing import Tuple
 from typing import Union
 from typing import TYPE_CHECKING
 
 from liquid.context import Context
+from liquid.context import Lookup
 
 from liquid.exceptions import LiquidInterrupt
 from liquid.exceptions import LiquidSyntaxError
 from liquid.exceptions import Error
 
+from liquid.batch import render_many
+
+from liquid.output import BytesBuffer
+
 
 if TYPE_CHECKING:  # pragma: no cover
     from liquid import Environment
+    from liquid.analyze import TemplateAnalysis
+    from liquid.ast import Node
     from liquid.ast import ParseTree
     from liquid.loaders import UpToDate
 
@@ -39,6 +54,9 @@ class BoundTemplate:
     use :meth:`liquid.Environment.from_string` or
     :meth:`liquid.Environment.get_template`.
 
+    A template can be rendered by many threads at the same time. Render methods keep
+    all of their state in a new render context, and never change the template.
+
     :param env: The environment this template is bound to.
     :type env: liquid.Environment
     :param parse_tree: The parse tree representing this template.
@@ -52,6 +70,13 @@ class BoundTemplate:
     :type uptodate: Optional[Callable[[], bool]]
     """
 
+    # The number of characters to buffer before yielding a chunk from `render_stream`
+    # or `render_stream_async`.
+    stream_buffer_size = 8 * 1024
+
+    # The encoding used by `render_bytes` and `render_buffers`.
+    output_encoding = "utf-8"
+
     # pylint: disable=redefined-builtin
     def __init__(
         self,
@@ -69,6 +94,29 @@ class BoundTemplate:
         self.path = path
         self.uptodate = uptodate
 
+        # When this template was last known to be up to date, according to
+        # `time.monotonic`. See `Environment.reload_interval`.
+        self.checked_at = time.monotonic()
+
+        # Cached result of `is_pure`.
+        self._pure: Optional[bool] = None
+
+        # Cached result of `chained_lookups`.
+        self._lookups: Optional[List[List[Lookup]]] = None
+
+    # pylint: disable=redefined-builtin
+    def with_globals(self, globals: Mapping[str, object]) -> BoundTemplate:
+        """Return a copy of this template that includes ``globals`` in its render
+        context, in addition to this template's globals.
+
+        The copy shares this template's parse tree, so this is cheap, and this
+        template is left unchanged, so it is safe to use while other threads are
+        rendering it.
+        """
+        template = copy.copy(self)
+        template.globals = {**self.globals, **globals}
+        return template
+
     def render(self, *args: Any, **kwargs: Any) -> str:
         """Render the template with `args` and `kwargs` included in the render context.
 
@@ -90,6 +138,69 @@ class BoundTemplate:
         await self.render_with_context_async(context, buf)
         return buf.getvalue()
 
+    def render_bytes(self, *args: Any, **kwargs: Any) -> bytes:
+        """Render the template with `args` and `kwargs` included in the render context,
+        returning output encoded with ``output_encoding``.
+
+        Dynamic output is encoded as it is rendered, and long template literals are
+        encoded once per template, so rendered text is not encoded all at once at the
+        end. Accepts the same arguments as the :class:`dict` constructor.
+        """
+        return self._render_to_buffer(args, kwargs).getvalue()
+
+    async def render_bytes_async(self, *args: Any, **kwargs: Any) -> bytes:
+        """An async version of :meth:`liquid.template.BoundTemplate.render_bytes`."""
+        return (await self._render_to_buffer_async(args, kwargs)).getvalue()
+
+    def render_buffers(self, *args: Any, **kwargs: Any) -> List[bytes]:
+        """Render the template with `args` and `kwargs` included in the render context,
+        returning a list of byte strings that make up the encoded output.
+
+        The list is suitable for writing with :func:`os.writev` or
+        :meth:`socket.socket.sendmsg`, without joining its items first. Accepts the
+        same arguments as the :class:`dict` constructor.
+        """
+        return self._render_to_buffer(args, kwargs).getbuffers()
+
+    async def render_buffers_async(self, *args: Any, **kwargs: Any) -> List[bytes]:
+        """An async version of :meth:`liquid.template.BoundTemplate.render_buffers`."""
+        return (await self._render_to_buffer_async(args, kwargs)).getbuffers()
+
+    def _render_to_buffer(
+        self, args: Tuple[Any, ...], kwargs: Dict[str, Any]
+    ) -> BytesBuffer:
+        _vars: Dict[str, object] = dict(*args, **kwargs)
+        context = Context(self.env, ChainMap(_vars, self.globals))
+
+        buf = BytesBuffer(self.output_encoding)
+        self.render_with_context(context, buf)  # type: ignore
+        return buf
+
+    async def _render_to_buffer_async(
+        self, args: Tuple[Any, ...], kwargs: Dict[str, Any]
+    ) -> BytesBuffer:
+        _vars: Dict[str, object] = dict(*args, **kwargs)
+        context = Context(self.env, ChainMap(_vars, self.globals))
+
+        buf = BytesBuffer(self.output_encoding)
+        await self.render_with_context_async(context, buf)  # type: ignore
+        return buf
+
+    def render_many(
+        self,
+        items: Iterable[Mapping[str, object]],
+        workers: Optional[int] = None,
+        **kwargs: Any,
+    ) -> Iterator[Any]:
+        """Render this template once for each mapping of render context data in
+        ``items``, spread over a pool of ``workers`` processes.
+
+        This template's environment and parse tree are sent to each worker once.
+        Rendered templates are yielded in the same order as ``items``. See
+        :func:`liquid.batch.render_many` for other keyword arguments.
+        """
+        return render_many(self, items, workers, **kwargs)
+
     def render_with_context(
         self,
         context: Context,
@@ -115,24 +226,12 @@ class BoundTemplate:
         # "template" could get overridden from args/kwargs, "partial" will not.
         namespace = self._make_globals(partial, args, kwargs)
 
-        with context.extend(namespace=namespace):
+        with context.extend(namespace=namespace, fixed_keys=True):
             for node in self.tree.statements:
                 try:
                     node.render(context, buffer)
                 except LiquidInterrupt as err:
-                    # If this is an "included" template, there could be a for loop
-                    # in a parent template. A for loop that could be interrupted
-                    # from an included template.
-                    #
-                    # Convert the interrupt to a syntax error if there is no parent.
-                    if not partial or block_scope:
-                        self.env.error(
-                            LiquidSyntaxError(
-                                f"unexpected '{err}'", linenum=node.token().linenum
-                            )
-                        )
-                    else:
-                        raise
+                    self._interrupt(err, node, partial, block_scope)
                 except Error as err:
                     # Raise or warn according to the current mode.
                     self.env.error(err, linenum=node.token().linenum)
@@ -150,28 +249,178 @@ class BoundTemplate:
         # "template" could get overridden from args/kwargs, "partial" will not.
         namespace = self._make_globals(partial, args, kwargs)
 
-        with context.extend(namespace=namespace):
+        with context.extend(namespace=namespace, fixed_keys=True):
+            if context.prefetcher is not None:
+                try:
+                    async for _ in self.render_statements_async(
+                        context, buffer, partial, block_scope
+                    ):
+                        pass
+                finally:
+                    if not partial:
+                        context.prefetcher.cancel()
+                return
+
             for node in self.tree.statements:
                 try:
                     await node.render_async(context, buffer)
                 except LiquidInterrupt as err:
-                    # If this is an "included" template, there could be a for loop
-                    # in a parent template. A for loop that could be interrupted
-                    # from an included template.
-                    #
-                    # Convert the interrupt to a syntax error if there is no parent.
-                    if not partial or block_scope:
-                        self.env.error(
-                            LiquidSyntaxError(
-                                f"unexpected '{err}'", linenum=node.token().linenum
-                            )
-                        )
-                    else:
-                        raise
+                    self._interrupt(err, node, partial, block_scope)
                 except Error as err:
                     # Raise or warn according to the current mode.
                     self.env.error(err, linenum=node.token().linenum)
 
+    def render_stream(self, *args: Any, **kwargs: Any) -> Iterator[str]:
+        """Render the template with `args` and `kwargs` included in the render context,
+        yielding chunks of rendered text as they become available.
+
+        Rendered text is buffered until the buffer holds at least
+        ``stream_buffer_size`` characters at the end of a top-level statement, so the
+        size of a chunk can exceed ``stream_buffer_size`` if a single statement,
+        like a ``for`` loop, renders a lot of text. Text is also yielded before
+        rendering a :class:`liquid.layout.LayoutContent` in place of a top-level
+        ``{{ content_for_layout }}``, and the content template is streamed too.
+
+        Accepts the same arguments as the :class:`dict` constructor.
+        """
+        _vars: Dict[str, object] = dict(*args, **kwargs)
+        context = Context(self.env, ChainMap(_vars, self.globals))
+
+        buf = StringIO()
+        namespace = self._make_globals(False, (), {})
+
+        with context.extend(namespace=namespace, fixed_keys=True):
+            for flush in self.render_statements(context, buf):
+                if buf.tell() >= self.stream_buffer_size or flush and buf.tell():
+                    yield buf.getvalue()
+                    buf.seek(0)
+                    buf.truncate()
+
+        val = buf.getvalue()
+        if val:
+            yield val
+
+    async def render_stream_async(
+        self, *args: Any, **kwargs: Any
+    ) -> AsyncIterator[str]:
+        """An async version of :meth:`liquid.template.BoundTemplate.render_stream`."""
+        _vars: Dict[str, object] = dict(*args, **kwargs)
+        context = Context(self.env, ChainMap(_vars, self.globals))
+
+        buf = StringIO()
+        namespace = self._make_globals(False, (), {})
+
+        try:
+            with context.extend(namespace=namespace, fixed_keys=True):
+                async for flush in self.render_statements_async(context, buf):
+                    if buf.tell() >= self.stream_buffer_size or flush and buf.tell():
+                        yield buf.getvalue()
+                        buf.seek(0)
+                        buf.truncate()
+        finally:
+            if context.prefetcher is not None:
+                context.prefetcher.cancel()
+
+        val = buf.getvalue()
+        if val:
+            yield val
+
+    def render_statements(
+        self,
+        context: Context,
+        buffer: TextIO,
+        partial: bool = False,
+        block_scope: bool = False,
+    ) -> Iterator[Optional[bool]]:
+        """Render this template's top-level statements to the given buffer, yielding
+        ``None`` after each statement.
+
+        A top-level ``{{ content_for_layout }}`` yields ``True``, asking for output to
+        be flushed, before it renders a :class:`liquid.layout.LayoutContent`, then
+        ``False`` after each of the content template's statements.
+
+        Unlike :meth:`render_with_context`, the render context is not extended with
+        template globals.
+        """
+        # pylint: disable=import-outside-toplevel
+        from liquid.builtin.statement import LayoutContentNode
+
+        for node in self.tree.statements:
+            if node.__class__ is LayoutContentNode:
+                content = node.content(context)  # type: ignore
+                if content is not None:
+                    yield True
+                    yield from content.render_statements(context, buffer)
+                    yield None
+                    continue
+            try:
+                node.render(context, buffer)
+            except LiquidInterrupt as err:
+                self._interrupt(err, node, partial, block_scope)
+            except Error as err:
+                # Raise or warn according to the current mode.
+                self.env.error(err, linenum=node.token().linenum)
+            yield None
+
+    async def render_statements_async(
+        self,
+        context: Context,
+        buffer: TextIO,
+        partial: bool = False,
+        block_scope: bool = False,
+    ) -> AsyncIterator[Optional[bool]]:
+        """An async version of
+        :meth:`liquid.template.BoundTemplate.render_statements`.
+
+        If the context has a :class:`liquid.context.Prefetcher`, lookups for upcoming
+        statements are started before each statement is rendered.
+        """
+        # pylint: disable=import-outside-toplevel
+        from liquid.builtin.statement import LayoutContentNode
+
+        prefetcher = context.prefetcher
+        lookups = self.chained_lookups() if prefetcher is not None else []
+
+        for index, node in enumerate(self.tree.statements):
+            if prefetcher is not None:
+                prefetcher.start(context, lookups, index)
+            if node.__class__ is LayoutContentNode:
+                content = node.content(context)  # type: ignore
+                if content is not None:
+                    yield True
+                    async for flush in content.render_statements_async(
+                        context, buffer
+                    ):
+                        yield flush
+                    yield None
+                    continue
+            try:
+                await node.render_async(context, buffer)
+            except LiquidInterrupt as err:
+                self._interrupt(err, node, partial, block_scope)
+            except Error as err:
+                # Raise or warn according to the current mode.
+                self.env.error(err, linenum=node.token().linenum)
+            yield None
+
+    def _interrupt(
+        self,
+        err: LiquidInterrupt,
+        node: Node,
+        partial: bool,
+        block_scope: bool,
+    ) -> None:
+        # If this is an "included" template, there could be a for loop in a parent
+        # template. A for loop that could be interrupted from an included template.
+        #
+        # Convert the interrupt to a syntax error if there is no parent.
+        if not partial or block_scope:
+            self.env.error(
+                LiquidSyntaxError(f"unexpected '{err}'", linenum=node.token().linenum)
+            )
+        else:
+            raise err
+
     @property
     def is_up_to_date(self) -> bool:
         """False if the template was modified since it was last parsed,
@@ -200,6 +449,72 @@ class BoundTemplate:
             return await uptodate
         return uptodate
 
+    def analyze(
+        self, follow_partials: bool = True, raise_for_failures: bool = True
+    ) -> TemplateAnalysis:
+        """Statically analyze this template and any included or rendered templates.
+
+        Reports the variables, filters and partial templates referenced by this
+        template without rendering it. Use ``global_variables`` from the result to
+        find which top-level variables need to be in render context data.
+
+        :param follow_partials: If ``True``, partial templates referenced by
+            ``include`` and ``render`` tags with a string literal name are loaded and
+            analyzed too. Defaults to ``True``.
+        :type follow_partials: bool
+        :param raise_for_failures: If ``True``, errors loading partial templates are
+            raised. Otherwise partial templates that can't be loaded are silently
+            skipped. Defaults to ``True``.
+        :type raise_for_failures: bool
+        :returns: The template's variables, filters and partial templates.
+        :rtype: liquid.analyze.TemplateAnalysis
+        """
+        # The analyzer depends on built-in tags, which depend on this module.
+        # pylint: disable=import-outside-toplevel
+        from liquid.analyze import Analyzer
+
+        return Analyzer(
+            self,
+            follow_partials=follow_partials,
+            raise_for_failures=raise_for_failures,
+        ).analyze()
+
+    def is_pure(self) -> bool:
+        """Return ``True`` if this template does not use stateful tags, like ``cycle``
+        and ``increment``, or filters that are not marked as pure.
+
+        The result is computed once per template. Partial templates are not checked.
+        """
+        if self._pure is None:
+            # pylint: disable=import-outside-toplevel
+            from liquid.analyze import is_pure
+
+            self._pure = is_pure(self.tree, self.env)
+        return self._pure
+
+    def estimate_size(self) -> int:
+        """Return an estimate of the memory used by this template's parse tree, in
+        bytes.
+
+        Suitable as the ``weigh`` argument to :class:`liquid.utils.LRUCache`, for
+        limiting a template cache by size in memory rather than number of templates.
+        """
+        return _sizeof(self.tree)
+
+    def chained_lookups(self) -> List[List[Lookup]]:
+        """Return chained variables, like ``product.title``, for each of this
+        template's top-level statements, including variables in nested blocks. See
+        :func:`liquid.analyze.chained_lookups`.
+
+        The result is cached.
+        """
+        if self._lookups is None:
+            # pylint: disable=import-outside-toplevel
+            from liquid.analyze import chained_lookups
+
+            self._lookups = [chained_lookups(node) for node in self.tree.statements]
+        return self._lookups
+
     def _make_globals(
         self, partial: bool, args: Any, kwargs: Any
     ) -> abc.Mapping[str, object]:
@@ -215,6 +530,45 @@ class BoundTemplate:
         )  # pragma: no cover
 
 
+def _sizeof(obj: object) -> int:
+    """Return the approximate size of an object and all of the objects it references,
+    in bytes. Classes, functions and modules are not counted."""
+    return sum(_reachable(obj).values())
+
+
+def _reachable(obj: object) -> Dict[int, int]:
+    """Return a mapping of object ids to sizes, in bytes, for an object and all of
+    the objects it references. Classes, functions and modules are not included."""
+    seen: Dict[int, int] = {}
+    stack = [obj]
+
+    while stack:
+        obj = stack.pop()
+        if id(obj) in seen or isinstance(obj, (type, abc.Callable, type(sys))):
+            continue
+
+        seen[id(obj)] = sys.getsizeof(obj)
+
+        if isinstance(obj, (str, bytes, int, float)):
+            continue
+
+        if isinstance(obj, dict):
+            stack.extend(obj.keys())
+            stack.extend(obj.values())
+        elif isinstance(obj, (list, tuple, set, frozenset)):
+            stack.extend(obj)
+
+        if hasattr(obj, "__dict__"):
+            stack.append(obj.__dict__)
+
+        for cls in type(obj).__mro__:
+            for slot in getattr(cls, "__slots__", ()):
+                if hasattr(obj, slot):
+                    stack.append(getattr(obj, slot))
+
+    return seen
+
+
 class AwareBoundTemplate(BoundTemplate):
     def __init__(self, *args: Any, **kwargs: Any) -> None:
         super().__init__(*args, **kwargs)
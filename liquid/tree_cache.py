@@ -0,0 +1,227 @@
+"""Persistent caches for parsed templates.
+
+A tree cache stores serialized parse trees outside of the current process, so new
+processes can load previously parsed templates without lexing and parsing them
+again. Modelled after Jinja2's bytecode cache.
+See https://github.com/pallets/jinja/blob/master/src/jinja2/bccache.py
+
+Parse trees are serialized with :mod:`pickle`. Only use a tree cache with storage
+that is not writable by untrusted parties.
+"""
+from __future__ import annotations
+
+import hashlib
+import os
+import pickle
+import tempfile
+
+from abc import ABC
+from abc import abstractmethod
+from pathlib import Path
+
+from typing import Dict
+from typing import Optional
+from typing import Union
+from typing import TYPE_CHECKING
+
+from liquid import __version__
+from liquid.ast import ParseTree
+
+if TYPE_CHECKING:  # pragma: no cover
+    from liquid import Environment
+
+
+def fingerprint(env: Environment) -> str:
+    """Return a string identifying environment configuration that affects parsing.
+
+    Unlike ``Environment.__hash__``, the fingerprint is stable between processes.
+    When ``env.optimize`` is enabled, registered filters are included too, as pure
+    filters might have been evaluated and folded into the cached parse tree.
+    """
+    tags = ",".join(
+        f"{name}={type(tag).__module__}.{type(tag).__qualname__}"
+        for name, tag in sorted(env.tags.items())
+    )
+
+    if env.optimize:
+        filters = ",".join(
+            f"{name}={_qualified_name(func)}"
+            for name, func in sorted(env.filters.items())
+        )
+    else:
+        filters = ""
+
+    return "|".join(
+        (
+            env.tag_start_string,
+            env.tag_end_string,
+            env.statement_start_string,
+            env.statement_end_string,
+            str(env.strip_tags),
+            env.mode.name,
+            str(env.autoescape),
+            str(env.optimize),
+            str(env.compact_trees),
+            tags,
+            filters,
+        )
+    )
+
+
+def _qualified_name(obj: object) -> str:
+    # Filters are functions or instances of callable classes.
+    if not hasattr(obj, "__qualname__"):
+        obj = type(obj)
+    return f"{getattr(obj, '__module__', '')}.{getattr(obj, '__qualname__')}"
+
+
+class TreeCache(ABC):
+    """Base class for all persistent parse tree caches.
+
+    Subclasses must implement ``get`` and ``set``, which read and write serialized
+    parse trees by key. For example, a cache using Redis might look like this.
+
+    .. code-block:: python
+
+        class RedisTreeCache(TreeCache):
+            def __init__(self, client, prefix="liquid:", timeout=None):
+                self.client = client
+                self.prefix = prefix
+                self.timeout = timeout
+
+            def get(self, key):
+                return self.client.get(self.prefix + key)
+
+            def set(self, key, data):
+                self.client.set(self.prefix + key, data, ex=self.timeout)
+    """
+
+    @abstractmethod
+    def get(self, key: str) -> Optional[bytes]:
+        """Return serialized parse tree data for the given key, or ``None`` if the
+        key does not exist."""
+
+    @abstractmethod
+    def set(self, key: str, data: bytes) -> None:
+        """Store serialized parse tree data with the given key."""
+
+    def clear(self) -> None:
+        """Remove all parse trees from the cache. The default implementation does
+        nothing."""
+
+    def key(self, env: Environment, source: str) -> str:
+        """Return a cache key for the given template source and environment.
+
+        The key is derived from the template source, the environment's
+        :func:`fingerprint` and the current parse tree version.
+        """
+        hash_ = hashlib.sha256()
+        hash_.update(__version__.encode())
+        hash_.update(b"\0")
+        hash_.update(fingerprint(env).encode())
+        hash_.update(b"\0")
+        hash_.update(source.encode("utf-8", "surrogatepass"))
+        return hash_.hexdigest()
+
+    def load(self, key: str) -> Optional[ParseTree]:
+        """Return the parse tree stored with the given key, or ``None`` if the key
+        does not exist or its data can't be deserialized."""
+        data = self.get(key)
+        if data is None:
+            return None
+
+        try:
+            tree = pickle.loads(data)
+        except Exception:  # pylint: disable=broad-except
+            # Stale or corrupt data. We'll parse the template and overwrite it.
+            return None
+
+        if not isinstance(tree, ParseTree) or tree.version != __version__:
+            return None
+        return tree
+
+    def dump(self, key: str, tree: ParseTree) -> None:
+        """Serialize and store the given parse tree.
+
+        Parse trees containing nodes that can't be pickled, like those from some
+        custom tags, are silently not cached.
+        """
+        try:
+            data = pickle.dumps(tree, protocol=pickle.HIGHEST_PROTOCOL)
+        except (pickle.PicklingError, TypeError, AttributeError, RecursionError):
+            return
+        self.set(key, data)
+
+
+class FileSystemTreeCache(TreeCache):
+    """A tree cache that stores serialized parse trees in files in a directory.
+
+    :param directory: The directory in which to store cached parse trees. Defaults to
+        a directory called ``_python_liquid_cache`` in the system's temporary directory.
+        The directory will be created if it does not exist.
+    :type directory: Union[str, Path, None]
+    :param pattern: A ``%`` format string for cache file names. It will be formatted
+        with a cache key. Defaults to ``"__liquid_%s.cache"``.
+    :type pattern: str
+    """
+
+    def __init__(
+        self,
+        directory: Union[str, Path, None] = None,
+        pattern: str = "__liquid_%s.cache",
+    ):
+        if directory is None:
+            directory = Path(tempfile.gettempdir()).joinpath("_python_liquid_cache")
+
+        self.directory = Path(directory)
+        self.pattern = pattern
+        self.directory.mkdir(parents=True, exist_ok=True)
+
+    def _path(self, key: str) -> Path:
+        return self.directory.joinpath(self.pattern % key)
+
+    def get(self, key: str) -> Optional[bytes]:
+        try:
+            with self._path(key).open("rb") as fd:
+                return fd.read()
+        except OSError:
+            return None
+
+    def set(self, key: str, data: bytes) -> None:
+        # Write to a temporary file and rename it, so concurrent readers never see a
+        # partially written file.
+        fd, tmp = tempfile.mkstemp(dir=self.directory, suffix=".tmp")
+        try:
+            with os.fdopen(fd, "wb") as tmp_fd:
+                tmp_fd.write(data)
+            os.replace(tmp, self._path(key))
+        except OSError:
+            try:
+                os.remove(tmp)
+            except OSError:
+                pass
+
+    def clear(self) -> None:
+        for path in self.directory.glob(self.pattern % "*"):
+            try:
+                path.unlink()
+            except OSError:
+                pass
+
+
+class DictTreeCache(TreeCache):
+    """A tree cache that stores serialized parse trees in a dictionary. Useful for
+    testing, or for sharing parse trees between environments in the same process.
+    """
+
+    def __init__(self) -> None:
+        self.data: Dict[str, bytes] = {}
+
+    def get(self, key: str) -> Optional[bytes]:
+        return self.data.get(key)
+
+    def set(self, key: str, data: bytes) -> None:
+        self.data[key] = data
+
+    def clear(self) -> None:
+        self.data.clear()
@@ -1,5 +1,6 @@
 # flake8: noqa
 # pylint: disable=useless-import-alias,missing-module-docstring
+from .cache import CacheInfo as CacheInfo
 from .cache import LRUCache as LRUCache
 from .html import strip_tags as strip_tags
 from .text import truncate_chars as truncate_chars
@@ -1,6 +1,8 @@
-"""A simple LRU Cache implementation.
+"""An LRU Cache implementation.
+
+Originally coppied from https://github.com/pallets/jinja/blob/master/src/jinja2/utils.py
+and rewritten to use an ordered dictionary, with statistics, weights and expiry.
 
-Coppied from https://github.com/pallets/jinja/blob/master/src/jinja2/utils.py
 BSD-3-Clause License
 
 Copyright 2007 Pallets
@@ -31,37 +33,76 @@ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISE
 OF THE POSSIBILITY OF SUCH DAMAGE.
 """
 
-from collections import abc, deque
+import time
+
+from collections import OrderedDict
+from collections import abc
 from threading import Lock
+from typing import NamedTuple
 
 
-class LRUCache(abc.MutableMapping):
-    """A simple LRU Cache implementation."""
+class CacheInfo(NamedTuple):
+    """Cache statistics, as returned by :meth:`LRUCache.cache_info`."""
+
+    hits: int
+    misses: int
+    evictions: int
+    expired: int
+    size: int
+    weight: int
+
 
-    # this is fast for small capacities (something below 1000) but doesn't
-    # scale.  But as long as it's only used as storage for templates this
-    # won't do any harm.
+def _unit_weight(_):
+    return 1
 
-    def __init__(self, capacity: int):
+
+class LRUCache(abc.MutableMapping):
+    """A thread safe, least recently used cache, bounded by number of items and,
+    optionally, by the total weight of its values. Getting, setting and deleting items
+    are all constant time operations.
+
+    :param capacity: The maximum number of items in the cache, or ``None`` for no limit
+        on the number of items.
+    :param max_weight: The maximum total weight of all values in the cache, or ``None``
+        for no limit. When the cache is full, least recently used items are discarded
+        until both limits are satisfied, although the most recently set item is always
+        kept.
+    :param weigh: A callable that returns the weight of a value. Defaults to a weight
+        of ``1`` for every item. Use :meth:`liquid.template.BoundTemplate.estimate_size`
+        to limit a template cache by the approximate size of parse trees in memory.
+    :param ttl: The number of seconds an item can stay in the cache, or ``None`` if
+        items don't expire. Expired items are discarded lazily, when they are next
+        requested.
+    """
+
+    def __init__(self, capacity, max_weight=None, weigh=None, ttl=None):
         self.capacity = capacity
-        self._mapping = {}
-        self._queue = deque()
+        self.max_weight = max_weight
+        self.weigh = weigh or _unit_weight
+        self.ttl = ttl
+
+        # Least recently used items first.
+        self._mapping = OrderedDict()
+
+        # Value weights and expiry times, by key, if we're tracking them.
+        self._weights = {}
+        self._expires = {}
+        self._weight = 0
+
+        self.hits = 0
+        self.misses = 0
+        self.evictions = 0
+        self.expired = 0
+
         self._postinit()
 
     def _postinit(self):
-        # alias all queue methods for faster lookup
-        self._popleft = self._queue.popleft
-        self._pop = self._queue.pop
-        self._remove = self._queue.remove
         self._wlock = Lock()
-        self._append = self._queue.append
 
     def __getstate__(self):
-        return {
-            "capacity": self.capacity,
-            "_mapping": self._mapping,
-            "_queue": self._queue,
-        }
+        state = self.__dict__.copy()
+        del state["_wlock"]
+        return state
 
     def __setstate__(self, d):
         self.__dict__.update(d)
@@ -72,18 +113,61 @@ class LRUCache(abc.MutableMapping):
 
     def copy(self):
         """Return a shallow copy of the instance."""
-        rv = self.__class__(self.capacity)
-        rv._mapping.update(self._mapping)
-        rv._queue.extend(self._queue)
+        rv = self.__class__(self.capacity, self.max_weight, self.weigh, self.ttl)
+        with self._wlock:
+            rv._mapping.update(self._mapping)
+            rv._weights.update(self._weights)
+            rv._expires.update(self._expires)
+            rv._weight = self._weight
         return rv
 
-    def get(self, key: str, default: object = None):
+    def cache_info(self):
+        """Return hit, miss and eviction counts, and the current size and total
+        weight of the cache, as a :class:`CacheInfo`."""
+        return CacheInfo(
+            self.hits,
+            self.misses,
+            self.evictions,
+            self.expired,
+            len(self._mapping),
+            self._weight if self.max_weight is not None else len(self._mapping),
+        )
+
+    def get(self, key, default=None):
         """Return an item from the cache dict or `default`"""
         try:
             return self[key]
         except KeyError:
             return default
 
+    def peek(self, key, default=None):
+        """Return an item from the cache, or `default` if it does not exist or has
+        expired, without moving it up or counting a hit or miss."""
+        try:
+            rv = self._mapping[key]
+        except KeyError:
+            return default
+
+        expires = self._expires.get(key)
+        if expires is not None and expires <= time.monotonic():
+            return default
+        return rv
+
+    def pop_if(self, key, value):
+        """Remove the item with the given key if it is `value`, by identity. Return
+        `True` if the item was removed."""
+        with self._wlock:
+            if key not in self._mapping or self._mapping[key] is not value:
+                return False
+            self._discard(key)
+            return True
+
+    def expires(self, key):
+        """Return the time, according to :func:`time.monotonic`, at which the item
+        with the given key expires, or `None` if it does not exist or does not
+        expire."""
+        return self._expires.get(key)
+
     def setdefault(self, key, default=None):
         """Set `default` if the key is not in the cache otherwise
         leave unchanged. Return the value of this key.
@@ -96,79 +180,104 @@ class LRUCache(abc.MutableMapping):
 
     def clear(self):
         """Clear the cache."""
-        self._wlock.acquire()
-        try:
+        with self._wlock:
             self._mapping.clear()
-            self._queue.clear()
-        finally:
-            self._wlock.release()
+            self._weights.clear()
+            self._expires.clear()
+            self._weight = 0
 
     def __contains__(self, key):
         """Check if a key exists in this cache."""
         return key in self._mapping
 
     def __len__(self):
-        """Return the current size of the cache."""
+        """Return the current size of the cache, including expired items that have
+        not yet been discarded."""
         return len(self._mapping)
 
     def __repr__(self):
-        return f"<{self.__class__.__name__} {self._mapping!r}>"
+        return f"<{self.__class__.__name__} {dict(self._mapping)!r}>"
 
     def __getitem__(self, key):
         """Get an item from the cache. Moves the item up so that it has the
         highest priority then.
-        Raise a `KeyError` if it does not exist.
+        Raise a `KeyError` if it does not exist or has expired.
         """
-        self._wlock.acquire()
-        try:
-            rv = self._mapping[key]
-            if self._queue[-1] != key:
-                try:
-                    self._remove(key)
-                except ValueError:
-                    # if something removed the key from the container
-                    # when we read, ignore the ValueError that we would
-                    # get otherwise.
-                    pass
-                self._append(key)
+        with self._wlock:
+            try:
+                rv = self._mapping[key]
+            except KeyError:
+                self.misses += 1
+                raise
+
+            if self._expires and self._expires[key] <= time.monotonic():
+                self._discard(key)
+                self.expired += 1
+                self.misses += 1
+                raise KeyError(key)
+
+            self._mapping.move_to_end(key)
+            self.hits += 1
             return rv
-        finally:
-            self._wlock.release()
 
     def __setitem__(self, key, value):
         """Sets the value for an item. Moves the item up so that it
         has the highest priority then.
         """
-        self._wlock.acquire()
-        try:
+        weight = self.weigh(value) if self.max_weight is not None else 0
+
+        with self._wlock:
             if key in self._mapping:
-                self._remove(key)
-            elif len(self._mapping) == self.capacity:
-                del self._mapping[self._popleft()]
-            self._append(key)
+                self._discard(key)
+
             self._mapping[key] = value
-        finally:
-            self._wlock.release()
+
+            if self.max_weight is not None:
+                self._weights[key] = weight
+                self._weight += weight
+
+            if self.ttl is not None:
+                self._expires[key] = time.monotonic() + self.ttl
+
+            self._evict()
 
     def __delitem__(self, key):
         """Remove an item from the cache dict.
         Raise a `KeyError` if it does not exist.
         """
-        self._wlock.acquire()
-        try:
-            del self._mapping[key]
-            try:
-                self._remove(key)
-            except ValueError:
-                pass
-        finally:
-            self._wlock.release()
+        with self._wlock:
+            if key not in self._mapping:
+                raise KeyError(key)
+            self._discard(key)
+
+    def _discard(self, key):
+        # Assumes we're holding the lock.
+        del self._mapping[key]
+        self._weight -= self._weights.pop(key, 0)
+        self._expires.pop(key, None)
+
+    def _evict(self):
+        # Assumes we're holding the lock.
+        mapping = self._mapping
+        while len(mapping) > 1 and (
+            (self.capacity is not None and len(mapping) > self.capacity)
+            or (self.max_weight is not None and self._weight > self.max_weight)
+        ):
+            self._discard(next(iter(mapping)))
+            self.evictions += 1
 
     def items(self):
-        """Return a list of items."""
-        result = [(key, self._mapping[key]) for key in list(self._queue)]
-        result.reverse()
-        return result
+        """Return a list of unexpired items, ordered by most recent usage."""
+        with self._wlock:
+            items = list(self._mapping.items())
+
+        if self._expires:
+            now = time.monotonic()
+            expires = self._expires
+            items = [item for item in items if expires.get(item[0], now + 1) > now]
+
+        items.reverse()
+        return items
 
     def values(self):
         """Return a list of all values."""
@@ -179,12 +288,16 @@ class LRUCache(abc.MutableMapping):
         return list(self)
 
     def __iter__(self):
-        return reversed(tuple(self._queue))
+        with self._wlock:
+            keys = list(self._mapping)
+        return reversed(keys)
 
     def __reversed__(self):
         """Iterate over the keys in the cache dict, oldest items
         coming first.
         """
-        return iter(tuple(self._queue))
+        with self._wlock:
+            keys = list(self._mapping)
+        return iter(keys)
 
     __copy__ = copy
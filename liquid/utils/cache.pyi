@@ -1,15 +1,49 @@
 # flake8: noqa
 
 from typing import Any
+from typing import Callable
 from typing import Iterator
+from typing import List
 from typing import MutableMapping
+from typing import NamedTuple
+from typing import Optional
+from typing import Tuple
+
+class CacheInfo(NamedTuple):
+    hits: int
+    misses: int
+    evictions: int
+    expired: int
+    size: int
+    weight: int
 
 class LRUCache(MutableMapping[Any, Any]):
-    def __init__(self, capacity: int) -> None: ...
+    capacity: Optional[int]
+    max_weight: Optional[int]
+    weigh: Callable[[Any], int]
+    ttl: Optional[float]
+    hits: int
+    misses: int
+    evictions: int
+    expired: int
+    def __init__(
+        self,
+        capacity: Optional[int],
+        max_weight: Optional[int] = ...,
+        weigh: Optional[Callable[[Any], int]] = ...,
+        ttl: Optional[float] = ...,
+    ) -> None: ...
     def __getitem__(self, key: Any) -> Any: ...
     def __iter__(self) -> Iterator[Any]: ...
     def __len__(self) -> int: ...
     def __setitem__(self, key: Any, value: Any) -> None: ...
     def __delitem__(self, key: Any) -> None: ...
+    def peek(self, key: Any, default: Any = ...) -> Any: ...
+    def pop_if(self, key: Any, value: Any) -> bool: ...
+    def expires(self, key: Any) -> Optional[float]: ...
     def copy(self) -> LRUCache: ...
+    def cache_info(self) -> CacheInfo: ...
+    def items(self) -> List[Tuple[Any, Any]]: ...  # type: ignore
+    def values(self) -> List[Any]: ...  # type: ignore
+    def keys(self) -> List[Any]: ...  # type: ignore
     def __reversed__(self) -> Iterator[Any]: ...
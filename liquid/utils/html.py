@@ -2,8 +2,20 @@
 
 from html.parser import HTMLParser
 
+from typing import Iterable
 from typing import List
 
+try:
+    from markupsafe import escape
+    from markupsafe import Markup
+    from markupsafe import soft_str
+except ImportError:
+    from liquid.exceptions import escape  # type: ignore
+    from liquid.exceptions import Markup  # type: ignore
+
+    # pylint: disable=invalid-name
+    soft_str = str  # type: ignore
+
 
 class StripParser(HTMLParser):  # pylint: disable=abstract-method
     """An HTML parser that strips out tags."""
@@ -34,3 +46,18 @@ def strip_tags(value: str) -> str:
         parser.close()
         return parser.get_data()
     return value
+
+
+def escape_join(items: Iterable[object], separator: str = "") -> str:
+    """Return string representations of the given items joined with ``separator``,
+    escaping any items that are not already markup. The separator is not escaped.
+
+    This is equivalent to ``Markup(separator).join(items)``, but when none of the items
+    is markup, and the separator doesn't need escaping, the joined string is escaped
+    in one call rather than one call per item.
+    """
+    separator = str(separator)
+    strs = [soft_str(itm) for itm in items]
+    if escape(separator) != separator or any(hasattr(itm, "__html__") for itm in strs):
+        return Markup(separator).join(strs)
+    return escape(separator.join(strs))
@@ -0,0 +1,139 @@
+"""Background reloading of changed templates.
+
+A template watcher polls templates in an environment's template cache, in a
+background thread, and removes those that are no longer up to date. Cached templates
+can then be reused without checking their source on every request.
+"""
+from __future__ import annotations
+
+import asyncio
+import threading
+
+from typing import Any
+from typing import MutableMapping
+from typing import Optional
+from typing import TYPE_CHECKING
+
+from liquid.template import BoundTemplate
+from liquid.utils import LRUCache
+
+if TYPE_CHECKING:  # pragma: no cover
+    from liquid import Environment
+
+
+class TemplateWatcher:
+    """Periodically check that cached templates are up to date, and remove any that
+    are not from the environment's template cache.
+
+    Use a watcher with an environment that has ``auto_reload`` disabled, so template
+    sources are not checked every time a template is requested. Changed templates are
+    loaded again the next time they are requested after the watcher notices they have
+    changed.
+
+    .. code-block:: python
+
+        env = Environment(loader=FileSystemLoader("templates/"), auto_reload=False)
+
+        with TemplateWatcher(env, interval=2):
+            serve_forever()
+
+    Templates are checked with their ``uptodate`` callable, as given by the loader. For
+    :class:`liquid.loaders.FileSystemLoader`, that is a file modification time
+    comparison.
+
+    :param env: The environment whose template cache will be watched.
+    :type env: liquid.Environment
+    :param interval: The number of seconds to wait between checks. Defaults to ``1``.
+    :type interval: float
+    """
+
+    def __init__(self, env: Environment, interval: float = 1):
+        self.env = env
+        self.interval = interval
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+
+    def __enter__(self) -> TemplateWatcher:
+        self.start()
+        return self
+
+    def __exit__(self, *args: Any) -> None:
+        self.stop()
+
+    @property
+    def running(self) -> bool:
+        """``True`` if the watcher's background thread is running."""
+        return self._thread is not None and self._thread.is_alive()
+
+    def start(self) -> None:
+        """Start watching templates in a daemon thread."""
+        if self.running:
+            return
+
+        self._stop.clear()
+        self._thread = threading.Thread(
+            target=self._run, name="liquid-template-watcher", daemon=True
+        )
+        self._thread.start()
+
+    def stop(self) -> None:
+        """Stop watching templates and wait for the background thread to finish."""
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join()
+            self._thread = None
+
+    def _run(self) -> None:
+        while not self._stop.wait(self.interval):
+            self.check()
+
+    def check(self) -> int:
+        """Remove templates that are not up to date from the cache, now.
+
+        :returns: The number of templates removed from the cache.
+        :rtype: int
+        """
+        cache = self.env.cache
+        removed = 0
+
+        for name, template in list(cache.items()):
+            if not isinstance(template, BoundTemplate):
+                continue
+
+            # Don't remove a template that has been replaced since we looked.
+            if not self._is_up_to_date(template) and _pop_if(cache, name, template):
+                removed += 1
+
+        if removed:
+            # Partial templates linked to `include` and `render` tags are looked up
+            # again.
+            self.env.bump_cache_version()
+        return removed
+
+    @staticmethod
+    def _is_up_to_date(template: BoundTemplate) -> bool:
+        if not template.uptodate:
+            return True
+
+        try:
+            uptodate = template.uptodate()
+            if asyncio.iscoroutine(uptodate):
+                uptodate = asyncio.run(uptodate)
+        except Exception:  # pylint: disable=broad-except
+            # Probably a missing file. Let the loader decide, next time the template
+            # is requested.
+            return False
+
+        return bool(uptodate)
+
+
+def _pop_if(cache: MutableMapping[Any, Any], name: str, template: object) -> bool:
+    if isinstance(cache, LRUCache):
+        return cache.pop_if(name, template)
+
+    # Without a lock, we can only avoid removing a template that was replaced before
+    # we looked.
+    if cache.get(name) is template:
+        cache.pop(name, None)
+        return True
+    return False
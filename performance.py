@@ -28,6 +28,7 @@ from liquid.mode import Mode
 from liquid.loaders import FileSystemLoader
 from liquid.token import Token
 from liquid.lex import get_lexer
+from liquid.profiler import Profiler
 
 from tests.mocks.tags.form_tag import CommentFormTag
 from tests.mocks.tags.paginate_tag import PaginateTag
@@ -299,6 +300,15 @@ def profile_parse_and_render(search_path: str):
     )
 
 
+def profile_nodes(search_path: str):
+    templates = setup_render(search_path)
+
+    with Profiler() as profiler:
+        render(templates)
+
+    print(profiler.format_report(limit=30))
+
+
 def setup_render(search_path: str) -> List[ThemedTemplate]:
     env, template_sources = setup_parse(search_path)
     parsed_templates = parse(env, template_sources)
@@ -415,8 +425,10 @@ def main():
         # profile_parse(search_path)
         # profile_lex(search_path)
         # profile_compile(search_path)
+    elif n_args == 1 and args[0] == "--profile-nodes":
+        profile_nodes(search_path)
     else:
-        sys.stderr.write("usage: python performance.py [--profile]\n")
+        sys.stderr.write("usage: python performance.py [--profile | --profile-nodes]\n")
         sys.exit(1)
 
 
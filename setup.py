@@ -17,7 +17,7 @@ setuptools.setup(
     long_description=long_description,
     long_description_content_type="text/x-rst",
     url="https://github.com/jg-rp/liquid",
-    packages=setuptools.find_packages(exclude=["tests*"]),
+    packages=setuptools.find_packages(exclude=["tests*", "benchmarks*"]),
     include_package_data=True,
     zip_safe=False,
     install_requires=["python-dateutil>=2.8.1"],
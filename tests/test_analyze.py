@@ -0,0 +1,130 @@
+"""Template static analysis test cases."""
+
+import unittest
+
+from liquid import Environment
+
+from liquid.exceptions import TemplateNotFound
+from liquid.loaders import DictLoader
+
+from tests.mocks.tags.form_tag import CommentFormTag
+
+
+class AnalyzeTemplateTestCase(unittest.TestCase):
+    """Template static analysis test cases."""
+
+    def setUp(self) -> None:
+        self.env = Environment(
+            loader=DictLoader(
+                {
+                    "header": "{{ shop.name | upcase }}{% assign title = page.title %}",
+                    "product": (
+                        "{{ product.title }}{{ forloop.index }}{{ currency }}"
+                        "{% render 'product' %}"
+                    ),
+                }
+            )
+        )
+
+    def test_variables(self):
+        """Test that we report global and local variables."""
+        template = self.env.from_string(
+            "{% assign x = y | default: 'z' %}{{ x }}\n"
+            "{% for item in collection.products limit: n %}"
+            "{{ item.title }}{{ forloop.index }}{{ prices[item.id] }}"
+            "{% endfor %}\n"
+            "{% capture c %}{{ a }}{% endcapture %}{{ c }}",
+            name="index",
+        )
+        analysis = template.analyze()
+
+        self.assertEqual(
+            analysis.global_variables,
+            {
+                "y": [("index", 1)],
+                "collection": [("index", 2)],
+                "n": [("index", 2)],
+                "prices": [("index", 2)],
+                "a": [("index", 3)],
+            },
+        )
+        self.assertEqual(
+            analysis.local_variables,
+            {"x": [("index", 1)], "c": [("index", 3)]},
+        )
+        self.assertIn("prices.[item.id]", analysis.variables)
+        self.assertIn("item.id", analysis.variables)
+        self.assertEqual(analysis.filters, {"default": [("index", 1)]})
+
+    def test_conditional_assign(self):
+        """Test that variables assigned in a branch might still be global."""
+        template = self.env.from_string(
+            "{% if a %}{% assign b = 1 %}{{ b }}{% endif %}{{ b }}"
+        )
+        analysis = template.analyze()
+        self.assertEqual(list(analysis.global_variables), ["a", "b"])
+        self.assertEqual(len(analysis.global_variables["b"]), 1)
+
+    def test_partials(self):
+        """Test that we analyze included and rendered templates."""
+        template = self.env.from_string(
+            "{% assign shop = x %}{% include 'header' %}"
+            "{% render 'product' for products as product, currency: c %}"
+        )
+        analysis = template.analyze()
+
+        self.assertEqual(
+            analysis.templates,
+            {
+                "header": [("", 1)],
+                "product": [("", 1), ("product", 1)],
+            },
+        )
+        self.assertEqual(
+            analysis.global_variables,
+            {
+                "x": [("", 1)],
+                "page": [("header", 1)],
+                "products": [("", 1)],
+                "c": [("", 1)],
+            },
+        )
+        self.assertEqual(analysis.filters, {"upcase": [("header", 1)]})
+
+    def test_dont_follow_partials(self):
+        """Test that we can analyze a template without loading partials."""
+        template = self.env.from_string("{% include 'nosuchthing' %}")
+
+        with self.assertRaises(TemplateNotFound):
+            template.analyze()
+
+        analysis = template.analyze(follow_partials=False)
+        self.assertEqual(analysis.templates, {"nosuchthing": [("", 1)]})
+
+        analysis = template.analyze(raise_for_failures=False)
+        self.assertEqual(analysis.templates, {"nosuchthing": [("", 1)]})
+
+    def test_unknown_templates(self):
+        """Test that we flag partial templates with dynamic names."""
+        template = self.env.from_string("{% include section.name %}")
+        analysis = template.analyze()
+
+        self.assertEqual(analysis.templates, {})
+        self.assertEqual(analysis.unknown_templates, {"section.name": [("", 1)]})
+        self.assertEqual(analysis.global_variables, {"section": [("", 1)]})
+
+    def test_custom_tags(self):
+        """Test that we find expressions in nodes from custom tags."""
+        self.env.add_tag(CommentFormTag)
+        template = self.env.from_string(
+            "{% form article %}{{ form.errors | default: x }}{% endform %}"
+        )
+        analysis = template.analyze()
+
+        self.assertIn("article", analysis.global_variables)
+        self.assertIn("x", analysis.global_variables)
+        self.assertEqual(list(analysis.filters), ["default"])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -1,6 +1,7 @@
 """Test Python Liquid's async API."""
 import asyncio
 import tempfile
+import threading
 import time
 import unittest
 
@@ -15,7 +16,13 @@ from liquid import Template
 from liquid import Environment
 from liquid import FileSystemLoader
 
+from liquid.exceptions import LiquidSyntaxError
+from liquid.exceptions import TemplateNotFound
+from liquid.loaders import BatchLoader
+from liquid.loaders import TemplateSource
+
 from liquid.template import BoundTemplate
+from liquid.utils import LRUCache
 
 
 class Case(NamedTuple):
@@ -311,3 +318,226 @@ class AsyncDropTestCase(unittest.TestCase):
         self.assertEqual(result, "hello")
         self.assertEqual(self.drop.await_count, 0)
         self.assertEqual(self.drop.call_count, 1)
+
+
+class MockBatchLoader(BatchLoader):
+    """A batch loader that records the names requested in each batch."""
+
+    def __init__(self, templates):
+        super().__init__()
+        self.templates = templates
+        self.batches = []
+
+    async def get_sources_async(self, env, template_names):
+        self.batches.append(sorted(template_names))
+        await asyncio.sleep(0)
+        return {
+            name: TemplateSource(self.templates[name], name, None)
+            for name in template_names
+            if name in self.templates
+        }
+
+
+class BatchLoaderTestCase(unittest.TestCase):
+    """Test that we can load partial templates in batches."""
+
+    def setUp(self) -> None:
+        self.templates = {
+            "index": "{% render 'header' %}{% include 'footer' %}{% include name %}",
+            "header": "{% render 'nav' %}{% render 'logo' %}",
+            "footer": "{% render 'nav' %}(footer)",
+            "nav": "(nav)",
+            "logo": "(logo)",
+            "dynamic": "(dynamic)",
+            "broken": "{% if %}",
+        }
+
+    def test_concurrent_lookups_are_batched(self):
+        """Test that concurrent calls to `get_source_async` are fetched together."""
+        loader = MockBatchLoader(self.templates)
+        env = Environment(loader=loader)
+
+        async def coro():
+            return await asyncio.gather(
+                loader.get_source_async(env, "nav"),
+                loader.get_source_async(env, "logo"),
+                loader.get_source_async(env, "nav"),
+            )
+
+        sources = asyncio.run(coro())
+        self.assertEqual(
+            [source.source for source in sources], ["(nav)", "(logo)", "(nav)"]
+        )
+        self.assertEqual(loader.batches, [["logo", "nav"]])
+
+    def test_template_not_found(self):
+        """Test that missing templates from a batch raise TemplateNotFound."""
+        loader = MockBatchLoader(self.templates)
+        env = Environment(loader=loader)
+
+        async def coro():
+            return await env.get_template_async("nosuchthing")
+
+        with self.assertRaises(TemplateNotFound):
+            asyncio.run(coro())
+
+    def test_pending_batches_are_referenced(self):
+        """Test that the loader keeps a reference to batches that are being fetched,
+        and forgets them when they're done."""
+        loader = MockBatchLoader(self.templates)
+        env = Environment(loader=loader)
+
+        async def coro():
+            lookup = asyncio.ensure_future(loader.get_source_async(env, "nav"))
+            await asyncio.sleep(0)
+            await asyncio.sleep(0)
+            # pylint: disable=protected-access
+            self.assertEqual(len(loader._tasks), 1)
+            source = await lookup
+            await asyncio.sleep(0)
+            self.assertEqual(len(loader._tasks), 0)
+            return source
+
+        self.assertEqual(asyncio.run(coro()).source, "(nav)")
+
+    def test_batches_per_event_loop(self):
+        """Test that lookups from different event loops are not batched together."""
+        loader = MockBatchLoader(self.templates)
+        env = Environment(loader=loader)
+        results = []
+
+        def other_loop():
+            results.append(asyncio.run(loader.get_source_async(env, "logo")))
+
+        async def coro():
+            lookup = asyncio.ensure_future(loader.get_source_async(env, "nav"))
+            await asyncio.sleep(0)
+
+            # The first batch has not been dispatched yet.
+            thread = threading.Thread(target=other_loop, daemon=True)
+            thread.start()
+            thread.join(timeout=5)
+            self.assertFalse(thread.is_alive())
+            return await lookup
+
+        self.assertEqual(asyncio.run(coro()).source, "(nav)")
+        self.assertEqual([source.source for source in results], ["(logo)"])
+        self.assertEqual(loader.batches, [["logo"], ["nav"]])
+
+    def test_get_source(self):
+        """Test that we can load templates synchronously from a batch loader."""
+        loader = MockBatchLoader(self.templates)
+        env = Environment(loader=loader)
+
+        self.assertEqual(
+            env.get_template("index").render(name="dynamic"),
+            "(nav)(logo)(nav)(footer)(dynamic)",
+        )
+        self.assertEqual(loader.batches[0], ["index"])
+        self.assertTrue(all(len(batch) == 1 for batch in loader.batches))
+
+        with self.assertRaises(TemplateNotFound):
+            env.get_template("nosuchthing")
+
+        async def coro():
+            return loader.get_source(env, "logo")
+
+        self.assertEqual(asyncio.run(coro()).source, "(logo)")
+
+    def test_preload_partials(self):
+        """Test that we can load a template's partials one level at a time."""
+        loader = MockBatchLoader(self.templates)
+        env = Environment(loader=loader, preload_partials=True)
+
+        async def coro():
+            template = await env.get_template_async("index")
+            batches = list(loader.batches)
+            return batches, await template.render_async(name="dynamic")
+
+        batches, result = asyncio.run(coro())
+        self.assertEqual(batches, [["index"], ["footer", "header"], ["logo", "nav"]])
+        self.assertEqual(result, "(nav)(logo)(nav)(footer)(dynamic)")
+        self.assertEqual(loader.batches[3:], [["dynamic"]])
+
+    def test_preload_partials_with_loader_hook(self):
+        """Test that preloaded partials are made by the loader's `load_from_source`
+        method."""
+
+        class GlobalsLoader(MockBatchLoader):
+            """A batch loader that adds globals to the templates it loads."""
+
+            def load_from_source(self, env, name, template_source, globals=None):
+                globals = dict(globals or {}, loaded_by="hook")
+                return super().load_from_source(env, name, template_source, globals)
+
+        loader = GlobalsLoader({"index": "{% render 'part' %}", "part": "part"})
+        env = Environment(loader=loader, preload_partials=True)
+
+        async def coro():
+            await env.get_template_async("index")
+
+        asyncio.run(coro())
+        self.assertEqual(loader.batches, [["index"], ["part"]])
+        self.assertEqual(env.cache["part"].globals["loaded_by"], "hook")
+
+    def test_preload_partials_with_load_async(self):
+        """Test that partials are preloaded with `load_async` if a loader overrides
+        it without overriding `load_from_source`."""
+
+        class AsyncLoader(MockBatchLoader):
+            """A batch loader that adds globals in `load_async`."""
+
+            async def load_async(self, env, name, globals=None):
+                template = await super().load_async(env, name, globals)
+                return template.with_globals({"loaded_by": "load_async"})
+
+        loader = AsyncLoader({"index": "{% render 'part' %}", "part": "part"})
+        env = Environment(loader=loader, preload_partials=True)
+
+        async def coro():
+            await env.get_template_async("index")
+
+        asyncio.run(coro())
+        self.assertEqual(env.cache["part"].globals["loaded_by"], "load_async")
+
+    def test_preload_partials_cache_stats(self):
+        """Test that looking for cached partials doesn't count as a cache hit."""
+        loader = MockBatchLoader(self.templates)
+        cache = LRUCache(capacity=10)
+        env = Environment(loader=loader, cache=cache, preload_partials=True)
+
+        async def coro():
+            await env.get_template_async("nav")
+            await env.get_template_async("footer")
+
+        asyncio.run(coro())
+        self.assertEqual(cache.cache_info().hits, 0)
+        self.assertEqual(cache.keys(), ["footer", "nav"])
+
+    def test_preload_partials_from_file_system(self):
+        """Test that we can preload partials with a loader that doesn't batch."""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            for name in ("index", "header", "footer", "nav", "logo"):
+                Path(tmpdir, name).write_text(self.templates[name])
+
+            env = Environment(loader=FileSystemLoader(tmpdir), preload_partials=True)
+
+            async def coro():
+                await env.get_template_async("index")
+
+            asyncio.run(coro())
+            self.assertEqual(
+                sorted(env.cache), ["footer", "header", "index", "logo", "nav"]
+            )
+
+    def test_preload_broken_partial(self):
+        """Test that errors in preloaded partials are raised when they are rendered."""
+        loader = MockBatchLoader(self.templates)
+        env = Environment(loader=loader, preload_partials=True)
+
+        async def coro():
+            template = await env.get_template_async("index")
+            await template.render_async(name="broken")
+
+        with self.assertRaises(LiquidSyntaxError):
+            asyncio.run(coro())
@@ -85,6 +85,30 @@ class AutoescapeTestCase(TestCase):
                     "</p>"
                 ),
             ),
+            Case(
+                description="html string literal",
+                template=r"{{ '<br>' }}",
+                context={},
+                expect="<br>",
+            ),
+            Case(
+                description="numbers, booleans and nil",
+                template=r"{{ a }}{{ b }}{{ c }}{{ d }}",
+                context={"a": 1, "b": 2.5, "c": True, "d": None},
+                expect="12.5true",
+            ),
+            Case(
+                description="unsafe array",
+                template=r"{{ foo }}",
+                context={"foo": ["<p>", 1, "&"]},
+                expect="&lt;p&gt;1&amp;",
+            ),
+            Case(
+                description="mixed array",
+                template=r"{{ foo }}",
+                context={"foo": [Markup("<p>"), "<p>"]},
+                expect="<p>&lt;p&gt;",
+            ),
         ]
 
         env = Environment(autoescape=True)
@@ -464,6 +488,12 @@ class AutoescapeTestCase(TestCase):
                 context={"some": Markup("&lt;p&gt;test&lt;/p&gt;<p>test</p>")},
                 expect="&lt;p&gt;test&lt;/p&gt;&lt;p&gt;test&lt;/p&gt;",
             ),
+            Case(
+                description="escape once without entities",
+                template=r"{{ some | escape_once }}",
+                context={"some": Markup("<p>test</p>")},
+                expect="&lt;p&gt;test&lt;/p&gt;",
+            ),
         ]
 
         env = Environment(autoescape=True)
@@ -522,6 +552,18 @@ class AutoescapeTestCase(TestCase):
                 },
                 expect="<p>hello</p><hr>&lt;p&gt;goodbye&lt;/p&gt;",
             ),
+            Case(
+                description="join unsafe iterable and literal separator",
+                template=r"{{ foo | join: ', ' }}",
+                context={"foo": ["<p>hello</p>", "<p>goodbye</p>"]},
+                expect="&lt;p&gt;hello&lt;/p&gt;, &lt;p&gt;goodbye&lt;/p&gt;",
+            ),
+            Case(
+                description="join unsafe iterable and html literal separator",
+                template=r"{{ foo | join: '<hr>' }}",
+                context={"foo": ["<p>hello</p>", "<p>goodbye</p>"]},
+                expect="&lt;p&gt;hello&lt;/p&gt;<hr>&lt;p&gt;goodbye&lt;/p&gt;",
+            ),
         ]
 
         env = Environment(autoescape=True)
@@ -0,0 +1,111 @@
+"""Batch rendering test cases."""
+
+import unittest
+import warnings
+
+from liquid import Environment
+from liquid import Mode
+
+from liquid.batch import render_many
+from liquid.compiler import CompiledBoundTemplate
+from liquid.exceptions import FilterArgumentError
+from liquid.exceptions import LiquidWarning
+from liquid.loaders import DictLoader
+
+
+class RenderManyTestCase(unittest.TestCase):
+    """Test cases for rendering one template with many sets of context data."""
+
+    def setUp(self) -> None:
+        self.env = Environment(
+            loader=DictLoader({"greeting": "Hello, {{ you }}!"}),
+        )
+        self.source = "{% render 'greeting', you: name %} ({{ n | times: 2 }})"
+        self.items = [{"name": f"user{i}", "n": i} for i in range(20)]
+        self.expect = [f"Hello, user{i}! ({i * 2})" for i in range(20)]
+
+    def test_render_many_in_order(self):
+        """Test that we can render many items with a pool of workers."""
+        template = self.env.from_string(self.source)
+        results = list(template.render_many(self.items, workers=2, chunksize=3))
+        self.assertEqual(results, self.expect)
+
+    def test_render_many_as_completed(self):
+        """Test that we can get results in the order they finish."""
+        template = self.env.from_string(self.source)
+        results = list(
+            render_many(template, self.items, workers=2, ordered=False, chunksize=3)
+        )
+        self.assertEqual(sorted(results), list(enumerate(self.expect)))
+
+    def test_render_many_in_process(self):
+        """Test that one worker renders items in this process."""
+        template = self.env.from_string(self.source)
+        self.assertEqual(list(template.render_many(self.items, workers=1)), self.expect)
+        self.assertEqual(
+            list(render_many(template, self.items[:2], workers=1, ordered=False)),
+            list(enumerate(self.expect[:2])),
+        )
+
+    def test_lazy_items(self):
+        """Test that we can render items from a generator."""
+        template = self.env.from_string(self.source)
+        results = template.render_many(
+            (item for item in self.items), workers=2, chunksize=4
+        )
+        self.assertEqual(list(results), self.expect)
+
+    def test_compiled_template(self):
+        """Test that workers render with the template's class."""
+        self.env.template_class = CompiledBoundTemplate
+        template = self.env.from_string(self.source)
+        self.assertEqual(list(template.render_many(self.items, workers=2)), self.expect)
+
+    def test_strict_mode(self):
+        """Test that errors are raised for the item that failed."""
+        template = self.env.from_string("{{ 10 | divided_by: n }}")
+        items = [{"n": 5}, {"n": 0}, {"n": 2}]
+        results = template.render_many(items, workers=2, chunksize=1)
+
+        self.assertEqual(next(results), "2")
+        with self.assertRaises(FilterArgumentError):
+            next(results)
+
+    def test_return_exceptions(self):
+        """Test that we can yield errors in place of output."""
+        template = self.env.from_string("{{ 10 | divided_by: n }}")
+        items = [{"n": 5}, {"n": 0}, {"n": 2}]
+        results = list(
+            template.render_many(items, workers=2, chunksize=1, return_exceptions=True)
+        )
+
+        self.assertEqual(results[0], "2")
+        self.assertIsInstance(results[1], FilterArgumentError)
+        self.assertEqual(results[2], "5")
+
+    def test_warn_mode(self):
+        """Test that warnings from workers are issued in this process."""
+        env = Environment(tolerance=Mode.WARN)
+        template = env.from_string("{{ 10 | divided_by: n }}")
+        items = [{"n": 5}, {"n": 0}]
+
+        with warnings.catch_warnings(record=True) as caught:
+            warnings.simplefilter("always")
+            results = list(template.render_many(items, workers=2, chunksize=1))
+
+        self.assertEqual(results, ["2", ""])
+        self.assertEqual(len(caught), 1)
+        self.assertTrue(issubclass(caught[0].category, LiquidWarning))
+
+    def test_lax_mode(self):
+        """Test that errors are ignored in lax mode."""
+        env = Environment(tolerance=Mode.LAX)
+        template = env.from_string("{{ 10 | divided_by: n }}")
+        items = [{"n": 5}, {"n": 0}]
+        self.assertEqual(list(template.render_many(items, workers=2)), ["2", ""])
+
+    def test_invalid_chunksize(self):
+        """Test that the chunk size must be positive."""
+        template = self.env.from_string(self.source)
+        with self.assertRaises(ValueError):
+            list(template.render_many(self.items, chunksize=0))
@@ -0,0 +1,219 @@
+"""Parse tree compaction test cases."""
+
+import asyncio
+import pickle
+import unittest
+
+from typing import TextIO
+
+from liquid import Environment
+
+from liquid.ast import Node
+from liquid.context import Context
+from liquid.stream import TokenStream
+from liquid.tag import Tag
+from liquid.token import Token
+
+from liquid.builtin.literal import LiteralNode
+from liquid.builtin.statement import StatementNode
+from liquid.builtin.tags.if_tag import IfNode
+
+from liquid.exceptions import DisabledTagError
+from liquid.exceptions import FilterArgumentError
+from liquid.loaders import DictLoader
+from liquid.template import AwareBoundTemplate
+from liquid.tree_cache import DictTreeCache
+
+from tests import test_render
+
+
+class CompactRenderTestCases(test_render.RenderTestCases):
+    """Run all render test cases with compacted parse trees."""
+
+    def _test_sync(self, test_cases, template_class=AwareBoundTemplate):
+        for case in test_cases:
+            env = Environment(loader=DictLoader(case.partials), compact_trees=True)
+            env.template_class = template_class
+
+            template = env.from_string(case.template, globals=case.globals)
+
+            with self.subTest(msg=case.description):
+                self.assertEqual(template.render(), case.expect)
+
+    def _test_async(self, test_cases, template_class=AwareBoundTemplate):
+        for case in test_cases:
+            env = Environment(loader=DictLoader(case.partials), compact_trees=True)
+            env.template_class = template_class
+
+            template = env.from_string(case.template, globals=case.globals)
+
+            with self.subTest(msg=case.description, asynchronous=True):
+                self.assertEqual(asyncio.run(template.render_async()), case.expect)
+
+
+class CompactTestCase(unittest.TestCase):
+    """Parse tree compaction test cases."""
+
+    def setUp(self) -> None:
+        self.env = Environment(compact_trees=True)
+
+    def test_discard_statement_source(self):
+        """Test that output statements don't keep their expression's source."""
+        template = self.env.from_string("{{ a | upcase }}")
+        node = template.tree.statements[0]
+
+        self.assertIsInstance(node, StatementNode)
+        self.assertEqual(node.tok.value, "")
+        self.assertEqual(node.tok.linenum, 1)
+        self.assertEqual(template.render(a="b"), "B")
+
+    def test_share_literals(self):
+        """Test that equal template literals are shared between templates."""
+        first = self.env.from_string("Hello, {{ you }}!\n{% if x %}{% endif %}")
+        second = self.env.from_string("Hello, {{ me }}!\n{{ x }}")
+
+        self.assertIsInstance(first.tree.statements[0], LiteralNode)
+        self.assertIs(first.tree.statements[0], second.tree.statements[0])
+        self.assertIs(first.tree.statements[2], second.tree.statements[2])
+
+    def test_share_tag_tokens(self):
+        """Test that equal tag tokens are shared between templates."""
+        first = self.env.from_string("{% if a %}a{% endif %}")
+        second = self.env.from_string("{% if b %}b{% endif %}")
+
+        self.assertIsInstance(first.tree.statements[0], IfNode)
+        self.assertEqual(first.tree.statements[0].tok.value, "if")
+        self.assertIs(first.tree.statements[0].tok, second.tree.statements[0].tok)
+
+    def test_line_numbers(self):
+        """Test that errors raised at render time report the right line number."""
+        template = self.env.from_string("\n\n{{ 1 | divided_by: 0 }}")
+
+        with self.assertRaises(FilterArgumentError) as raised:
+            template.render()
+        self.assertEqual(raised.exception.linenum, 3)
+
+    def test_disabled_tags(self):
+        """Test that disabled tags are still detected at render time."""
+        env = Environment(
+            loader=DictLoader({"part": "{% include 'other' %}", "other": "x"}),
+            compact_trees=True,
+        )
+        template = env.from_string("{% render 'part' %}")
+
+        with self.assertRaises(DisabledTagError):
+            template.render()
+
+    def test_compact_after_optimizing(self):
+        """Test that we can compact optimized parse trees."""
+        env = Environment(optimize=True, compact_trees=True)
+        template = env.from_string("a{% if true %}b{% endif %}{{ x }}")
+
+        self.assertEqual(len(template.tree.statements), 2)
+        self.assertEqual(template.render(x="c"), "abc")
+
+    def test_pickle(self):
+        """Test that we can pickle and unpickle compacted templates."""
+        template = self.env.from_string("{% for x in y %}{{ x }}, {% endfor %}")
+        template = pickle.loads(pickle.dumps(template))
+        self.assertEqual(template.render(y=[1, 2]), "1, 2, ")
+
+    def test_tree_cache(self):
+        """Test that compacted and full parse trees are cached separately, and that
+        trees loaded from a tree cache are compacted."""
+        tree_cache = DictTreeCache()
+        self.assertNotEqual(
+            tree_cache.key(Environment(), "hello"),
+            tree_cache.key(self.env, "hello"),
+        )
+
+        Environment(tree_cache=tree_cache, compact_trees=True).from_string("a{{ b }}")
+        env = Environment(tree_cache=tree_cache, compact_trees=True)
+        first = env.from_string("a{{ b }}")
+        second = env.from_string("a{{ b }}")
+        self.assertIs(first.tree.statements[0], second.tree.statements[0])
+
+    def test_preload(self):
+        """Test that preloaded templates are compacted, whether they are parsed by
+        worker processes, by this process or loaded from a tree cache."""
+        templates = {
+            "a": "Hello, {{ you }}!{% if x %}{% endif %}",
+            "b": "Hello, {{ me }}!",
+        }
+
+        for workers, tree_cache in ((None, None), (1, None), (1, DictTreeCache())):
+            with self.subTest(workers=workers, tree_cache=bool(tree_cache)):
+                if tree_cache is not None:
+                    Environment(
+                        loader=DictLoader(templates),
+                        tree_cache=tree_cache,
+                        compact_trees=True,
+                    ).preload("*", workers=1)
+
+                env = Environment(
+                    loader=DictLoader(templates),
+                    tree_cache=tree_cache,
+                    compact_trees=True,
+                )
+                preloaded = env.preload("*", workers=workers)
+                template = env.from_string("Hello, {{ them }}!")
+
+                literal = template.tree.statements[0]
+                self.assertIs(preloaded["a"].tree.statements[0], literal)
+                self.assertIs(preloaded["b"].tree.statements[0], literal)
+                self.assertEqual(preloaded["a"].tree.statements[1].tok.value, "")
+                self.assertEqual(preloaded["a"].render(you="World"), "Hello, World!")
+
+    def test_cache_sizes(self):
+        """Test that we can report the memory retained by each cached template."""
+        loader = DictLoader(
+            {
+                "a": "Hello, {{ you }}!",
+                "b": "Hello, {{ you }}!" + " " * 1000,
+            }
+        )
+
+        for compact_trees in (False, True):
+            env = Environment(loader=loader, compact_trees=compact_trees)
+            env.get_template("a")
+            env.get_template("b")
+            sizes = env.cache_sizes()
+
+            with self.subTest(compact_trees=compact_trees):
+                self.assertEqual(sorted(sizes), ["a", "b"])
+                self.assertGreaterEqual(sizes["b"], sizes["a"] + 1000)
+
+                # The output statement's expression is shared.
+                self.assertLess(sizes["a"], env.get_template("a").estimate_size())
+
+    def test_custom_tags(self):
+        """Test that nodes from custom tags are left as they are."""
+
+        class SourceNode(Node):
+            """Renders its expression's source text."""
+
+            __slots__ = ("tok",)
+
+            def __init__(self, tok: Token):
+                self.tok = tok
+
+            def render_to_output(self, context: Context, buffer: TextIO) -> None:
+                buffer.write(self.tok.value)
+
+        class SourceTag(Tag):
+            """A custom tag that keeps its expression's token."""
+
+            name = "source"
+            block = False
+
+            def parse(self, stream: TokenStream) -> Node:
+                stream.next_token()
+                return SourceNode(stream.current)
+
+        self.env.add_tag(SourceTag)
+        template = self.env.from_string("{% source a | upcase %}{{ a }}")
+        self.assertEqual(template.render(a="b"), "a | upcaseb")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,135 @@
+"""Compiled template test cases."""
+
+import asyncio
+import unittest
+
+from liquid.environment import Environment
+from liquid.template import AwareBoundTemplate
+from liquid.mode import Mode
+from liquid.loaders import DictLoader
+
+from liquid.compiler import CompiledBoundTemplate
+from liquid.compiler import generate_source
+
+from liquid.exceptions import DisabledTagError
+from liquid.exceptions import FilterArgumentError
+from liquid.exceptions import LiquidSyntaxError
+from liquid.exceptions import lookup_warning
+
+from tests import test_render
+from tests.mocks.tags.form_tag import CommentFormTag
+
+
+class CompiledAwareBoundTemplate(CompiledBoundTemplate, AwareBoundTemplate):
+    """A compiled template with a `template` drop."""
+
+
+class CompiledRenderTestCases(test_render.RenderTestCases):
+    """Run all render test cases with compiled templates."""
+
+    def _test(self, test_cases, template_class=CompiledAwareBoundTemplate):
+        super()._test(test_cases, template_class=CompiledAwareBoundTemplate)
+
+
+class CompiledTemplateTestCase(unittest.TestCase):
+    """Compiled template specific test cases."""
+
+    def setUp(self) -> None:
+        self.env = Environment()
+        self.env.template_class = CompiledBoundTemplate
+
+    def test_template_class(self):
+        """Test that an environment's template class is a compiled template."""
+        template = self.env.from_string("Hello, {{ you }}!")
+        self.assertIsInstance(template, CompiledBoundTemplate)
+        self.assertEqual(template.render(you="World"), "Hello, World!")
+
+    def test_compile_once(self):
+        """Test that templates are compiled on first render, and only once."""
+        template = self.env.from_string("Hello, {{ you }}!")
+        render_func = template.render_func
+        template.render(you="World")
+        self.assertIs(template.render_func, render_func)
+
+    def test_generated_source(self):
+        """Test that we can inspect generated source code."""
+        template = self.env.from_string("{% if x %}{{ x | upcase }}{% endif %}")
+        self.assertTrue(generate_source(template.tree).startswith("def render("))
+        self.assertTrue(
+            generate_source(template.tree, is_async=True).startswith("async def render(")
+        )
+
+    def test_custom_tags(self):
+        """Test that nodes from custom tags fall back to their own render method."""
+        self.env.add_tag(CommentFormTag)
+        source = (
+            r"{% for x in (1..2) %}"
+            r"{% form article %}{{ form.errors | default: x }}{% endform %}"
+            r"{% endfor %}"
+        )
+
+        template = self.env.from_string(source)
+        reference = Environment()
+        reference.add_tag(CommentFormTag)
+
+        expect = reference.from_string(source).render(article={"id": 1})
+        self.assertEqual(template.render(article={"id": 1}), expect)
+        self.assertEqual(
+            asyncio.run(template.render_async(article={"id": 1})),
+            expect,
+        )
+
+    def test_deeply_nested_blocks(self):
+        """Test that we can compile templates nested beyond Python's static block
+        limit."""
+        depth = 8
+        source = (
+            "{% for x in (1..2) %}" * depth + "{{ x }}" + "{% endfor %}" * depth
+        )
+        template = self.env.from_string(source)
+        self.assertEqual(template.render(), "12" * 2 ** (depth - 1))
+
+    def test_resume_block(self):
+        """Test that we continue to execute a block after a single statement error."""
+        source = (
+            r"{% if true %}"
+            r"before error "
+            r"{{ 'foo' | upcase: bad }}"
+            r"after error"
+            r"{% endif %}"
+        )
+
+        template = self.env.from_string(source)
+        with self.assertRaises(FilterArgumentError):
+            template.render()
+
+        self.env.mode = Mode.LAX
+        self.assertEqual(template.render(), "before error after error")
+
+        self.env.mode = Mode.WARN
+        with self.assertWarns(lookup_warning(FilterArgumentError)):
+            result = template.render()
+        self.assertEqual(result, "before error after error")
+
+    def test_unexpected_break(self):
+        """Test that a break outside of a loop is a syntax error."""
+        template = self.env.from_string("{% if true %}{% break %}{% endif %}")
+        with self.assertRaises(LiquidSyntaxError) as raised:
+            template.render()
+        self.assertEqual(str(raised.exception), "unexpected 'break', on line 1")
+
+    def test_disabled_tags(self):
+        """Test that compiled partial templates respect disabled tags."""
+        self.env.loader = DictLoader(
+            {
+                "outer": "{% if true %}{% include 'inner' %}{% endif %}",
+                "inner": "hello",
+            }
+        )
+        template = self.env.from_string("{% render 'outer' %}")
+        with self.assertRaises(DisabledTagError):
+            template.render()
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -1,19 +1,32 @@
 """Bad context test cases."""
 
+import pickle
+import sys
+
 from unittest import TestCase
 
+from collections import ChainMap
+from collections import defaultdict
+
+from typing import Dict
 from typing import NamedTuple
 from typing import Type
 
 from liquid.context import builtin
+from liquid.context import Context
 from liquid.context import get_item
+from liquid.context import make_resolver
 from liquid.context import _undefined
 from liquid.context import ReadOnlyChainMap
+from liquid.context import Scope
+from liquid.context import Undefined
 from liquid.environment import Environment
 
 from liquid.exceptions import LiquidTypeError
+from liquid.exceptions import NoSuchFilterFunc
 from liquid.exceptions import lookup_warning
 
+from liquid.filter import with_context
 from liquid.mode import Mode
 
 
@@ -110,6 +123,116 @@ class ReadOnlyChainMapTestCase(TestCase):
         self.assertEqual(list(chain_map), ["foo", "bar", "foo"])
 
 
+class ScopeTestCase(TestCase):
+    """Render context scope test case."""
+
+    def test_push_and_pop(self):
+        """Test that pushed namespaces take priority until they are popped."""
+        scope = Scope({"a": 1}, {"a": 2, "b": 2})
+        self.assertEqual(scope["a"], 1)
+        self.assertEqual(scope.size(), 2)
+
+        outer = {"a": 3, "c": 3}
+        inner = {"a": 4}
+        scope.push(outer, fixed_keys=True)
+        scope.push(inner, fixed_keys=True)
+        self.assertEqual((scope["a"], scope["b"], scope["c"]), (4, 2, 3))
+        self.assertEqual(scope.size(), 4)
+
+        # Values can change after a namespace has been pushed.
+        inner["a"] = 5
+        self.assertEqual(scope["a"], 5)
+
+        self.assertIs(scope.pop(), inner)
+        self.assertEqual(scope["a"], 3)
+        self.assertIs(scope.pop(), outer)
+        self.assertEqual(scope["a"], 1)
+
+        with self.assertRaises(KeyError):
+            scope["c"]  # pylint: disable=pointless-statement
+
+    def test_removed_key(self):
+        """Test that we fall back to searching if a key is removed from a namespace
+        after it has been pushed."""
+        scope = Scope({"a": 1})
+        namespace = {"a": 2}
+        scope.push({"a": 3}, fixed_keys=True)
+        scope.push(namespace, fixed_keys=True)
+        del namespace["a"]
+        self.assertEqual(scope["a"], 3)
+        self.assertEqual(scope.get("a"), 3)
+
+    def test_mutate_namespace_after_push(self):
+        """Test that keys added to or removed from a namespace after it has been
+        pushed are visible, unless it was pushed with fixed keys."""
+        scope = Scope({"a": 1})
+        outer = {"b": 2}
+        inner: Dict[str, object] = {}
+        scope.push(outer, fixed_keys=True)
+        scope.push(inner)
+
+        inner["a"] = 3
+        outer["c"] = 4
+        self.assertEqual((scope["a"], scope.get("a")), (3, 3))
+        self.assertEqual((scope["c"], scope.get("c")), (4, 4))
+
+        inner["b"] = 5
+        self.assertEqual((scope["b"], scope.get("b")), (5, 5))
+        del inner["b"]
+        self.assertEqual((scope["b"], scope.get("b")), (2, 2))
+
+        scope.pop()
+        self.assertEqual((scope["a"], scope.get("a")), (1, 1))
+
+    def test_extend_and_mutate(self):
+        """Test that a custom tag can add names to a namespace after extending a
+        render context with it."""
+        context = Context(Environment(), globals={"a": 1})
+        namespace: Dict[str, object] = {}
+        with context.extend(namespace):
+            namespace["a"] = 2
+            namespace["b"] = 3
+            self.assertEqual((context.get(["a"]), context.get(["b"])), (2, 3))
+        self.assertEqual(context.get(["a"]), 1)
+
+    def test_unindexed_namespace(self):
+        """Test that we can push mappings that are not dictionaries."""
+        scope = Scope({"a": 1})
+        scope.push({"a": 2})
+        scope.push(ReadOnlyChainMap({"b": 3}))
+        self.assertEqual((scope["a"], scope["b"]), (2, 3))
+
+        scope.pop()
+        self.assertEqual(scope["a"], 2)
+        self.assertEqual(sorted(scope), ["a", "a"])
+        self.assertEqual(len(scope), 2)
+
+
+    def test_get(self):
+        """Test that we can get names from a scope with a default."""
+        scope = Scope({"a": 1}, ChainMap({"b": None}, defaultdict(lambda: 4)))
+        self.assertEqual(scope.get("a"), 1)
+        self.assertIsNone(scope.get("b", 2))
+
+        # Missing keys in mappings that are not dictionaries are looked up with
+        # `__getitem__`.
+        self.assertEqual(scope.get("c", 3), 4)
+
+        scope = Scope({"a": 1}, ReadOnlyChainMap({"b": 2}, builtin))
+        namespace = {"a": 2}
+        scope.push({"c": 3}, fixed_keys=True)
+        scope.push(namespace, fixed_keys=True)
+        del namespace["a"]
+        self.assertEqual(
+            (scope.get("a"), scope.get("b"), scope.get("c"), scope.get("d", 4)),
+            (1, 2, 3, 4),
+        )
+        self.assertIsNotNone(scope.get("now"))
+
+        scope.push(ReadOnlyChainMap({"d": 5}))
+        self.assertEqual((scope.get("d"), scope.get("e", 6)), (5, 6))
+
+
 class ChainedItemGetterTestCase(TestCase):
     """Chained item getter test case."""
 
@@ -153,6 +276,110 @@ class ChainedItemGetterTestCase(TestCase):
                 self.assertEqual(get_item(case["obj"], *case["key"]), case["expect"])
 
 
+class ResolverTestCase(TestCase):
+    """Precompiled identifier resolver test case."""
+
+    def test_resolver(self):
+        """Test that resolvers are equivalent to `Context.get`."""
+        env = Environment()
+        context = Context(
+            env,
+            globals={
+                "product": {
+                    "title": "foo",
+                    "variants": [{"price": 5}, {"price": 7}],
+                    "size": 99,
+                },
+                "tags": ("a", "b"),
+                "collection": {"products": [{"tags": ["c", "d", "e"]}]},
+            },
+        )
+
+        paths = [
+            ["product"],
+            ["product", "title"],
+            ["product", "variants", 0, "price"],
+            ["product", "variants", "last", "price"],
+            ["product", "variants", "size"],
+            ["product", "size"],
+            ["tags", "first"],
+            ["collection", "products", 0, "tags", "size"],
+            ["collection", "products", "first", "tags", -1],
+            ["product", "nosuchthing"],
+            ["product", "variants", 5, "price"],
+            ["product", "title", "first"],
+            ["nosuchthing", "foo", "bar"],
+        ]
+
+        for path in paths:
+            with self.subTest(path=path):
+                resolve = make_resolver(path[0], path[1:])
+                self.assertEqual(resolve(context), context.get(path))
+                self.assertIsInstance(resolve(context), type(context.get(path)))
+
+    def test_missing_keys_do_not_raise(self):
+        """Test that missing variables and keys in dictionaries are resolved without
+        raising an exception."""
+        env = Environment()
+        context = Context(
+            env,
+            globals=ChainMap(
+                {"product": {"title": "foo", "variants": [{"price": 5}]}},
+                ReadOnlyChainMap({"settings": {}}),
+            ),
+        )
+
+        paths = [
+            ["nosuchthing"],
+            ["nosuchthing", "foo"],
+            ["product", "nosuchthing"],
+            ["settings", "nosuchthing", "foo"],
+            ["product", "variants", "first", "nosuchthing"],
+            ["product", "variants", "first", "price", "nosuchthing", "foo"],
+        ]
+        resolvers = [make_resolver(path[0], path[1:]) for path in paths]
+
+        raised = []
+
+        def trace(frame, event, arg):
+            if event == "exception":
+                raised.append(arg[0])
+            return trace
+
+        previous = sys.gettrace()
+        sys.settrace(trace)
+        try:
+            results = [resolve(context) for resolve in resolvers]
+            results.extend(context.get(path) for path in paths)
+        finally:
+            sys.settrace(previous)
+
+        self.assertEqual(raised, [])
+        for path, result in zip(paths + paths, results):
+            with self.subTest(path=path):
+                self.assertIsInstance(result, Undefined)
+                self.assertEqual(result.name, path[0])
+
+    def test_identifier_resolver(self):
+        """Test that identifiers with static paths have a resolver."""
+        env = Environment()
+        template = env.from_string("{{ product.variants[0].price }}{{ a[b] }}")
+        static, dynamic = [
+            stmt.expression.expression for stmt in template.tree.statements
+        ]
+
+        self.assertIsNotNone(static.resolver)
+        self.assertIsNone(dynamic.resolver)
+        self.assertEqual(
+            template.render(product={"variants": [{"price": 5}]}, a={"c": 1}, b="c"),
+            "51",
+        )
+
+        copy = pickle.loads(pickle.dumps(static))
+        self.assertEqual(copy, static)
+        self.assertIsNotNone(copy.resolver)
+
+
 class BuiltinDynamicScopeTestCase(TestCase):
     """Built-in dynamic scope test case."""
 
@@ -175,3 +402,55 @@ class BuiltinDynamicScopeTestCase(TestCase):
     def test_builtin_iter(self):
         """Test that builtin has a length."""
         self.assertEqual(list(builtin), ["now", "today"])
+
+
+class ContextFilterTestCase(TestCase):
+    """Filter function lookup test case."""
+
+    def setUp(self) -> None:
+        self.env = Environment()
+
+    def test_filter_does_not_retain_context(self):
+        """Test that looking up a filter does not keep the context alive."""
+        context = Context(self.env)
+        refcount = sys.getrefcount(context)
+        context.filter("upcase")
+        context.filter("join")
+        self.assertEqual(sys.getrefcount(context), refcount)
+
+    def test_bind_filters_once(self):
+        """Test that filter functions are bound once per environment."""
+        self.assertIs(self.env.get_filter("join"), self.env.get_filter("join"))
+
+    def test_with_context_filter(self):
+        """Test that filters see the active context."""
+
+        @with_context
+        def greeting(val, *, context):
+            return f"{val} {context.resolve('you')}"
+
+        self.env.add_filter("greeting", greeting)
+        template = self.env.from_string("{{ 'Hello' | greeting }}")
+
+        self.assertEqual(template.render(you="World"), "Hello World")
+        self.assertEqual(template.render(you="there"), "Hello there")
+        self.assertEqual(
+            Context(self.env, globals={"you": "Liquid"}).filter("greeting")("Hi"),
+            "Hi Liquid",
+        )
+
+    def test_replace_filter(self):
+        """Test that replacing a registered filter replaces its bound function."""
+        template = self.env.from_string("{{ 'hello' | upcase }}")
+        self.assertEqual(template.render(), "HELLO")
+
+        self.env.add_filter("upcase", lambda val: val + "!")
+        self.assertEqual(template.render(), "hello!")
+
+        self.env.filters["upcase"] = lambda val: val + "?"
+        self.assertEqual(template.render(), "hello?")
+
+    def test_no_such_filter(self):
+        """Test that we raise a NoSuchFilterFunc for unknown filters."""
+        with self.assertRaises(NoSuchFilterFunc):
+            self.env.get_filter("nosuchthing")
@@ -574,6 +574,30 @@ class LiquidStatementEvalTestCase(unittest.TestCase):
                 expression="x in (1..foo.bar)",
                 expect=[1, 2, 3],
             ),
+            Case(
+                description="offset and limit",
+                context={"a": [1, 2, 3, 4, 5, 6]},
+                expression="i in a limit:3 offset:2",
+                expect=[3, 4, 5],
+            ),
+            Case(
+                description="reversed with offset and limit",
+                context={"a": [1, 2, 3, 4, 5, 6]},
+                expression="i in a limit:3 offset:2 reversed",
+                expect=[5, 4, 3],
+            ),
+            Case(
+                description="offset greater than length",
+                context={"a": [1, 2, 3]},
+                expression="i in a offset:5 reversed",
+                expect=[],
+            ),
+            Case(
+                description="loop over an iterable that is not a sequence",
+                context={"a": frozenset([1])},
+                expression="i in a",
+                expect=[1],
+            ),
         ]
 
         env = Environment()
@@ -604,3 +628,81 @@ class LiquidStatementEvalTestCase(unittest.TestCase):
 
         self.assertEqual(list(loopiter), [4, 5, 6])
         self.assertEqual(length, 3)
+
+    def test_eval_lazy_loop_expression(self):
+        """Test that we can loop over iterables without materializing them."""
+        env = Environment()
+
+        def gen(n):
+            yield from range(n)
+
+        stream = TokenStream(tokenize_loop_expression("i in a limit:2 offset:1"))
+        expr = parse_loop_expression(stream)
+
+        # A generator's length is unknown until it has been consumed.
+        loopiter, length = expr.evaluate(Context(env, {"a": gen(5)}))
+        self.assertIsNone(length)
+        self.assertEqual(list(loopiter), [1, 2])
+
+        loopiter, length = expr.evaluate(Context(env, {"a": gen(0)}))
+        self.assertEqual(length, 0)
+        self.assertEqual(list(loopiter), [])
+
+        # Offset and limit are pushed down to objects that support slicing.
+        class Query:
+            def __init__(self):
+                self.sliced = None
+
+            def __iter__(self):
+                return iter(range(100))
+
+            def __getitem__(self, key):
+                self.sliced = key
+                return list(range(100))[key]
+
+        query = Query()
+        loopiter, length = expr.evaluate(Context(env, {"a": query}))
+        self.assertEqual(query.sliced, slice(1, 3))
+        self.assertEqual(length, 2)
+        self.assertEqual(list(loopiter), [1, 2])
+
+        template = env.from_string(
+            "{% for i in a %}{{ i }}{% if forloop.last %}/{{ forloop.length }}"
+            "{% else %},{% endif %}{% endfor %}"
+            "{% for i in b %}{{ i }}{% else %}empty{% endfor %}"
+        )
+        self.assertEqual(template.render(a=gen(3), b=gen(0)), "0,1,2/3empty")
+
+    def test_continue_lazy_loop(self):
+        """Test that loops over iterables of unknown length record the number of
+        items they consumed as the stop index for `offset: continue`."""
+        env = Environment()
+
+        class Items:
+            def __iter__(self):
+                return iter(range(5))
+
+        template = env.from_string(
+            "{% for i in a %}{{ i }}{% endfor %}"
+            "|{% for i in a offset: continue %}{{ i }}{% endfor %}"
+        )
+        self.assertEqual(template.render(a=Items()), "01234|")
+
+        template = env.from_string(
+            "{% for i in a limit: 2 %}{{ i }}{% endfor %}"
+            "|{% for i in a offset: continue %}{{ i }}{% endfor %}"
+        )
+        self.assertEqual(template.render(a=Items()), "01|234")
+
+        template = env.from_string(
+            "{% for i in a limit: 9 %}{{ i }}{% endfor %}"
+            "|{% for i in a offset: continue %}{{ i }}{% endfor %}"
+        )
+        self.assertEqual(template.render(a=Items()), "01234|")
+
+        # Loops exited early record the number of items consumed so far.
+        template = env.from_string(
+            "{% for i in a %}{{ i }}{% if i == 2 %}{% break %}{% endif %}{% endfor %}"
+            "|{% for i in a offset: continue %}{{ i }}{% endfor %}"
+        )
+        self.assertEqual(template.render(a=Items()), "012|34")
@@ -0,0 +1,141 @@
+"""Filter memoization test cases."""
+
+import unittest
+
+from typing import List
+
+from liquid import Environment
+from liquid.compiler import CompiledBoundTemplate
+from liquid.filter import memoize
+from liquid.filter import with_context
+from liquid.loaders import DictLoader
+from liquid.template import BoundTemplate
+
+
+class FilterMemoTestCase(unittest.TestCase):
+    """Test cases for reusing results from filters marked with `memoize`."""
+
+    template_class = BoundTemplate
+
+    def setUp(self) -> None:
+        self.calls: List[object] = []
+
+        @memoize
+        def expensive(val: object, *args: object, **kwargs: object) -> object:
+            self.calls.append((val, args, kwargs))
+            return [val, *args, *kwargs.values()]
+
+        self.env = Environment(
+            loader=DictLoader({"part": "{{ x | expensive: 1 | size }}"})
+        )
+        self.env.template_class = self.template_class
+        self.env.add_filter("expensive", expensive)
+
+        self.products = [{"title": "b", "price": 2}, {"title": "a", "price": 1}]
+
+    def test_same_input_and_arguments(self):
+        """Test that a memoized filter is called once for the same input object and
+        arguments."""
+        template = self.env.from_string(
+            "{% for i in (1..3) %}"
+            "{% assign y = x | expensive: 1, z: 'a' %}{{ y | join: ',' }};"
+            "{% endfor %}"
+        )
+        self.assertEqual(template.render(x="x"), "x,1,a;x,1,a;x,1,a;")
+        self.assertEqual(len(self.calls), 1)
+
+    def test_different_arguments(self):
+        """Test that results are not reused for different arguments."""
+        template = self.env.from_string(
+            "{{ x | expensive: 1 | size }}{{ x | expensive: 1.0 | size }}"
+            "{{ x | expensive: true | size }}{{ x | expensive: 1, y: 2 | size }}"
+        )
+        self.assertEqual(template.render(x="x"), "2223")
+        self.assertEqual(len(self.calls), 4)
+
+    def test_different_input(self):
+        """Test that results are not reused for a different input object."""
+        template = self.env.from_string(
+            "{{ a | expensive | first }}{{ b | expensive | first }}"
+        )
+        self.assertEqual(template.render(a=[1], b=[1]), "11")
+        self.assertEqual(len(self.calls), 2)
+
+    def test_memo_per_render(self):
+        """Test that memoized results do not outlive a call to `render`."""
+        template = self.env.from_string("{{ x | expensive | first }}")
+        self.assertEqual(template.render(x="a"), "a")
+        self.assertEqual(template.render(x="a"), "a")
+        self.assertEqual(len(self.calls), 2)
+
+    def test_shared_with_partials(self):
+        """Test that memoized results are shared with partial templates."""
+        template = self.env.from_string(
+            "{% render 'part', x: x %}{% render 'part', x: x %}"
+        )
+        self.assertEqual(template.render(x="a"), "22")
+        self.assertEqual(len(self.calls), 1)
+
+    def test_unhashable_arguments(self):
+        """Test that filters with array arguments are always called."""
+        template = self.env.from_string(
+            "{{ x | expensive: y | size }}{{ x | expensive: y | size }}"
+        )
+        self.assertEqual(template.render(x="a", y=[1]), "22")
+        self.assertEqual(len(self.calls), 2)
+
+    def test_memo_size(self):
+        """Test that the oldest results are discarded when the memo is full."""
+        self.env.filter_memo_size = 1
+        template = self.env.from_string(
+            "{{ x | expensive: 1 | size }}{{ x | expensive: 2 | size }}"
+            "{{ x | expensive: 1 | size }}"
+        )
+        self.assertEqual(template.render(x="a"), "222")
+        self.assertEqual(len(self.calls), 3)
+
+    def test_disabled(self):
+        """Test that we can disable filter memoization."""
+        self.env.filter_memo_size = 0
+        template = self.env.from_string(
+            "{{ x | expensive | size }}{{ x | expensive | size }}"
+        )
+        self.assertEqual(template.render(x="a"), "11")
+        self.assertEqual(len(self.calls), 2)
+
+    def test_with_context(self):
+        """Test that filters that need the render context are not memoized."""
+
+        @memoize
+        @with_context
+        def contextual(val: object, *, context: object) -> object:
+            self.calls.append(val)
+            return val
+
+        self.env.add_filter("contextual", contextual)
+        template = self.env.from_string("{{ x | contextual }}{{ x | contextual }}")
+        self.assertEqual(template.render(x="a"), "aa")
+        self.assertEqual(len(self.calls), 2)
+
+    def test_builtin_array_filters(self):
+        """Test that built-in array filters are memoized and chain on memoized
+        results."""
+        template = self.env.from_string(
+            "{% for i in (1..2) %}"
+            "{{ products | sort: 'price' | map: 'title' | join }}"
+            "{{ products | where: 'price', 2 | map: 'title' | join }}"
+            "{{ products | sort_natural: 'title' | map: 'title' | join }};"
+            "{% endfor %}"
+        )
+        context = {"products": self.products}
+        self.assertEqual(template.render(**context), "a bba b;a bba b;")
+
+        self.assertTrue(self.env.get_filter("sort").memoize)
+        self.assertTrue(self.env.get_filter("map").memoize)
+        self.assertFalse(self.env.get_filter("upcase").memoize)
+
+
+class CompiledFilterMemoTestCase(FilterMemoTestCase):
+    """Test cases for reusing results from memoized filters in compiled templates."""
+
+    template_class = CompiledBoundTemplate
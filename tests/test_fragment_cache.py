@@ -0,0 +1,108 @@
+"""Fragment cache test cases."""
+
+import asyncio
+import pickle
+import time
+import unittest
+
+from typing import Dict
+from typing import Optional
+
+from liquid import Environment
+from liquid.fragment_cache import FragmentCache
+from liquid.fragment_cache import LRUFragmentCache
+
+
+class DictFragmentCache(FragmentCache):
+    """A fragment cache that records the TTL of each fragment."""
+
+    def __init__(self) -> None:
+        self.data: Dict[str, str] = {}
+        self.ttls: Dict[str, Optional[float]] = {}
+        self.async_calls = 0
+
+    def get(self, key: str) -> Optional[str]:
+        return self.data.get(key)
+
+    def set(self, key: str, value: str, ttl: Optional[float] = None) -> None:
+        self.data[key] = value
+        self.ttls[key] = ttl
+
+    async def get_async(self, key: str) -> Optional[str]:
+        self.async_calls += 1
+        return self.get(key)
+
+
+class FragmentCacheTestCase(unittest.TestCase):
+    """Test cases for the `cache` tag and fragment caches."""
+
+    def test_reuse_fragments(self):
+        """Test that cached fragments are shared between renders and templates."""
+        env = Environment()
+        source = "{% cache 'nav', menu.version %}{% increment n %}{% endcache %}"
+        template = env.from_string(source)
+
+        self.assertEqual(template.render(menu={"version": 1}), "0")
+        self.assertEqual(template.render(menu={"version": 1}), "0")
+        self.assertEqual(env.from_string(source).render(menu={"version": 1}), "0")
+
+        # A new key renders the block again.
+        self.assertEqual(template.render(menu={"version": 2}), "0")
+        self.assertEqual(len(env.fragment_cache.cache), 2)
+
+    def test_changed_block(self):
+        """Test that changing a block's contents does not reuse its old fragment."""
+        env = Environment()
+        template = env.from_string("{% cache 'a' %}x{% endcache %}")
+        self.assertEqual(template.render(), "x")
+
+        template = env.from_string("{% cache 'a' %}y{% endcache %}")
+        self.assertEqual(template.render(), "y")
+
+    def test_ttl(self):
+        """Test that fragments expire."""
+        cache = LRUFragmentCache()
+        cache.set("a", "hello", ttl=60)
+        cache.set("b", "goodbye", ttl=0)
+
+        self.assertEqual(cache.get("a"), "hello")
+        self.assertIsNone(cache.get("b"))
+
+        cache.set("a", "hello", ttl=-1)
+        time.sleep(0.01)
+        self.assertIsNone(cache.get("a"))
+
+    def test_max_size(self):
+        """Test that we can limit the total size of cached fragments."""
+        cache = LRUFragmentCache(capacity=10, max_size=10)
+        cache.set("a", "x" * 6)
+        cache.set("b", "x" * 6)
+
+        self.assertIsNone(cache.get("a"))
+        self.assertEqual(cache.get("b"), "x" * 6)
+        self.assertEqual(cache.cache_info().evictions, 1)
+
+    def test_custom_backend(self):
+        """Test that we can use a custom fragment cache."""
+        cache = DictFragmentCache()
+        env = Environment(fragment_cache=cache)
+        template = env.from_string(
+            "{% cache 'a', ttl: 30 %}{{ x }}{% endcache %}"
+            "{% cache 'b' %}{{ x }}{% endcache %}"
+        )
+
+        self.assertEqual(template.render(x=1), "11")
+        self.assertEqual(template.render(x=2), "11")
+        self.assertEqual(sorted(cache.ttls.values(), key=str), [30, None])
+
+        self.assertEqual(asyncio.run(template.render_async(x=3)), "11")
+        self.assertEqual(cache.async_calls, 2)
+
+    def test_pickle(self):
+        """Test that cached fragments are not pickled with an environment."""
+        env = Environment()
+        env.from_string("{% cache 'a' %}x{% endcache %}").render()
+        self.assertEqual(len(env.fragment_cache.cache), 1)
+
+        other = pickle.loads(pickle.dumps(env))
+        self.assertEqual(len(other.fragment_cache.cache), 0)
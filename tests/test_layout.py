@@ -0,0 +1,199 @@
+"""Layout content test cases."""
+
+import asyncio
+import unittest
+
+from liquid import Environment
+from liquid import StrictUndefined
+
+from liquid.compiler import CompiledBoundTemplate
+from liquid.exceptions import UndefinedError
+from liquid.layout import LayoutContent
+from liquid.loaders import DictLoader
+from liquid.output import SegmentBuffer
+from liquid.template import BoundTemplate
+
+
+class LayoutTestCase(unittest.TestCase):
+    """Test cases for rendering templates into a layout."""
+
+    template_class = BoundTemplate
+
+    def setUp(self) -> None:
+        self.env = Environment(
+            loader=DictLoader(
+                {
+                    "theme": (
+                        "<title>{{ title }}</title>"
+                        "{{ content_for_layout }}"
+                        "<footer>{{ footer }}</footer>"
+                    ),
+                    "page": (
+                        "{% assign footer = 'bye' %}"
+                        "<h1>{{ title }}</h1>"
+                        "{% for item in items %}<p>{{ item }}</p>{% endfor %}"
+                    ),
+                }
+            )
+        )
+        self.env.template_class = self.template_class
+        self.theme = self.env.get_template("theme")
+        self.page = self.env.get_template("page")
+        self.expect = (
+            "<title>Hi</title><h1>Hi</h1><p>a</p><p>b</p><footer>bye</footer>"
+        )
+
+    def _context(self, **kwargs):
+        return {
+            "title": "Hi",
+            "content_for_layout": LayoutContent(self.page, items=["a", "b"]),
+            **kwargs,
+        }
+
+    def _stream(self, template, **kwargs):
+        return list(template.render_stream(**kwargs))
+
+    def _stream_async(self, template, **kwargs):
+        async def coro():
+            return [chunk async for chunk in template.render_stream_async(**kwargs)]
+
+        return asyncio.run(coro())
+
+    def test_render(self):
+        """Test that layout content is rendered with the layout's context."""
+        self.assertEqual(self.theme.render(**self._context()), self.expect)
+
+    def test_render_async(self):
+        """Test that layout content is rendered with the layout's context when
+        rendering asynchronously."""
+        result = asyncio.run(self.theme.render_async(**self._context()))
+        self.assertEqual(result, self.expect)
+
+    def test_render_bytes(self):
+        """Test that layout content is rendered to a byte buffer."""
+        result = self.theme.render_bytes(**self._context())
+        self.assertEqual(result, self.expect.encode())
+
+    def test_stream(self):
+        """Test that layout output is flushed before rendering its content, and that
+        the content template is streamed too."""
+        for stream in (self._stream, self._stream_async):
+            with self.subTest(stream=stream.__name__):
+                chunks = stream(self.theme, **self._context())
+                self.assertEqual("".join(chunks), self.expect)
+                self.assertEqual(chunks[0], "<title>Hi</title>")
+
+        self.page.stream_buffer_size = 1
+        self.theme.stream_buffer_size = 1
+
+        for stream in (self._stream, self._stream_async):
+            with self.subTest(stream=stream.__name__, stream_buffer_size=1):
+                chunks = stream(self.theme, **self._context())
+                self.assertEqual(
+                    chunks,
+                    [
+                        "<title>",
+                        "Hi",
+                        "</title>",
+                        "<h1>",
+                        "Hi",
+                        "</h1>",
+                        "<p>a</p><p>b</p>",
+                        "<footer>",
+                        "bye",
+                        "</footer>",
+                    ],
+                )
+
+    def test_nested_layouts(self):
+        """Test that layout content can itself be a layout."""
+        outer = self.env.from_string("<html>{{ content_for_layout }}</html>")
+        content = LayoutContent(self.theme, **self._context())
+        expect = f"<html>{self.expect}</html>"
+
+        self.assertEqual(outer.render(content_for_layout=content), expect)
+        for stream in (self._stream, self._stream_async):
+            with self.subTest(stream=stream.__name__):
+                chunks = stream(outer, content_for_layout=content)
+                self.assertEqual("".join(chunks), expect)
+                self.assertEqual(chunks[:2], ["<html>", "<title>Hi</title>"])
+
+    def test_nested_content_for_layout(self):
+        """Test that layout content is rendered inline from a nested block."""
+        theme = self.env.from_string(
+            "<title>{{ title }}</title>"
+            "{% if true %}{{ content_for_layout }}{% endif %}"
+            "<footer>{{ footer }}</footer>"
+        )
+        self.assertEqual(theme.render(**self._context()), self.expect)
+        for stream in (self._stream, self._stream_async):
+            with self.subTest(stream=stream.__name__):
+                chunks = stream(theme, **self._context())
+                self.assertEqual(chunks, [self.expect])
+
+    def test_filtered_content(self):
+        """Test that layout content with filters is rendered to a string first."""
+        theme = self.env.from_string("{{ content_for_layout | upcase }}")
+        result = theme.render(**self._context())
+        self.assertEqual(result, "<H1></H1><P>A</P><P>B</P>")
+
+    def test_not_layout_content(self):
+        """Test that other values of `content_for_layout` are output as normal."""
+        self.assertEqual(
+            self.theme.render(title="Hi", content_for_layout="<p>hello</p>"),
+            "<title>Hi</title><p>hello</p><footer></footer>",
+        )
+        self.assertEqual(
+            self._stream(self.theme, title="Hi"),
+            ["<title>Hi</title><footer></footer>"],
+        )
+
+    def test_strict_undefined(self):
+        """Test that an undefined `content_for_layout` is still strict."""
+        env = Environment(undefined=StrictUndefined)
+        env.template_class = self.template_class
+        template = env.from_string("{{ content_for_layout }}")
+
+        with self.assertRaises(UndefinedError):
+            template.render()
+        with self.assertRaises(UndefinedError):
+            self._stream(template)
+
+    def test_prefetch(self):
+        """Test that layout content renders with async lookup prefetching."""
+        env = Environment(loader=self.env.loader, prefetch_async=2)
+        env.template_class = self.template_class
+        theme = env.get_template("theme")
+        page = env.get_template("page")
+        context = {**self._context(), "content_for_layout": LayoutContent(page)}
+        expect = "<title>Hi</title><h1>Hi</h1><footer>bye</footer>"
+
+        self.assertEqual(asyncio.run(theme.render_async(**context)), expect)
+        self.assertEqual("".join(self._stream_async(theme, **context)), expect)
+
+    def test_capture_segment_buffer(self):
+        """Test that captured text is collected without copying."""
+        buf = SegmentBuffer()
+        self.assertEqual(buf.getvalue(), "")
+
+        text = "a" * 100
+        buf.write(text)
+        self.assertIs(buf.getvalue(), text)
+
+        buf.write("b")
+        self.assertEqual(buf.getvalue(), text + "b")
+
+        template = self.env.from_string(
+            "{% capture x %}a{{ y }}b{% endcapture %}{{ x }}{{ x | size }}"
+        )
+        self.assertEqual(template.render(y="-"), "a-b3")
+
+
+class CompiledLayoutTestCase(LayoutTestCase):
+    """Test cases for rendering compiled templates into a layout."""
+
+    template_class = CompiledBoundTemplate
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -263,10 +263,33 @@ class LiquidLexerTestCase(TestCase):
                     Token(1, TOKEN_TAG, "endcapture"),
                 ],
             ),
+            Case(
+                "template literal with braces",
+                "a { b }} c %}{ {{ x }}\n",
+                [
+                    Token(1, TOKEN_LITERAL, "a { b }} c %}{ "),
+                    Token(1, TOKEN_STATEMENT, "x"),
+                    Token(1, TOKEN_LITERAL, "\n"),
+                ],
+            ),
         ]
 
         self._test(test_cases)
 
+    def test_lex_custom_delimiters(self):
+        """Test that the lexer can tokenize templates with custom delimiters."""
+        tokenize = get_lexer("[%", "%]", "[[", "]]")
+        self.assertEqual(
+            list(tokenize("a [ b {{ c }} [[- x ]]\n[%- if y %] {% z %}")),
+            [
+                Token(1, TOKEN_LITERAL, "a [ b {{ c }}"),
+                Token(1, TOKEN_STATEMENT, "x"),
+                Token(2, TOKEN_TAG, "if"),
+                Token(2, TOKEN_EXPRESSION, "y"),
+                Token(2, TOKEN_LITERAL, " {% z %}"),
+            ],
+        )
+
     def test_lex_liquid_expression(self):
         """Test that the liquid expression lexer can tokenize line delimited expressions."""
 
@@ -12,6 +12,7 @@ from liquid.template import AwareBoundTemplate
 
 from liquid.loaders import FileSystemLoader, DictLoader
 from liquid.exceptions import TemplateNotFound
+from liquid.watcher import TemplateWatcher
 
 
 class FileSystemLoaderTestCase(unittest.TestCase):
@@ -181,6 +182,83 @@ class FileSystemLoaderTestCase(unittest.TestCase):
         with self.assertRaises(TemplateNotFound):
             _ = env.get_template(name="../dropify/index.liquid")
 
+    def test_reload_interval(self):
+        """Test that we can limit how often cached templates are checked."""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            template_path = Path(tmpdir) / "somefile.txt"
+            template_path.write_text("hello there\n")
+
+            env = Environment(
+                loader=FileSystemLoader(search_path=tmpdir),
+                auto_reload=True,
+                reload_interval=60,
+            )
+
+            template = env.get_template(name=str(template_path))
+
+            time.sleep(0.01)  # Make sure some time has passed.
+            template_path.write_text("goodbye there\n")
+            self.assertFalse(template.is_up_to_date)
+
+            # Not checked again until the interval has passed.
+            same_template = env.get_template(name=str(template_path))
+            self.assertIs(same_template, template)
+
+            template.checked_at -= 60
+            updated_template = env.get_template(name=str(template_path))
+            self.assertIsNot(updated_template, template)
+            self.assertEqual(updated_template.render(), "goodbye there\n")
+
+    def test_template_watcher(self):
+        """Test that a template watcher removes changed templates from the cache."""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            template_path = Path(tmpdir) / "somefile.txt"
+            template_path.write_text("hello there\n")
+
+            env = Environment(
+                loader=FileSystemLoader(search_path=tmpdir),
+                auto_reload=False,
+            )
+
+            template = env.get_template(name=str(template_path))
+            watcher = TemplateWatcher(env)
+            self.assertEqual(watcher.check(), 0)
+
+            time.sleep(0.01)  # Make sure some time has passed.
+            template_path.write_text("goodbye there\n")
+            self.assertIs(env.get_template(name=str(template_path)), template)
+
+            self.assertEqual(watcher.check(), 1)
+            self.assertEqual(len(env.cache), 0)
+
+            updated_template = env.get_template(name=str(template_path))
+            self.assertEqual(updated_template.render(), "goodbye there\n")
+
+    def test_template_watcher_thread(self):
+        """Test that a template watcher checks templates in a background thread."""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            template_path = Path(tmpdir) / "somefile.txt"
+            template_path.write_text("hello there\n")
+
+            env = Environment(
+                loader=FileSystemLoader(search_path=tmpdir),
+                auto_reload=False,
+            )
+            env.get_template(name=str(template_path))
+
+            with TemplateWatcher(env, interval=0.01) as watcher:
+                self.assertTrue(watcher.running)
+                time.sleep(0.01)  # Make sure some time has passed.
+                template_path.write_text("goodbye there\n")
+
+                for _ in range(100):
+                    if not env.cache:
+                        break
+                    time.sleep(0.01)
+
+            self.assertFalse(watcher.running)
+            self.assertEqual(len(env.cache), 0)
+
 
 class TemplateDropTestCase(unittest.TestCase):
     def setUp(self):
@@ -246,6 +246,18 @@ class MalformedTemplateTestCase(TestCase):
                 expect_exception=LiquidSyntaxError,
                 expect_msg="unexpected '~', on line 1",
             ),
+            Case(
+                description="missing cache key",
+                template="{% cache %}ok{% endcache %}",
+                expect_exception=LiquidSyntaxError,
+                expect_msg="expected 'expression', found 'literal', on line 1",
+            ),
+            Case(
+                description="cache ttl is not a number",
+                template="{% cache 'a', ttl: 'b' %}ok{% endcache %}",
+                expect_exception=LiquidTypeError,
+                expect_msg="expected a number of seconds for cache ttl, found 'b', on line 1",
+            ),
         ]
 
         self._test(test_cases, mode=Mode.STRICT)
@@ -0,0 +1,198 @@
+"""Parse tree optimization test cases."""
+
+import asyncio
+import unittest
+
+try:
+    import markupsafe
+except ImportError:
+    markupsafe = None
+
+from liquid import Environment
+
+from liquid.ast import BlockNode
+from liquid.builtin.literal import LiteralNode
+from liquid.builtin.statement import StatementNode
+from liquid.builtin.tags.case_tag import CaseNode
+from liquid.builtin.tags.if_tag import IfNode
+
+from liquid.exceptions import FilterArgumentError
+from liquid.expression import Literal
+from liquid.filter import pure
+from liquid.filter import with_context
+from liquid.loaders import DictLoader
+from liquid.template import AwareBoundTemplate
+from liquid.tree_cache import DictTreeCache
+
+from tests import test_render
+
+
+class OptimizedRenderTestCases(test_render.RenderTestCases):
+    """Run all render test cases with optimized parse trees."""
+
+    def _test_sync(self, test_cases, template_class=AwareBoundTemplate):
+        for case in test_cases:
+            env = Environment(loader=DictLoader(case.partials), optimize=True)
+            env.template_class = template_class
+
+            template = env.from_string(case.template, globals=case.globals)
+
+            with self.subTest(msg=case.description):
+                self.assertEqual(template.render(), case.expect)
+
+    def _test_async(self, test_cases, template_class=AwareBoundTemplate):
+        for case in test_cases:
+            env = Environment(loader=DictLoader(case.partials), optimize=True)
+            env.template_class = template_class
+
+            template = env.from_string(case.template, globals=case.globals)
+
+            with self.subTest(msg=case.description, asynchronous=True):
+                self.assertEqual(asyncio.run(template.render_async()), case.expect)
+
+
+class OptimizeTestCase(unittest.TestCase):
+    """Parse tree optimization test cases."""
+
+    def setUp(self) -> None:
+        self.env = Environment(optimize=True)
+
+    def test_merge_literals(self):
+        """Test that we merge adjacent template literals."""
+        template = self.env.from_string("Hello, {%- comment %}x{% endcomment %} World!")
+        statements = template.tree.statements
+
+        self.assertEqual(len(statements), 1)
+        self.assertIsInstance(statements[0], LiteralNode)
+        self.assertEqual(statements[0].tok.value, "Hello, World!")
+
+    def test_fold_pure_filters(self):
+        """Test that we evaluate pure filters on literals in advance."""
+        template = self.env.from_string("a{{ 'b,c' | split: ',' | join: '-' }}d")
+        statements = template.tree.statements
+
+        self.assertEqual(len(statements), 1)
+        self.assertEqual(statements[0].tok.value, "ab-cd")
+
+    def test_fold_filter_prefix(self):
+        """Test that we evaluate the longest chain of pure filters."""
+        self.env.add_filter("shout", lambda val: val + "!")
+        template = self.env.from_string("{{ 'hello' | upcase | shout | size }}")
+        (stmt,) = template.tree.statements
+
+        self.assertIsInstance(stmt, StatementNode)
+        self.assertIsInstance(stmt.expression.expression, Literal)
+        self.assertEqual(stmt.expression.expression.value, "HELLO")
+        self.assertEqual([f.name for f in stmt.expression.filters], ["shout", "size"])
+        self.assertEqual(template.render(), "6")
+
+    def test_dont_fold_impure_filters(self):
+        """Test that we don't evaluate filters that are not marked as pure, filters
+        that need a render context, or filters with variable arguments."""
+        calls = []
+
+        def tally(val):
+            calls.append(val)
+            return val
+
+        @pure
+        @with_context
+        def ctx(val, *, context):
+            return context.resolve("x")
+
+        self.env.add_filter("tally", tally)
+        self.env.add_filter("ctx", ctx)
+
+        template = self.env.from_string(
+            "{{ 'a' | tally }}{{ 'b' | ctx }}{{ 'c' | append: x }}"
+        )
+        self.assertEqual(calls, [])
+        self.assertEqual(template.render(x="!"), "a!c!")
+        self.assertEqual(calls, ["a"])
+
+    def test_dont_fold_filter_errors(self):
+        """Test that filter errors are raised at render time."""
+        template = self.env.from_string("{{ 'hello' | upcase: 'nosuchthing' }}")
+        with self.assertRaises(FilterArgumentError):
+            template.render()
+
+    def test_fold_assign(self):
+        """Test that we evaluate pure filters in assign tags."""
+        template = self.env.from_string(
+            "{% assign x = 'hello' | capitalize %}{{ x }}, {{ 'x' | default: x }}"
+        )
+        self.assertEqual(template.render(), "Hello, x")
+
+    @unittest.skipIf(markupsafe is None, "this test requires markupsafe")
+    def test_autoescape(self):
+        """Test that folded literals are escaped when autoescape is enabled."""
+        env = Environment(autoescape=True, optimize=True)
+        template = env.from_string("{{ '<b>' | append: '&' }}{{ '<i>' | escape }}")
+        self.assertEqual(
+            template.render(),
+            Environment(autoescape=True)
+            .from_string("{{ '<b>' | append: '&' }}{{ '<i>' | escape }}")
+            .render(),
+        )
+        self.assertIsInstance(template.tree.statements[0], LiteralNode)
+
+    def test_prune_if(self):
+        """Test that we remove if branches with constant conditions."""
+        template = self.env.from_string(
+            "{% if false %}a{% elsif x %}b{% elsif 1 == 1 %}c{% else %}d{% endif %}"
+        )
+        (node,) = template.tree.statements
+
+        self.assertIsInstance(node, IfNode)
+        self.assertEqual(node.conditional_alternatives, [])
+        self.assertEqual(template.render(), "c")
+        self.assertEqual(template.render(x=True), "b")
+
+        template = self.env.from_string("<{% if true %}a{% else %}b{% endif %}>")
+        self.assertEqual(len(template.tree.statements), 1)
+        self.assertEqual(template.tree.statements[0].tok.value, "<a>")
+
+        template = self.env.from_string("<{% if false %}a{% endif %}>")
+        self.assertEqual(template.tree.statements[0].tok.value, "<>")
+
+    def test_prune_unless(self):
+        """Test that we remove unless tags with constant conditions."""
+        template = self.env.from_string(
+            "{% unless true %}a{% endunless %}{% unless false %}b{% endunless %}"
+        )
+        self.assertEqual(template.tree.statements[0].tok.value, "b")
+
+    def test_prune_case(self):
+        """Test that we remove case branches with constant conditions."""
+        template = self.env.from_string(
+            "{% case 'x' %}{% when 'y' %}a{% when 'x' %}b{% endcase %}"
+        )
+        self.assertEqual(template.tree.statements[0].tok.value, "b")
+
+        template = self.env.from_string(
+            "{% case x %}{% when 'y' %}a{% else %}b{% endcase %}"
+        )
+        self.assertIsInstance(template.tree.statements[0], CaseNode)
+        self.assertEqual(template.render(x="y"), "a")
+
+    def test_whitespace_only_blocks(self):
+        """Test that pruned blocks are still suppressed if they are whitespace."""
+        template = self.env.from_string("<{% if true %}  {% endif %}>")
+        self.assertEqual(template.render(), "<>")
+
+        template = self.env.from_string("<{% if true %} {{ x }} {% endif %}>")
+        self.assertIsInstance(template.tree.statements[1], BlockNode)
+        self.assertEqual(template.render(), "<>")
+        self.assertEqual(template.render(x="a"), "< a >")
+
+    def test_tree_cache_fingerprint(self):
+        """Test that optimized and unoptimized parse trees are cached separately."""
+        tree_cache = DictTreeCache()
+        self.assertNotEqual(
+            tree_cache.key(Environment(), "hello"),
+            tree_cache.key(Environment(optimize=True), "hello"),
+        )
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,96 @@
+"""Byte output test cases."""
+
+import asyncio
+import unittest
+
+from liquid import Environment
+from liquid.compiler import CompiledBoundTemplate
+from liquid.loaders import DictLoader
+from liquid.output import BytesBuffer
+from liquid.template import BoundTemplate
+
+
+class RenderBytesTestCase(unittest.TestCase):
+    """Test cases for rendering templates to bytes."""
+
+    template_class = BoundTemplate
+
+    def setUp(self) -> None:
+        self.env = Environment(
+            loader=DictLoader({"item": "<li>{{ item }}</li>"}),
+        )
+        self.env.template_class = self.template_class
+
+        self.source = (
+            "<ul title='" + "é" * BytesBuffer.literal_threshold + "'>"
+            "{% for item in items %}"
+            "{% render 'item', item: item %}"
+            "{% endfor %}"
+            "</ul>"
+            "{{ items | size }}"
+        )
+        self.items = ["α", "β", "γ"]
+
+    def test_same_as_render(self):
+        """Test that rendered bytes are the same as encoded rendered text."""
+        template = self.env.from_string(self.source)
+        expect = template.render(items=self.items).encode("utf-8")
+
+        self.assertEqual(template.render_bytes(items=self.items), expect)
+        self.assertEqual(b"".join(template.render_buffers(items=self.items)), expect)
+
+    def test_same_as_render_async(self):
+        """Test that bytes rendered asynchronously are the same as encoded rendered
+        text."""
+        template = self.env.from_string(self.source)
+        expect = template.render(items=self.items).encode("utf-8")
+
+        async def coro():
+            return (
+                await template.render_bytes_async(items=self.items),
+                await template.render_buffers_async(items=self.items),
+            )
+
+        data, buffers = asyncio.run(coro())
+        self.assertEqual(data, expect)
+        self.assertEqual(b"".join(buffers), expect)
+
+    def test_long_literals_are_not_copied(self):
+        """Test that long template literals are encoded once and kept as a separate
+        buffer."""
+        template = self.env.from_string("{{ a }}" + "x" * 1000 + "{{ b }}")
+        buffers = template.render_buffers(a=1, b=2)
+        self.assertEqual(buffers, [b"1", b"x" * 1000, b"2"])
+
+        if self.template_class is BoundTemplate:
+            literal = template.tree.statements[1]
+            self.assertIs(template.render_buffers(a=1, b=2)[1], literal.encoded)
+
+    def test_short_literals_are_joined(self):
+        """Test that short template literals are encoded with surrounding text."""
+        template = self.env.from_string("<p>{{ a }}</p>")
+        self.assertEqual(template.render_buffers(a=1), [b"<p>1</p>"])
+
+    def test_empty_template(self):
+        """Test that an empty template renders no buffers."""
+        template = self.env.from_string("")
+        self.assertEqual(template.render_buffers(), [])
+        self.assertEqual(template.render_bytes(), b"")
+
+    def test_output_encoding(self):
+        """Test that we can render bytes with a different encoding."""
+
+        class Latin1Template(self.template_class):  # type: ignore
+            output_encoding = "latin-1"
+
+        self.env.template_class = Latin1Template
+        template = self.env.from_string("é{{ x }}" + "é" * 1000)
+        self.assertEqual(
+            template.render_bytes(x="ü"), "éü".encode("latin-1") + b"\xe9" * 1000
+        )
+
+
+class CompiledRenderBytesTestCase(RenderBytesTestCase):
+    """Test cases for rendering compiled templates to bytes."""
+
+    template_class = CompiledBoundTemplate
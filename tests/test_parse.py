@@ -26,6 +26,8 @@ from liquid.builtin import (
     ifchanged_tag,
 )
 
+from tests.mocks.tags.form_tag import CommentFormTag
+
 
 class Case(NamedTuple):
     description: str
@@ -443,3 +445,47 @@ class ParserTestCase(unittest.TestCase):
         ]
 
         self._test(test_cases, ifchanged_tag.IfChangedNode)
+
+
+class ForLoopUsageTestCase(unittest.TestCase):
+    """Test cases for detecting `forloop` references at parse time."""
+
+    def test_uses_forloop(self):
+        """Test that we only build a `forloop` drop for loops that might need it."""
+        env = Environment()
+        env.add_tag(CommentFormTag)
+
+        test_cases = [
+            ("{% for x in y %}{{ x }}{% endfor %}", False),
+            ("{% for x in y %}{{ forloop.index }}{% endfor %}", True),
+            ("{% for x in y %}{% if forloop.first %}a{% endif %}{% endfor %}", True),
+            ("{% for x in y %}{{ x | append: forloop.last }}{% endfor %}", True),
+            ("{% for x in y %}{{ a[forloop.index] }}{% endfor %}", True),
+            (
+                "{% for x in y %}{% for z in x %}{{ forloop }}{% endfor %}{% endfor %}",
+                False,
+            ),
+            ("{% for x in y %}{% include 'a' %}{% endfor %}", True),
+            ("{% for x in y %}{% render 'a' %}{% endfor %}", False),
+            ("{% for x in y %}{% form x %}{% endform %}{% endfor %}", True),
+        ]
+
+        for source, expect in test_cases:
+            with self.subTest(source=source):
+                node = env.from_string(source).tree.statements[0]
+                self.assertIsInstance(node, for_tag.ForNode)
+                self.assertEqual(node.uses_forloop, expect)
+
+    def test_forloop_properties(self):
+        """Test that `forloop` properties are computed from the current index."""
+        forloop = for_tag.ForLoop("x", iter("abc"), 3)
+        self.assertEqual((forloop.index, forloop.rindex0, forloop.last), (0, 3, False))
+
+        next(forloop)
+        self.assertEqual(forloop["first"], True)
+        next(forloop)
+        next(forloop)
+        self.assertEqual(
+            [forloop[key] for key in ("index", "index0", "rindex", "rindex0", "last")],
+            [3, 2, 1, 0, True],
+        )
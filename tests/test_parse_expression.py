@@ -1,8 +1,11 @@
 """Liquid expression parser test cases."""
 
+import pickle
 import unittest
 from typing import NamedTuple, Any
 
+from liquid import Environment
+
 from liquid.expression import FilteredExpression
 from liquid.expression import BooleanExpression
 from liquid.expression import AssignmentExpression
@@ -898,3 +901,45 @@ class LiquidFilteredExpressionParserTestCase(unittest.TestCase):
         ]
 
         self._test(test_cases, tokenize_loop_expression, parse_loop_expression)
+
+
+class ExpressionCacheTestCase(unittest.TestCase):
+    """Test cases for reusing parsed expressions."""
+
+    def test_shared_expressions(self):
+        """Test that repeated expressions are parsed once and shared."""
+        env = Environment()
+        template = env.from_string(
+            "{{ product.title | upcase }}{{ product.title | upcase }}"
+            "{% assign x = product.title | upcase %}"
+            "{% if x %}a{% endif %}{% for y in x %}{% endfor %}"
+            "{% if x %}b{% endif %}{% for y in x %}{% endfor %}"
+        )
+        stmts = template.tree.statements
+        self.assertIs(stmts[0].expression, stmts[1].expression)
+        self.assertIs(stmts[0].expression, stmts[2].expression.expression)
+        self.assertIs(stmts[3].condition, stmts[5].condition)
+        self.assertIs(stmts[4].expression, stmts[6].expression)
+
+        another = env.from_string("{{ product.title | upcase }}")
+        self.assertIs(another.tree.statements[0].expression, stmts[0].expression)
+        self.assertEqual(
+            template.render(product={"title": "foo"}),
+            "FOOFOOab",
+        )
+
+    def test_disable_expression_cache(self):
+        """Test that we can disable the expression cache."""
+        env = Environment(expression_cache_size=0)
+        template = env.from_string("{{ a | upcase }}{{ a | upcase }}")
+        stmts = template.tree.statements
+        self.assertIsNot(stmts[0].expression, stmts[1].expression)
+        self.assertEqual(stmts[0].expression, stmts[1].expression)
+
+    def test_pickle_environment(self):
+        """Test that an environment with an expression cache can be pickled."""
+        env = Environment()
+        env.from_string("{{ a | upcase }}")
+
+        copy = pickle.loads(pickle.dumps(env))
+        self.assertEqual(copy.from_string("{{ a | upcase }}").render(a="b"), "B")
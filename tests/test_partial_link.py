@@ -0,0 +1,266 @@
+"""Test cases for linking partial templates to `include` and `render` tags."""
+
+import asyncio
+import pickle
+import threading
+import time
+import unittest
+
+from io import StringIO
+from unittest import mock
+
+from typing import Dict
+from typing import List
+
+from liquid import Environment
+from liquid.context import Context
+from liquid.compiler import CompiledBoundTemplate
+from liquid.loaders import DictLoader
+from liquid.loaders import TemplateSource
+from liquid.template import BoundTemplate
+from liquid.utils import LRUCache
+from liquid.watcher import TemplateWatcher
+
+
+class ReloadingLoader(DictLoader):
+    """A dictionary loader that can mark templates as being out of date, and counts
+    calls to `get_source`."""
+
+    def __init__(self, templates: Dict[str, str]):
+        super().__init__(templates)
+        self.stale: List[str] = []
+        self.loaded: List[str] = []
+
+    def get_source(self, env: Environment, template_name: str) -> TemplateSource:
+        source, filename, _ = super().get_source(env, template_name)
+        self.loaded.append(template_name)
+        return TemplateSource(
+            source, filename, lambda: template_name not in self.stale
+        )
+
+
+class PartialLinkTestCase(unittest.TestCase):
+    """Test cases for linking partial templates with string literal names."""
+
+    template_class = BoundTemplate
+
+    def setUp(self) -> None:
+        self.loader = ReloadingLoader(
+            {
+                "part": "{{ x }}",
+                "other": "other",
+                "theme/part.liquid": "theme {{ x }}",
+            }
+        )
+        self.env = self._env(self.loader)
+        self.lookups: List[str] = []
+
+        get_template = self.env.get_template
+        get_template_async = self.env.get_template_async
+
+        def _get_template(name, globals=None):
+            self.lookups.append(name)
+            return get_template(name, globals=globals)
+
+        async def _get_template_async(name, globals=None):
+            self.lookups.append(name)
+            return await get_template_async(name, globals=globals)
+
+        self.env.get_template = _get_template
+        self.env.get_template_async = _get_template_async
+
+    def _env(self, loader: DictLoader, **kwargs: object) -> Environment:
+        env = Environment(loader=loader, **kwargs)
+        env.template_class = self.template_class
+        return env
+
+    def _render(self, template: BoundTemplate, **data: object) -> List[str]:
+        return [
+            template.render(**data),
+            asyncio.run(template.render_async(**data)),
+        ]
+
+    def test_static_names(self):
+        """Test that partial templates with a string literal name are only looked up
+        until they are linked."""
+        for tag in ("include", "render"):
+            with self.subTest(tag=tag):
+                self.lookups.clear()
+                template = self.env.from_string(
+                    f"{{% for x in (1..5) %}}{{% {tag} 'part', x: x %}}{{% endfor %}}"
+                )
+                self.assertEqual(self._render(template), ["12345", "12345"])
+                self.assertLessEqual(len(self.lookups), 2)
+
+    def test_dynamic_names(self):
+        """Test that partial templates with a variable name are always looked up."""
+        template = self.env.from_string(
+            "{% for name in names %}{% include name %}{% endfor %}"
+        )
+        self.assertEqual(
+            self._render(template, names=["part", "other", "part"], x=1),
+            ["1other1", "1other1"],
+        )
+        self.assertEqual(len(self.lookups), 6)
+
+    def test_reload(self):
+        """Test that a linked template is reloaded when it is out of date."""
+        template = self.env.from_string("{% include 'part' %}")
+        self.assertEqual(self._render(template, x=1), ["1", "1"])
+        self.assertEqual(self.loader.loaded, ["part"])
+
+        self.loader.stale.append("part")
+        self.loader.templates["part"] = "new {{ x }}"
+        self.assertEqual(template.render(x=1), "new 1")
+        self.assertEqual(self.loader.loaded, ["part", "part"])
+
+    def test_no_auto_reload(self):
+        """Test that linked templates are not checked if auto reload is disabled."""
+        env = self._env(self.loader, auto_reload=False)
+        template = env.from_string("{% render 'part', x: 1 %}")
+        self.assertEqual(self._render(template), ["1", "1"])
+
+        self.loader.stale.append("part")
+        self.assertEqual(self._render(template), ["1", "1"])
+        self.assertEqual(self.loader.loaded, ["part"])
+
+    def test_template_watcher(self):
+        """Test that a linked template removed from the cache by a template watcher
+        is loaded again."""
+        env = self._env(self.loader, auto_reload=False)
+        template = env.from_string("{% include 'part' %}")
+        partial = env.get_template("part")
+        self.assertEqual(self._render(template, x=1), ["1", "1"])
+
+        self.loader.stale.append("part")
+        self.loader.templates["part"] = "new {{ x }}"
+        self.assertEqual(TemplateWatcher(env).check(), 1)
+        self.assertEqual(self._render(template, x=1), ["new 1", "new 1"])
+        self.assertIsNot(env.get_template("part"), partial)
+
+    def test_cache_version(self):
+        """Test that links are made again after a template is added to the cache."""
+        template = self.env.from_string("{% include 'part' %}")
+        template.render(x=1)
+        self.lookups.clear()
+
+        template.render(x=1)
+        self.assertEqual(self.lookups, [])
+
+        self.env.get_template("other")
+        self.lookups.clear()
+        template.render(x=1)
+        self.assertEqual(self.lookups, ["part"])
+
+    def test_concurrent_cache_version(self):
+        """Test that the cache version is bumped once for every change, from any
+        thread."""
+
+        def bump():
+            for _ in range(1000):
+                self.env.bump_cache_version()
+
+        version = self.env.cache_version
+        threads = [threading.Thread(target=bump) for _ in range(8)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        self.assertEqual(self.env.cache_version, version + 8000)
+
+    def test_template_watcher_cache_stats(self):
+        """Test that a template watcher doesn't count templates it checks as cache
+        hits, or move them up."""
+        env = self._env(self.loader, auto_reload=False)
+        env.get_template("part")
+        env.get_template("other")
+        info = env.cache.cache_info()
+
+        self.loader.stale.append("part")
+        self.assertEqual(TemplateWatcher(env).check(), 1)
+        self.assertEqual(env.cache.cache_info().hits, info.hits)
+        self.assertEqual(env.cache.keys(), ["other"])
+
+    def test_ttl(self):
+        """Test that a link expires with its template's cache entry."""
+        env = self._env(self.loader, cache=LRUCache(300, ttl=60), auto_reload=False)
+        template = env.from_string("{% include 'part' %}|{% render 'part', x: 2 %}")
+        self.assertEqual(self._render(template, x=1), ["1|2", "1|2"])
+
+        self.loader.templates["part"] = "new {{ x }}"
+        self.assertEqual(self._render(template, x=1), ["1|2", "1|2"])
+
+        later = time.monotonic() + 61
+        with mock.patch("time.monotonic", return_value=later):
+            self.assertEqual(self._render(template, x=1), ["new 1|new 2"] * 2)
+
+    def test_context_get_template(self):
+        """Test that links are not followed for contexts that load templates
+        differently."""
+        loads: List[str] = []
+
+        class MyContext(Context):
+            """A render context that records template loads."""
+
+            def get_template(self, name):
+                loads.append(name)
+                return super().get_template(name)
+
+            async def get_template_async(self, name):
+                loads.append(name)
+                return await super().get_template_async(name)
+
+        template = self.env.from_string(
+            "{% for x in (1..3) %}{% include 'part' %}{% render 'part', x: x %}"
+            "{% endfor %}"
+        )
+        template.render()
+
+        buf = StringIO()
+        template.render_with_context(MyContext(self.env), buf)
+        asyncio.run(template.render_with_context_async(MyContext(self.env), buf))
+        self.assertEqual(buf.getvalue(), "112233" * 2)
+        self.assertEqual(len(loads), 12)
+
+    def test_render_folder(self):
+        """Test that links from the render tag depend on `render_folder`."""
+        template = self.env.from_string("{% render 'part', x: 1 %}")
+        self.assertEqual(template.render(), "1")
+        self.assertEqual(template.render(render_folder="theme"), "theme 1")
+        self.assertEqual(template.render(), "1")
+        self.assertEqual(template.render(render_folder="theme"), "theme 1")
+
+    def test_shared_parse_tree(self):
+        """Test that links are only followed for the environment they were made
+        with."""
+        template = self.env.from_string("{% include 'part' %}")
+        self.assertEqual(template.render(x=1), "1")
+
+        env = self._env(DictLoader({"part": "another {{ x }}"}))
+        other = env.template_class(env, template.tree)
+        self.assertEqual(other.render(x=1), "another 1")
+        self.assertEqual(template.render(x=1), "1")
+
+    def test_pickle_and_size(self):
+        """Test that links are not pickled, and that linked templates are not
+        counted in a template's size."""
+        template = self.env.from_string("{% render 'part', x: 1 %}")
+        size = template.estimate_size()
+        self.assertEqual(template.render(), "1")
+
+        partial = self.env.get_template("part")
+        self.assertLess(template.estimate_size(), size + partial.estimate_size())
+
+        node = pickle.loads(pickle.dumps(template.tree.statements[0]))
+        self.assertIsNone(node._link)  # pylint: disable=protected-access
+        self.assertIsNotNone(template.tree.statements[0]._link)
+
+
+class CompiledPartialLinkTestCase(PartialLinkTestCase):
+    """Test cases for linking partial templates from compiled templates."""
+
+    template_class = CompiledBoundTemplate
+
+
+if __name__ == "__main__":
+    unittest.main()
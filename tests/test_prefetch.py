@@ -0,0 +1,172 @@
+"""Async lookup prefetching test cases."""
+
+import asyncio
+import unittest
+
+from typing import Dict
+from typing import List
+
+from liquid import Environment
+from liquid.compiler import CompiledBoundTemplate
+from liquid.loaders import DictLoader
+from liquid.template import BoundTemplate
+
+
+class Service:
+    """Counts calls to a mock remote service with a fixed latency."""
+
+    def __init__(self) -> None:
+        self.in_flight = 0
+        self.max_in_flight = 0
+        self.calls: List[str] = []
+
+
+class MockAsyncDrop:
+    """A drop that looks up its items with a mock remote service."""
+
+    def __init__(self, service: Service, name: str, data: Dict[str, object]):
+        self.service = service
+        self.name = name
+        self.data = data
+
+    def __getitem__(self, key):
+        return self.data[key]
+
+    async def __getitem_async__(self, key):
+        self.service.calls.append(f"{self.name}.{key}")
+        self.service.in_flight += 1
+        self.service.max_in_flight = max(
+            self.service.max_in_flight, self.service.in_flight
+        )
+        try:
+            await asyncio.sleep(0.01)
+        finally:
+            self.service.in_flight -= 1
+        return self.data[key]
+
+
+class MockSyncDrop:
+    """A drop without async lookups that counts calls to `__getitem__`."""
+
+    def __init__(self, data: Dict[str, object]):
+        self.data = data
+        self.calls: List[str] = []
+
+    def __getitem__(self, key):
+        self.calls.append(key)
+        return self.data[key]
+
+
+class PrefetchTestCase(unittest.TestCase):
+    """Test cases for starting async lookups ahead of the render cursor."""
+
+    template_class = BoundTemplate
+
+    def setUp(self) -> None:
+        self.service = Service()
+        self.drops = {
+            name: MockAsyncDrop(self.service, name, {"x": name.upper()})
+            for name in "abcde"
+        }
+        self.env = Environment(
+            loader=DictLoader({"item": "({{ item }})"}),
+            prefetch_async=10,
+        )
+        self.env.template_class = self.template_class
+
+    def render(self, env: Environment, source: str, **data: object) -> str:
+        template = env.from_string(source)
+        return asyncio.run(template.render_async(**self.drops, **data))
+
+    def test_disabled_by_default(self):
+        """Test that lookups are awaited one at a time by default."""
+        env = Environment()
+        env.template_class = self.template_class
+        result = self.render(env, "{{ a.x }}{{ b.x }}{{ c.x }}")
+        self.assertEqual(result, "ABC")
+        self.assertEqual(self.service.max_in_flight, 1)
+
+    def test_concurrent_lookups(self):
+        """Test that lookups for upcoming statements are awaited concurrently, and
+        output is written in order."""
+        result = self.render(self.env, "{{ a.x }}-{{ b.x }}-{{ c.x }}")
+        self.assertEqual(result, "A-B-C")
+        self.assertEqual(self.service.max_in_flight, 3)
+        self.assertEqual(sorted(self.service.calls), ["a.x", "b.x", "c.x"])
+
+    def test_lookahead(self):
+        """Test that we only start lookups for the next few statements."""
+        env = Environment(prefetch_async=1)
+        env.template_class = self.template_class
+        result = self.render(env, "{{ a.x }}{{ b.x }}{{ c.x }}{{ d.x }}")
+        self.assertEqual(result, "ABCD")
+        self.assertEqual(self.service.max_in_flight, 2)
+
+    def test_concurrency_limit(self):
+        """Test that the number of lookups awaited at the same time is capped."""
+        env = Environment(prefetch_async=10, prefetch_limit=2)
+        env.template_class = self.template_class
+        result = self.render(env, "{{ a.x }}{{ b.x }}{{ c.x }}{{ d.x }}{{ e.x }}")
+        self.assertEqual(result, "ABCDE")
+        self.assertEqual(self.service.max_in_flight, 2)
+
+    def test_nested_blocks_and_render_arguments(self):
+        """Test that we start lookups for expressions in blocks and render tag
+        arguments."""
+        result = self.render(
+            self.env,
+            "{% if a.x %}{% render 'item', item: b.x %}{% endif %}"
+            "{% for i in (1..2) %}{{ c.x }}{% endfor %}",
+        )
+        self.assertEqual(result, "(B)CC")
+        self.assertEqual(self.service.max_in_flight, 3)
+        self.assertEqual(sorted(self.service.calls), ["a.x", "b.x", "c.x"])
+
+    def test_reassigned_variable(self):
+        """Test that a variable assigned after its lookup was started is looked up
+        again."""
+        result = self.render(self.env, "{% assign a = b %}{{ a.x }}")
+        self.assertEqual(result, "B")
+
+    def test_failed_lookup(self):
+        """Test that errors from prefetched lookups are handled when the variable is
+        evaluated."""
+        result = self.render(self.env, "{{ a.x }}{{ b.nosuchthing }}{{ c.x }}")
+        self.assertEqual(result, "AC")
+
+    def test_sync_intermediates(self):
+        """Test that only mappings are followed on the way to an async drop, so sync
+        drops are not called ahead of time."""
+        sync_drop = MockSyncDrop({"async": self.drops["a"]})
+        result = self.render(
+            self.env,
+            "{{ b.x }}{{ sync.async.x }}{{ hash.async.x }}",
+            sync=sync_drop,
+            hash={"async": self.drops["c"]},
+        )
+        self.assertEqual(result, "BAC")
+        self.assertEqual(sync_drop.calls, ["async"])
+        self.assertEqual(sorted(self.service.calls), ["a.x", "b.x", "c.x"])
+        self.assertEqual(self.service.max_in_flight, 2)
+
+    def test_sync_drop_after_async_drop(self):
+        """Test that a sync drop returned by an async drop is not called ahead of
+        time."""
+        sync_drop = MockSyncDrop({"y": "Y"})
+        drop = MockAsyncDrop(self.service, "f", {"sync": sync_drop})
+        result = self.render(self.env, "{{ a.x }}{{ f.sync.y }}", f=drop)
+        self.assertEqual(result, "AY")
+        self.assertEqual(sync_drop.calls, ["y"])
+
+    def test_render_sync(self):
+        """Test that synchronous rendering is not affected."""
+        template = self.env.from_string("{{ a.x }}{{ b.x }}")
+        self.assertEqual(template.render(**self.drops), "AB")
+        self.assertEqual(self.service.calls, [])
+
+
+class CompiledPrefetchTestCase(PrefetchTestCase):
+    """Test cases for starting async lookups ahead of the render cursor with
+    compiled templates."""
+
+    template_class = CompiledBoundTemplate
@@ -0,0 +1,148 @@
+"""Template preloading test cases."""
+
+import tempfile
+import unittest
+
+from pathlib import Path
+from unittest import mock
+
+from liquid import Environment
+
+from liquid.exceptions import LiquidSyntaxError
+from liquid.exceptions import PreloadError
+from liquid.exceptions import TemplateNotFound
+
+from liquid.loaders import BaseLoader
+from liquid.loaders import DictLoader
+from liquid.loaders import FileSystemLoader
+from liquid.loaders import TemplateSource
+
+
+class PreloadTestCase(unittest.TestCase):
+    """Template preloading test cases."""
+
+    def setUp(self) -> None:
+        self.templates = {
+            "index.liquid": "{% render 'snippets/product.liquid' %}",
+            "snippets/product.liquid": "{{ product.title | upcase }}",
+            "snippets/price.liquid": "{{ price | times: 100 }}",
+            "README": "{{ not a template",
+        }
+
+    def test_list_templates(self):
+        """Test that file system loaders can list their templates."""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            hidden = {".index.liquid.swp": "", ".git/config": "", "snippets/.keep": ""}
+            for name, source in {**self.templates, **hidden}.items():
+                path = Path(tmpdir, name)
+                path.parent.mkdir(parents=True, exist_ok=True)
+                path.write_text(source)
+
+            loader = FileSystemLoader([tmpdir, Path(tmpdir, "snippets")])
+            self.assertEqual(
+                loader.list_templates(),
+                [
+                    "README",
+                    "index.liquid",
+                    "price.liquid",
+                    "product.liquid",
+                    "snippets/price.liquid",
+                    "snippets/product.liquid",
+                ],
+            )
+
+    def test_preload_templates(self):
+        """Test that we can load templates into the cache in advance."""
+        for workers in (None, 1):
+            with self.subTest(workers=workers):
+                loader = DictLoader(self.templates)
+                env = Environment(loader=loader)
+
+                templates = env.preload("*.liquid", workers=workers)
+                self.assertEqual(len(templates), 3)
+                self.assertEqual(
+                    templates["snippets/product.liquid"].render(
+                        product={"title": "foo"}
+                    ),
+                    "FOO",
+                )
+
+                with mock.patch.object(loader, "get_source") as get_source:
+                    template = env.get_template("snippets/product.liquid")
+
+                get_source.assert_not_called()
+                self.assertIs(template, templates["snippets/product.liquid"])
+
+    def test_pattern(self):
+        """Test that we only preload templates with matching names."""
+        env = Environment(loader=DictLoader(self.templates))
+        templates = env.preload("snippets/*")
+        self.assertEqual(
+            sorted(templates), ["snippets/price.liquid", "snippets/product.liquid"]
+        )
+
+    def test_bulk_errors(self):
+        """Test that we report all errors after loading other templates."""
+        env = Environment(loader=DictLoader(self.templates))
+
+        with self.assertRaises(PreloadError) as raised:
+            env.preload("*")
+
+        errors = raised.exception.errors
+        self.assertEqual(list(errors), ["README"])
+        self.assertIsInstance(errors["README"], LiquidSyntaxError)
+        self.assertEqual(errors["README"].name, "README")
+        self.assertEqual(len(env.cache), 3)
+
+        templates = env.preload("*", raise_for_errors=False)
+        self.assertEqual(len(templates), 3)
+
+    def test_default_pattern(self):
+        """Test that we only preload templates with a `.liquid` suffix by default."""
+        env = Environment(loader=DictLoader(self.templates))
+        templates = env.preload()
+        self.assertEqual(
+            sorted(templates),
+            ["index.liquid", "snippets/price.liquid", "snippets/product.liquid"],
+        )
+
+    def test_read_errors(self):
+        """Test that we report templates that can't be read."""
+
+        class MockLoader(DictLoader):
+            def get_source(self, env, template_name):
+                if template_name == "index.liquid":
+                    raise OSError("no read permission")
+                return super().get_source(env, template_name)
+
+        env = Environment(loader=MockLoader(self.templates))
+        templates = env.preload("*.liquid", raise_for_errors=False)
+        self.assertEqual(len(templates), 2)
+
+        with self.assertRaises(PreloadError) as raised:
+            env.preload("*.liquid")
+        self.assertIsInstance(raised.exception.errors["index.liquid"], TemplateNotFound)
+
+    def test_unpicklable_environment(self):
+        """Test that we parse templates in this process if the environment can't be
+        sent to other processes."""
+        env = Environment(loader=DictLoader(self.templates))
+        env.add_filter("shout", lambda val: f"{val}!")
+
+        templates = env.preload("*.liquid")
+        self.assertEqual(len(templates), 3)
+
+    def test_loader_without_list_templates(self):
+        """Test that preloading requires a loader that can list templates."""
+
+        class MockLoader(BaseLoader):
+            def get_source(self, env, template_name):
+                return TemplateSource("hello", template_name, None)
+
+        env = Environment(loader=MockLoader())
+        with self.assertRaises(NotImplementedError):
+            env.preload()
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,137 @@
+"""Render profiler test cases."""
+
+import asyncio
+import unittest
+
+from io import StringIO
+
+from liquid import Environment
+from liquid.ast import Node
+from liquid.loaders import DictLoader
+from liquid.profiler import Profiler
+from liquid.template import BoundTemplate
+
+
+class ProfilerTestCase(unittest.TestCase):
+    """Test cases for the render profiler."""
+
+    def setUp(self) -> None:
+        self.env = Environment(
+            loader=DictLoader(
+                {
+                    "index": "Hello, {% render 'item' for items as item %}!",
+                    "item": "{{ item | upcase }}\n{% if item %}.{% endif %}",
+                }
+            )
+        )
+        # Compiled templates don't call `Node.render` for built-in tags.
+        self.env.template_class = BoundTemplate
+
+    def test_hooks_are_removed(self):
+        """Test that profiling hooks are installed and removed."""
+        render = Node.__dict__["render"]
+        render_with_context = BoundTemplate.__dict__["render_with_context"]
+
+        profiler = Profiler()
+        with profiler:
+            self.assertTrue(profiler.enabled)
+            self.assertIsNot(Node.__dict__["render"], render)
+
+        self.assertFalse(profiler.enabled)
+        self.assertIs(Node.__dict__["render"], render)
+        self.assertIs(
+            BoundTemplate.__dict__["render_with_context"], render_with_context
+        )
+
+    def test_one_profiler_at_a_time(self):
+        """Test that we can't enable more than one profiler."""
+        with Profiler():
+            with self.assertRaises(RuntimeError):
+                Profiler().enable()
+
+    def test_report(self):
+        """Test that we record nodes, filters, templates and loads."""
+        template = self.env.get_template("index")
+
+        with Profiler() as profiler:
+            result = template.render(items=["a", "b"])
+
+        self.assertEqual(result, "Hello, A\n.B\n.!")
+        stats = {
+            (entry.kind, entry.template, entry.linenum, entry.name): entry
+            for entry in profiler.report()
+        }
+
+        entry = stats[("template", "index", 0, "index")]
+        self.assertEqual(entry.calls, 1)
+        self.assertEqual(entry.size, len(result))
+
+        self.assertEqual(stats[("node", "index", 1, "render")].calls, 1)
+        self.assertEqual(stats[("load", "index", 0, "item")].calls, 1)
+        self.assertEqual(stats[("template", "item", 0, "item")].calls, 2)
+        self.assertEqual(stats[("parse", "item", 0, "parse")].calls, 1)
+        self.assertEqual(stats[("filter", "item", 1, "upcase")].calls, 2)
+        self.assertEqual(stats[("node", "item", 2, "if")].calls, 2)
+        self.assertEqual(stats[("node", "item", 2, "if")].size, 2)
+
+        report = profiler.format_report(limit=3)
+        self.assertEqual(len(report.splitlines()), 4)
+
+    def test_linked_partials(self):
+        """Test that we record a load for every partial template lookup, even when
+        `include` and `render` tags have linked their template."""
+        template = self.env.from_string(
+            "{% for i in (1..5) %}{% include 'item' %}{% render 'item' %}{% endfor %}"
+        )
+        template.render()
+
+        with Profiler() as profiler:
+            template.render()
+            asyncio.run(template.render_async())
+
+        stats = {
+            (entry.kind, entry.name): entry.calls for entry in profiler.report()
+        }
+        self.assertEqual(stats[("template", "item")], 20)
+        self.assertEqual(stats[("load", "item")], 20)
+
+    def test_async_report(self):
+        """Test that we record async renders."""
+        template = self.env.get_template("index")
+
+        with Profiler() as profiler:
+            result = asyncio.run(template.render_async(items=["a", "b"]))
+
+        self.assertEqual(result, "Hello, A\n.B\n.!")
+        stats = {
+            (entry.kind, entry.template, entry.name): entry
+            for entry in profiler.report()
+        }
+        self.assertEqual(stats[("template", "item", "item")].calls, 2)
+        self.assertEqual(stats[("filter", "item", "upcase")].calls, 2)
+
+    def test_stacks(self):
+        """Test that we can export folded stacks."""
+        template = self.env.get_template("index")
+
+        with Profiler() as profiler:
+            template.render(items=["a"])
+
+        stacks = [line.rsplit(" ", 1)[0] for line in profiler.stacks()]
+        self.assertIn("index;render:1;item;output:1;|upcase", stacks)
+        self.assertIn("index;render:1;load:item;parse", stacks)
+
+        buf = StringIO()
+        profiler.write_stacks(buf)
+        self.assertEqual(buf.getvalue().splitlines(), profiler.stacks())
+
+    def test_reset(self):
+        """Test that we can discard recorded statistics."""
+        profiler = Profiler()
+        with profiler:
+            self.env.from_string("{{ 'a' }}").render()
+
+        self.assertTrue(profiler.report())
+        profiler.reset()
+        self.assertEqual(profiler.report(), [])
+        self.assertEqual(profiler.stacks(), [])
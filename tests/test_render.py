@@ -147,6 +147,21 @@ class RenderTestCases(unittest.TestCase):
                     expect="\rWelcome back, Holly!",
                     globals={"customer": {"first_name": "Holly"}},
                 ),
+                Case(
+                    description="trailing newline after right stripped output",
+                    template="{{ 1 -}}\n b\n",
+                    expect="1b\n",
+                ),
+                Case(
+                    description="trailing whitespace after right stripped tag",
+                    template="{%- if true -%}a{%- endif -%}\n b \n",
+                    expect="ab \n",
+                ),
+                Case(
+                    description="trailing newline without whitespace control",
+                    template="{{ 1 }}\n b\n",
+                    expect="1\n b\n",
+                ),
             ]
         )
 
@@ -1730,3 +1745,53 @@ class RenderTestCases(unittest.TestCase):
         ]
 
         self._test(test_cases)
+
+    def test_cache_tag(self):
+        """Test that we can render `cache` tags."""
+
+        test_cases = [
+            Case(
+                description="literal and global variable",
+                template=(
+                    r"{% cache 'greeting' %}"
+                    r"Hello, {{ customer.first_name }}."
+                    r"{% endcache %}"
+                ),
+                expect="Hello, Holly.",
+                globals={"customer": {"first_name": "Holly"}},
+            ),
+            Case(
+                description="same key in a loop",
+                template=(
+                    r"{% for i in (1..3) %}"
+                    r"{% cache 'item' %}{{ i }}{% endcache %}"
+                    r"{% endfor %}"
+                ),
+                expect="111",
+            ),
+            Case(
+                description="variable key in a loop",
+                template=(
+                    r"{% for i in (1..3) %}"
+                    r"{% cache 'item', i %}{{ i }}{% endcache %}"
+                    r"{% endfor %}"
+                ),
+                expect="123",
+            ),
+            Case(
+                description="different blocks with the same key",
+                template=(
+                    r"{% cache 'item' %}a{% endcache %}"
+                    r"{% cache 'item' %}b{% endcache %}"
+                ),
+                expect="ab",
+            ),
+            Case(
+                description="ttl",
+                template=r"{% cache 'item', ttl: 60 %}a{% endcache %}",
+                expect="a",
+            ),
+        ]
+
+        self._test(test_cases)
+
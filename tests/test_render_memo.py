@@ -0,0 +1,161 @@
+"""Render tag memoization test cases."""
+
+import asyncio
+import unittest
+
+from typing import Dict
+
+from liquid import Environment
+from liquid.filter import pure
+from liquid.loaders import DictLoader
+
+
+class RenderMemoTestCase(unittest.TestCase):
+    """Test cases for memoizing output from the `render` tag."""
+
+    def setUp(self) -> None:
+        self.calls: Dict[str, int] = {}
+
+        def count(val: object) -> object:
+            self.calls[str(val)] = self.calls.get(str(val), 0) + 1
+            return val
+
+        def impure(val: object) -> object:
+            return val
+
+        self.templates = {
+            "product": "{{ product.title | count }}",
+            "price": "{{ price | count }}",
+            "cycle": "{{ x | count }}{% cycle 'a', 'b' %}",
+            "impure": "{{ x | count | impure }}",
+            "outer": "{{ x | count }}{% render 'inner' %}",
+            "inner": "({{ x }})",
+            "parent": "{% render 'impure', x: x %}",
+            "index": "[{{ f.index | count }}]",
+            "loop": "{% render 'index', f: f %}",
+        }
+
+        self.env = Environment(
+            loader=DictLoader(self.templates),
+            memoize_render=True,
+        )
+        self.env.add_filter("count", pure(count))
+        self.env.add_filter("impure", impure)
+
+    def test_disabled_by_default(self):
+        """Test that render tag output is not memoized by default."""
+        env = Environment(loader=DictLoader(self.templates))
+        env.add_filter("count", self.env.filters["count"])
+        template = env.from_string(
+            "{% render 'price', price: 1 %}{% render 'price', price: 1 %}"
+        )
+        self.assertEqual(template.render(), "11")
+        self.assertEqual(self.calls, {"1": 2})
+
+    def test_same_arguments(self):
+        """Test that partials rendered with the same arguments are rendered once."""
+        template = self.env.from_string(
+            "{% for i in (1..3) %}"
+            "{% render 'price', price: 2 %}"
+            "{% render 'product' with product %}"
+            "{% endfor %}"
+        )
+        self.assertEqual(template.render(product={"title": "A"}), "2A2A2A")
+        self.assertEqual(self.calls, {"2": 1, "A": 1})
+
+    def test_different_arguments(self):
+        """Test that partials rendered with different arguments are not reused."""
+        template = self.env.from_string(
+            "{% for p in products %}{% render 'product', product: p %}{% endfor %}"
+            "{% render 'price', price: 1 %}{% render 'price', price: 1.0 %}"
+            "{% render 'price', price: true %}"
+        )
+        products = [{"title": "A"}, {"title": "B"}, {"title": "A"}]
+        self.assertEqual(template.render(products=products), "ABA11.0true")
+        self.assertEqual(self.calls, {"A": 2, "B": 1, "1": 1, "1.0": 1, "True": 1})
+
+    def test_memo_per_render(self):
+        """Test that memoized output does not outlive a call to `render`."""
+        template = self.env.from_string("{% render 'product', product: p %}")
+        self.assertEqual(template.render(p={"title": "A"}), "A")
+        self.assertEqual(template.render(p={"title": "B"}), "B")
+        self.assertEqual(self.calls, {"A": 1, "B": 1})
+
+    def test_for_loop(self):
+        """Test that we can memoize a partial rendered for each item in an array."""
+        template = self.env.from_string(
+            "{% render 'product' for products %}|{% render 'product' for products %}"
+        )
+        products = [{"title": "A"}, {"title": "B"}]
+        self.assertEqual(template.render(products=products), "AB|AB")
+        self.assertEqual(self.calls, {"A": 1, "B": 1})
+
+    def test_stateful_tags(self):
+        """Test that partials using stateful tags are not memoized."""
+        template = self.env.from_string(
+            "{% render 'cycle', x: 1 %}{% render 'cycle', x: 1 %}"
+        )
+        self.assertEqual(template.render(), "1a1a")
+        self.assertEqual(self.calls, {"1": 2})
+
+    def test_impure_filters(self):
+        """Test that partials using filters that are not pure are not memoized."""
+        template = self.env.from_string(
+            "{% render 'impure', x: 1 %}{% render 'impure', x: 1 %}"
+        )
+        self.assertEqual(template.render(), "11")
+        self.assertEqual(self.calls, {"1": 2})
+
+    def test_nested_impure_partial(self):
+        """Test that a partial is not memoized if it renders a partial that can't be
+        memoized."""
+        template = self.env.from_string(
+            "{% render 'parent', x: 1 %}{% render 'parent', x: 1 %}"
+        )
+        self.assertEqual(template.render(), "11")
+        self.assertEqual(self.calls, {"1": 2})
+
+    def test_nested_partial_sees_parent_arguments(self):
+        """Test that nested partials are not shared between different parents."""
+        template = self.env.from_string(
+            "{% render 'outer', x: 1 %}{% render 'outer', x: 2 %}"
+            "{% render 'outer', x: 1 %}"
+        )
+        self.assertEqual(template.render(), "1(1)2(2)1(1)")
+        self.assertEqual(self.calls, {"1": 1, "2": 1})
+
+    def test_stateful_drops(self):
+        """Test that partials rendered with a drop that changes between renders are
+        not memoized."""
+        tests = [
+            "{% for i in (1..3) %}{% render 'index', f: forloop %}{% endfor %}",
+            "{% tablerow i in (1..3) %}{% render 'index', f: tablerowloop %}"
+            "{% endtablerow %}",
+        ]
+        for source in tests:
+            with self.subTest(source=source):
+                self.calls.clear()
+                output = self.env.from_string(source).render()
+                self.assertEqual(
+                    [output.count(f"[{i}]") for i in (1, 2, 3)], [1, 1, 1]
+                )
+                self.assertEqual(self.calls, {"1": 1, "2": 1, "3": 1})
+
+    def test_nested_stateful_drop(self):
+        """Test that a partial is not memoized if it renders a partial with a drop
+        that changes between renders."""
+        template = self.env.from_string(
+            "{% for i in (1..2) %}{% render 'loop', f: forloop %}{% endfor %}"
+        )
+        self.assertEqual(template.render(), "[1][2]")
+        self.assertEqual(asyncio.run(template.render_async()), "[1][2]")
+
+    def test_render_async(self):
+        """Test that we can memoize render tag output when rendering
+        asynchronously."""
+        template = self.env.from_string(
+            "{% render 'price', price: 3 %}{% render 'price', price: 3 %}"
+            "{% render 'impure', x: 4 %}{% render 'impure', x: 4 %}"
+        )
+        self.assertEqual(asyncio.run(template.render_async()), "3344")
+        self.assertEqual(self.calls, {"3": 1, "4": 2})
@@ -0,0 +1,113 @@
+"""Streaming render test cases."""
+
+import asyncio
+import unittest
+
+from liquid import Environment
+from liquid import Mode
+
+from liquid.compiler import CompiledBoundTemplate
+from liquid.exceptions import LiquidSyntaxError
+from liquid.loaders import DictLoader
+from liquid.template import BoundTemplate
+
+
+class StreamingRenderTestCase(unittest.TestCase):
+    """Streaming render test cases."""
+
+    template_class = BoundTemplate
+
+    def setUp(self) -> None:
+        self.env = Environment(
+            loader=DictLoader({"item": "<li>{{ item }}</li>"}),
+        )
+        self.env.template_class = self.template_class
+
+        self.source = (
+            "<ul>"
+            "{% for item in items %}"
+            "{% render 'item', item: item %}"
+            "{% endfor %}"
+            "</ul>"
+            "{% assign x = items | size %}"
+            "{{ x }}"
+            "{% for item in items reversed %}{{ item }}{% endfor %}"
+        )
+        self.items = [f"item{i}" for i in range(50)]
+
+    def _stream(self, template, **kwargs):
+        return list(template.render_stream(**kwargs))
+
+    def _stream_async(self, template, **kwargs):
+        async def coro():
+            return [chunk async for chunk in template.render_stream_async(**kwargs)]
+
+        return asyncio.run(coro())
+
+    def test_stream_same_as_render(self):
+        """Test that streamed chunks join to the same output as `render`."""
+        template = self.env.from_string(self.source)
+        expect = template.render(items=self.items)
+
+        for stream in (self._stream, self._stream_async):
+            with self.subTest(stream=stream.__name__):
+                chunks = stream(template, items=self.items)
+                self.assertEqual(len(chunks), 1)
+                self.assertEqual("".join(chunks), expect)
+
+    def test_stream_chunks(self):
+        """Test that we yield chunks at statement boundaries once the buffer is full."""
+        template = self.env.from_string(self.source)
+        template.stream_buffer_size = 5
+        expect = template.render(items=self.items)
+
+        for stream in (self._stream, self._stream_async):
+            with self.subTest(stream=stream.__name__):
+                chunks = stream(template, items=self.items)
+                self.assertEqual("".join(chunks), expect)
+                self.assertEqual(
+                    chunks[:3],
+                    [
+                        "<ul>" + "".join(f"<li>{i}</li>" for i in self.items),
+                        "</ul>",
+                        "50" + "".join(reversed(self.items)),
+                    ],
+                )
+
+    def test_stream_empty_template(self):
+        """Test that an empty template yields nothing."""
+        template = self.env.from_string("")
+        self.assertEqual(self._stream(template), [])
+        self.assertEqual(self._stream_async(template), [])
+
+    def test_stream_error(self):
+        """Test that errors propagate from streaming renders."""
+        template = self.env.from_string("hello {% break %} world")
+
+        with self.assertRaises(LiquidSyntaxError):
+            self._stream(template)
+
+        with self.assertRaises(LiquidSyntaxError):
+            self._stream_async(template)
+
+        self.env.mode = Mode.LAX
+        self.assertEqual("".join(self._stream(template)), "hello  world")
+
+    def test_close_stream(self):
+        """Test that we can stop consuming a stream early."""
+        template = self.env.from_string("{{ a }}{{ b }}")
+        template.stream_buffer_size = 1
+
+        stream = template.render_stream(a="foo", b="bar")
+        self.assertEqual(next(stream), "foo")
+        stream.close()
+
+
+class CompiledStreamingRenderTestCase(StreamingRenderTestCase):
+    """Streaming render test cases using compiled templates."""
+
+    template_class = CompiledBoundTemplate
+
+
+if __name__ == "__main__":
+    unittest.main()
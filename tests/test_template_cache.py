@@ -1,5 +1,11 @@
+import pickle
+import time
 import unittest
 
+from liquid import Environment
+from liquid.loaders import DictLoader
+from liquid.template import BoundTemplate
+from liquid.utils import CacheInfo
 from liquid.utils import LRUCache
 
 
@@ -80,3 +86,103 @@ class TemplateCacheTestCase(unittest.TestCase):
         self.cache["e"] = 5
         self.assertEqual("some" in self.cache, True)
         self.assertEqual("a" in self.cache, False)
+
+    def test_cache_info(self):
+        """Test that we count hits, misses and evictions."""
+        self.cache.get("foo")
+        self.cache.get("foo")
+        self.cache.get("nosuchthing")
+
+        for i in range(5):
+            self.cache[i] = i
+
+        self.assertEqual(
+            self.cache.cache_info(),
+            CacheInfo(hits=2, misses=1, evictions=2, expired=0, size=5, weight=5),
+        )
+
+    def test_large_capacity(self):
+        """Test that a large cache keeps the most recently used items."""
+        cache = LRUCache(capacity=10000)
+        for i in range(20000):
+            cache[i] = i
+            cache.get(0)
+
+        self.assertEqual(len(cache), 10000)
+        self.assertIn(0, cache)
+        self.assertNotIn(1, cache)
+        self.assertEqual(cache.keys()[:2], [0, 19999])
+
+    def test_max_weight(self):
+        """Test that we can limit a cache by the total weight of its values."""
+        cache = LRUCache(capacity=None, max_weight=10, weigh=len)
+        cache["a"] = "aaaa"
+        cache["b"] = "bbbb"
+        cache["c"] = "cc"
+        self.assertEqual(len(cache), 3)
+
+        cache["d"] = "ddd"
+        self.assertEqual(cache.keys(), ["d", "c", "b"])
+        self.assertEqual(cache.cache_info().weight, 9)
+
+        # Replacing a value updates its weight.
+        cache["b"] = "b"
+        self.assertEqual(cache.cache_info().weight, 6)
+
+        del cache["d"]
+        self.assertEqual(cache.cache_info().weight, 3)
+
+        # An item heavier than the limit is kept until something else is set.
+        cache["e"] = "e" * 20
+        self.assertEqual(cache.keys(), ["e"])
+
+    def test_pop_if(self):
+        """Test that we can remove an item only if it has not been replaced."""
+        cache = LRUCache(capacity=5)
+        first = ["a"]
+        cache["foo"] = first
+        cache["foo"] = ["b"]
+        self.assertFalse(cache.pop_if("foo", first))
+        self.assertEqual(cache["foo"], ["b"])
+
+        self.assertTrue(cache.pop_if("foo", cache.peek("foo")))
+        self.assertNotIn("foo", cache)
+        self.assertFalse(cache.pop_if("foo", None))
+
+    def test_ttl(self):
+        """Test that cached items can expire."""
+        cache = LRUCache(capacity=5, ttl=60)
+        cache["foo"] = "bar"
+        self.assertEqual(cache["foo"], "bar")
+
+        cache._expires["foo"] = time.monotonic() - 1  # pylint: disable=protected-access
+        self.assertEqual(cache.items(), [])
+        self.assertIsNone(cache.get("foo"))
+        self.assertNotIn("foo", cache)
+        self.assertEqual(cache.cache_info().expired, 1)
+
+    def test_pickle(self):
+        """Test that we can pickle a cache."""
+        self.cache.get("foo")
+        cache = pickle.loads(pickle.dumps(self.cache))
+        self.assertEqual(cache.items(), self.cache.items())
+        self.assertEqual(cache.cache_info(), self.cache.cache_info())
+        cache["hello"] = "there"
+        self.assertEqual(len(cache), 3)
+
+    def test_environment_cache(self):
+        """Test that we can give an environment a template cache."""
+        cache = LRUCache(
+            capacity=None, max_weight=100000, weigh=BoundTemplate.estimate_size
+        )
+        env = Environment(
+            loader=DictLoader({"a": "{% for x in y %}{{ x }}{% endfor %}"}),
+            cache=cache,
+        )
+        self.assertIs(env.cache, cache)
+
+        template = env.get_template("a")
+        self.assertIs(env.get_template("a"), template)
+        self.assertGreater(template.estimate_size(), 0)
+        self.assertEqual(cache.cache_info().weight, template.estimate_size())
+        self.assertEqual(cache.cache_info().hits, 1)
@@ -0,0 +1,109 @@
+"""Multi-threaded rendering test cases."""
+
+import asyncio
+import unittest
+
+from concurrent.futures import ThreadPoolExecutor
+
+from liquid import Environment
+from liquid.compiler import CompiledBoundTemplate
+from liquid.loaders import DictLoader
+from liquid.template import BoundTemplate
+
+THREADS = 8
+
+
+class ThreadSafetyTestCase(unittest.TestCase):
+    """Test cases for sharing an environment and its templates between threads."""
+
+    template_class = BoundTemplate
+
+    def setUp(self) -> None:
+        self.env = Environment(
+            loader=DictLoader(
+                {
+                    "page": (
+                        "{% for item in items %}"
+                        "{% render 'item', item: item, site: site %}"
+                        "{% cycle 'a', 'b' %}"
+                        "{% endfor %}"
+                        "{% capture total %}{{ items | size }}{% endcapture %}"
+                        "{% increment n %}{{ total }}"
+                    ),
+                    "item": "{{ site }}:{{ item | upcase }},",
+                }
+            )
+        )
+        self.env.template_class = self.template_class
+
+    def _expect(self, thread: int) -> str:
+        items = [f"t{thread}i{i}" for i in range(20)]
+        body = "".join(
+            f"s{thread}:{item.upper()},{'ab'[i % 2]}" for i, item in enumerate(items)
+        )
+        return f"{body}020"
+
+    def _render(self, thread: int) -> str:
+        template = self.env.get_template("page", globals={"site": f"s{thread}"})
+        return template.render(items=[f"t{thread}i{i}" for i in range(20)])
+
+    def test_render_from_many_threads(self):
+        """Test that threads rendering the same template don't see each other's
+        render context, globals or tag state."""
+        with ThreadPoolExecutor(max_workers=THREADS) as executor:
+            results = list(executor.map(self._render, list(range(THREADS * 10))))
+
+        for thread, result in enumerate(results):
+            self.assertEqual(result, self._expect(thread))
+
+    def test_render_async_from_many_threads(self):
+        """Test that threads can run their own event loops to render the same
+        template."""
+
+        def _render_async(thread: int) -> str:
+            async def coro() -> str:
+                template = await self.env.get_template_async(
+                    "page", globals={"site": f"s{thread}"}
+                )
+                return await template.render_async(
+                    items=[f"t{thread}i{i}" for i in range(20)]
+                )
+
+            return asyncio.run(coro())
+
+        with ThreadPoolExecutor(max_workers=THREADS) as executor:
+            results = list(executor.map(_render_async, list(range(THREADS * 2))))
+
+        for thread, result in enumerate(results):
+            self.assertEqual(result, self._expect(thread))
+
+    def test_cached_template_globals(self):
+        """Test that globals passed to `get_template` don't change the cached
+        template."""
+        first = self.env.get_template("page", globals={"site": "a"})
+        second = self.env.get_template("page", globals={"site": "b"})
+        cached = self.env.get_template("page")
+
+        self.assertEqual(first.globals["site"], "a")
+        self.assertEqual(second.globals["site"], "b")
+        self.assertNotIn("site", cached.globals)
+        self.assertIs(first.tree, cached.tree)
+        self.assertIs(second.tree, cached.tree)
+
+        cached_async = asyncio.run(self.env.get_template_async("page"))
+        first_async = asyncio.run(
+            self.env.get_template_async("page", globals={"site": "c"})
+        )
+        self.assertIs(cached_async, cached)
+        self.assertEqual(first_async.globals["site"], "c")
+        self.assertNotIn("site", cached.globals)
+
+
+class CompiledThreadSafetyTestCase(ThreadSafetyTestCase):
+    """Test cases for sharing compiled templates between threads."""
+
+    template_class = CompiledBoundTemplate
+
+
+if __name__ == "__main__":
+    unittest.main()
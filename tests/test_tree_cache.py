@@ -0,0 +1,153 @@
+"""Persistent parse tree cache test cases."""
+
+import tempfile
+import unittest
+
+from pathlib import Path
+from unittest import mock
+
+from liquid import Environment
+from liquid import Mode
+
+from liquid.filter import pure
+from liquid.loaders import DictLoader
+from liquid.tree_cache import DictTreeCache
+from liquid.tree_cache import FileSystemTreeCache
+
+from tests.mocks.tags.form_tag import CommentFormTag
+
+
+class TreeCacheTestCase(unittest.TestCase):
+    """Persistent parse tree cache test cases."""
+
+    def setUp(self) -> None:
+        self.templates = {
+            "index": "{% for x in y %}{{ x | upcase }}{% endfor %}{% render 'foo' %}",
+            "foo": "Hello, {{ you | default: 'World' }}!",
+        }
+
+    def _env(self, tree_cache, **kwargs):
+        return Environment(
+            loader=DictLoader(self.templates), tree_cache=tree_cache, **kwargs
+        )
+
+    def test_load_from_cache(self):
+        """Test that other environments load templates from the cache."""
+        tree_cache = DictTreeCache()
+        env = self._env(tree_cache)
+        expect = env.get_template("index").render(y=["a", "b"])
+
+        self.assertEqual(len(tree_cache.data), 2)
+
+        other = self._env(tree_cache)
+        with mock.patch("liquid.environment.get_parser") as get_parser:
+            result = other.get_template("index").render(y=["a", "b"])
+
+        get_parser.assert_not_called()
+        self.assertEqual(result, expect)
+        self.assertEqual(result, "ABHello, World!")
+
+    def test_file_system_cache(self):
+        """Test that we can store and load parse trees on the file system."""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            tree_cache = FileSystemTreeCache(tmpdir)
+            env = self._env(tree_cache)
+            env.get_template("foo")
+
+            self.assertEqual(len(list(Path(tmpdir).glob("__liquid_*.cache"))), 1)
+
+            other = self._env(FileSystemTreeCache(tmpdir))
+            with mock.patch("liquid.environment.get_parser") as get_parser:
+                result = other.get_template("foo").render(you="there")
+
+            get_parser.assert_not_called()
+            self.assertEqual(result, "Hello, there!")
+
+            tree_cache.clear()
+            self.assertEqual(len(list(Path(tmpdir).glob("*"))), 0)
+
+    def test_environment_fingerprint(self):
+        """Test that differently configured environments don't share parse trees."""
+        tree_cache = DictTreeCache()
+        source = self.templates["foo"]
+
+        keys = {
+            tree_cache.key(self._env(tree_cache), source),
+            tree_cache.key(self._env(tree_cache, tolerance=Mode.LAX), source),
+            tree_cache.key(
+                self._env(
+                    tree_cache,
+                    statement_start_string="[[",
+                    statement_end_string="]]",
+                ),
+                source,
+            ),
+        }
+
+        env = self._env(tree_cache)
+        env.add_tag(CommentFormTag)
+        keys.add(tree_cache.key(env, source))
+
+        self.assertEqual(len(keys), 4)
+        self.assertEqual(
+            tree_cache.key(self._env(tree_cache), source),
+            tree_cache.key(self._env(DictTreeCache()), source),
+        )
+
+    def test_filter_fingerprint(self):
+        """Test that optimized parse trees are not shared with environments that have
+        different filters registered."""
+        tree_cache = DictTreeCache()
+        source = "{{ 'hello' | upcase }}"
+
+        env = self._env(tree_cache, optimize=True)
+        self.assertEqual(env.from_string(source).render(), "HELLO")
+        self.assertEqual(len(tree_cache.data), 1)
+
+        @pure
+        def upcase(val):
+            return f"<{val}>"
+
+        env.add_filter("upcase", upcase)
+        self.assertEqual(env.from_string(source).render(), "<hello>")
+        self.assertEqual(len(tree_cache.data), 2)
+
+        other = self._env(tree_cache, optimize=True)
+        self.assertEqual(other.from_string(source).render(), "HELLO")
+        self.assertEqual(len(tree_cache.data), 2)
+
+        # Without optimization, filters are not evaluated at parse time.
+        unoptimized = self._env(tree_cache)
+        key = tree_cache.key(unoptimized, source)
+        unoptimized.add_filter("upcase", upcase)
+        self.assertEqual(tree_cache.key(unoptimized, source), key)
+
+    def test_corrupt_cache_data(self):
+        """Test that we parse templates again if cached data is corrupt."""
+        tree_cache = DictTreeCache()
+        env = self._env(tree_cache)
+        source = self.templates["foo"]
+
+        tree_cache.set(tree_cache.key(env, source), b"not a pickle")
+        template = env.from_string(source)
+
+        self.assertEqual(template.render(), "Hello, World!")
+        self.assertNotEqual(
+            tree_cache.get(tree_cache.key(env, source)), b"not a pickle"
+        )
+
+    def test_unpicklable_tree(self):
+        """Test that parse trees that can't be pickled are not cached."""
+        tree_cache = DictTreeCache()
+        env = self._env(tree_cache)
+        source = self.templates["foo"]
+
+        with mock.patch("pickle.dumps", side_effect=TypeError("can't pickle")):
+            template = env.from_string(source)
+
+        self.assertEqual(template.render(), "Hello, World!")
+        self.assertEqual(len(tree_cache.data), 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -8,6 +8,7 @@ from liquid import Undefined
 from liquid import DebugUndefined
 from liquid import StrictUndefined
 
+from liquid.context import Context
 from liquid.template import BoundTemplate
 
 from liquid.exceptions import UndefinedError
@@ -268,6 +269,29 @@ class TestUndefined(TestCase):
                 with self.assertRaises(NoSuchFilterFunc) as raised:
                     asyncio.run(coro(template))
 
+    def test_shared_default_undefined(self):
+        """Test that instances of the default undefined type are shared."""
+        env = Environment()
+        template = env.from_string(r"{{ nosuchthing }}")
+        context = Context(env)
+
+        self.assertIs(context.resolve("nosuchthing"), context.resolve("nosuchthing"))
+        self.assertIs(
+            context.get(["nosuchthing", "foo"]), context.undefined("nosuchthing")
+        )
+        self.assertEqual(context.resolve("nosuchthing").name, "nosuchthing")
+        self.assertEqual(template.render(), "")
+
+    def test_custom_undefined_not_shared(self):
+        """Test that instances of other undefined types are not shared."""
+        for undefined in (DebugUndefined, StrictUndefined):
+            with self.subTest(undefined=undefined.__name__):
+                context = Context(Environment(undefined=undefined))
+                self.assertIsInstance(context.resolve("nosuchthing"), undefined)
+                self.assertIsNot(
+                    context.resolve("nosuchthing"), context.resolve("nosuchthing")
+                )
+
     def test_default_undefined_magic(self):
         """Test the default undefined type magic methods."""
         undefined = Undefined("test")